@@ -0,0 +1,1239 @@
+#include "asset_loader.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <span>
+#include <string_view>
+#include <tuple>
+
+namespace
+{
+    // Of the encoder, hashed with the images so that the cached textures are compressed again when it changes
+    constexpr uint32_t kTextureVersion = 1;
+
+    // Slots of lib/material.glsl
+    constexpr uint32_t kMetallicRoughnessSlot = 1;
+    constexpr uint32_t kNormalSlot            = 2;
+    constexpr uint32_t kOcclusionSlot         = 3;
+
+    // EXT_texture_compression_s3tc and its sRGB variants of EXT_texture_sRGB, which the GL loader may not define
+    constexpr GLenum kCompressedRGBDXT1       = 0x83F0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    constexpr GLenum kCompressedRGBADXT5      = 0x83F3; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+    constexpr GLenum kCompressedSRGBDXT1      = 0x8C4C; // GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+    constexpr GLenum kCompressedSRGBAlphaDXT5 = 0x8C4F; // GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+
+    // What the shaders assume of a slot without a texture (lib/material.glsl order): a grey base color, roughness 0.5
+    // without metal, the normal of the geometry, no occlusion and no emission
+    constexpr std::array<std::array<uint8_t, 4>, kNumMaterialTextures> kNeutralTexels {{
+        {128, 128, 128, 255},
+        {0, 128, 0, 255},
+        {128, 128, 255, 255},
+        {255, 255, 255, 255},
+        {0, 0, 0, 255},
+    }};
+
+    double getMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    uint32_t crc32(std::span<const uint8_t> bytes)
+    {
+        uint32_t crc = 0xFFFFFFFF;
+        for (const auto byte : bytes)
+        {
+            crc ^= byte;
+            for (uint32_t bit = 0; bit < 8; ++bit)
+                crc = crc & 1 ? crc >> 1 ^ 0xEDB88320 : crc >> 1;
+        }
+        return ~crc;
+    }
+
+    // Grey RGBA PNG, its image data is a zlib stream of stored (uncompressed) deflate blocks
+    std::vector<uint8_t> encodePlaceholderPNG(uint32_t width, uint32_t height)
+    {
+        std::vector<uint8_t> png {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+        const auto pushBigEndian = [](std::vector<uint8_t>& bytes, uint32_t value) {
+            for (int shift = 24; shift >= 0; shift -= 8)
+                bytes.push_back(static_cast<uint8_t>(value >> shift));
+        };
+        const auto pushChunk = [&](const char* type, std::span<const uint8_t> data) {
+            pushBigEndian(png, static_cast<uint32_t>(data.size()));
+            const auto typeOffset = png.size();
+            png.insert(png.end(), type, type + 4);
+            png.insert(png.end(), data.begin(), data.end());
+            pushBigEndian(png, crc32({png.data() + typeOffset, png.size() - typeOffset}));
+        };
+
+        // Width, height, 8 bits per channel, RGBA, no interlacing
+        std::vector<uint8_t> header;
+        pushBigEndian(header, width);
+        pushBigEndian(header, height);
+        header.insert(header.end(), {8, 6, 0, 0, 0});
+        pushChunk("IHDR", header);
+
+        // Every row is its filter type, then its texels
+        std::vector<uint8_t> rows;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            rows.push_back(0);
+            for (uint32_t x = 0; x < width; ++x)
+                rows.insert(rows.end(), {128, 128, 128, 255});
+        }
+
+        uint32_t a = 1, b = 0;
+        for (const auto byte : rows)
+        {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+
+        // zlib header, then the rows in stored blocks (final flag, length and its complement), then their Adler-32
+        std::vector<uint8_t> imageData {0x78, 0x01};
+        for (size_t offset = 0; offset < rows.size(); offset += 65535)
+        {
+            const auto size = static_cast<uint16_t>(std::min<size_t>(rows.size() - offset, 65535));
+            imageData.insert(imageData.end(),
+                             {static_cast<uint8_t>(offset + size == rows.size()),
+                              static_cast<uint8_t>(size),
+                              static_cast<uint8_t>(size >> 8),
+                              static_cast<uint8_t>(~size),
+                              static_cast<uint8_t>(~size >> 8)});
+            imageData.insert(imageData.end(), rows.begin() + offset, rows.begin() + offset + size);
+        }
+        pushBigEndian(imageData, b << 16 | a);
+        pushChunk("IDAT", imageData);
+
+        pushChunk("IEND", {});
+        return png;
+    }
+
+    // -1 when the character is not a hexadecimal digit
+    int getHexDigit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    // A '%' not followed by two hexadecimal digits is kept as is
+    std::string decodePercentEncoding(const std::string& uri)
+    {
+        std::string decoded;
+        for (size_t i = 0; i < uri.size(); ++i)
+        {
+            const auto high = uri[i] == '%' && i + 2 < uri.size() ? getHexDigit(uri[i + 1]) : -1;
+            const auto low  = high >= 0 ? getHexDigit(uri[i + 2]) : -1;
+            if (low >= 0)
+            {
+                decoded += static_cast<char>(high << 4 | low);
+                i += 2;
+            }
+            else
+            {
+                decoded += uri[i];
+            }
+        }
+        return decoded;
+    }
+
+    // Enough of JSON to read the arrays of a glTF, a string keeps where its token is in the text
+    struct JsonValue
+    {
+        enum class Type
+        {
+            eNull,
+            eBool,
+            eNumber,
+            eString,
+            eArray,
+            eObject,
+        };
+
+        Type                                           type {Type::eNull};
+        double                                         number {0.0};
+        std::string                                    string; // Unescaped
+        size_t                                         begin {0};
+        size_t                                         end {0}; // Of the token, quotes included
+        std::vector<JsonValue>                         elements;
+        std::vector<std::pair<std::string, JsonValue>> members;
+
+        const JsonValue* find(std::string_view key, Type memberType) const
+        {
+            for (const auto& [name, value] : members)
+            {
+                if (name == key)
+                    return value.type == memberType ? &value : nullptr;
+            }
+            return nullptr;
+        }
+
+        // An array member, empty when missing
+        std::span<const JsonValue> getArray(std::string_view key) const
+        {
+            const auto* array = find(key, Type::eArray);
+            return array ? std::span<const JsonValue> {array->elements} : std::span<const JsonValue> {};
+        }
+
+        // A glTF index member
+        std::optional<uint32_t> getIndex(std::string_view key) const
+        {
+            const auto* index = find(key, Type::eNumber);
+            if (!index || index->number < 0.0 || index->number != std::floor(index->number))
+                return std::nullopt;
+            return static_cast<uint32_t>(index->number);
+        }
+    };
+
+    class JsonParser
+    {
+    public:
+        explicit JsonParser(std::string_view text) : m_Text(text) {}
+
+        // std::nullopt when the text is not a JSON value
+        std::optional<JsonValue> parse()
+        {
+            JsonValue value;
+            if (!parseValue(value, 0))
+                return std::nullopt;
+
+            skipWhitespace();
+            if (m_Position != m_Text.size())
+                return std::nullopt;
+            return value;
+        }
+
+    private:
+        static constexpr uint32_t kMaxDepth = 128;
+
+        void skipWhitespace()
+        {
+            while (m_Position < m_Text.size() &&
+                   (m_Text[m_Position] == ' ' || m_Text[m_Position] == '\t' || m_Text[m_Position] == '\n' ||
+                    m_Text[m_Position] == '\r'))
+                ++m_Position;
+        }
+
+        bool consume(char c)
+        {
+            skipWhitespace();
+            if (m_Position == m_Text.size() || m_Text[m_Position] != c)
+                return false;
+            ++m_Position;
+            return true;
+        }
+
+        bool consume(std::string_view literal)
+        {
+            if (m_Text.substr(m_Position, literal.size()) != literal)
+                return false;
+            m_Position += literal.size();
+            return true;
+        }
+
+        // The 4 hexadecimal digits of a \u escape
+        std::optional<uint32_t> parseCodeUnit()
+        {
+            if (m_Position + 4 > m_Text.size())
+                return std::nullopt;
+
+            uint32_t codeUnit = 0;
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const auto digit = getHexDigit(m_Text[m_Position++]);
+                if (digit < 0)
+                    return std::nullopt;
+                codeUnit = codeUnit << 4 | static_cast<uint32_t>(digit);
+            }
+            return codeUnit;
+        }
+
+        bool parseString(std::string& string)
+        {
+            if (!consume('"'))
+                return false;
+
+            while (m_Position < m_Text.size() && m_Text[m_Position] != '"')
+            {
+                const auto c = m_Text[m_Position++];
+                if (c != '\\')
+                {
+                    string += c;
+                    continue;
+                }
+                if (m_Position == m_Text.size())
+                    return false;
+
+                switch (const auto escaped = m_Text[m_Position++]; escaped)
+                {
+                    case '"':
+                    case '\\':
+                    case '/':
+                        string += escaped;
+                        break;
+                    case 'b':
+                        string += '\b';
+                        break;
+                    case 'f':
+                        string += '\f';
+                        break;
+                    case 'n':
+                        string += '\n';
+                        break;
+                    case 'r':
+                        string += '\r';
+                        break;
+                    case 't':
+                        string += '\t';
+                        break;
+                    case 'u': {
+                        auto codePoint = parseCodeUnit();
+                        if (codePoint && *codePoint >= 0xD800 && *codePoint < 0xDC00 && consume("\\u"))
+                        {
+                            const auto low = parseCodeUnit();
+                            if (!low || *low < 0xDC00 || *low >= 0xE000)
+                                return false;
+                            codePoint = 0x10000 + ((*codePoint - 0xD800) << 10 | (*low - 0xDC00));
+                        }
+                        if (!codePoint)
+                            return false;
+
+                        // UTF-8
+                        if (*codePoint < 0x80)
+                        {
+                            string += static_cast<char>(*codePoint);
+                        }
+                        else if (*codePoint < 0x800)
+                        {
+                            string += static_cast<char>(0xC0 | *codePoint >> 6);
+                            string += static_cast<char>(0x80 | (*codePoint & 0x3F));
+                        }
+                        else if (*codePoint < 0x10000)
+                        {
+                            string += static_cast<char>(0xE0 | *codePoint >> 12);
+                            string += static_cast<char>(0x80 | (*codePoint >> 6 & 0x3F));
+                            string += static_cast<char>(0x80 | (*codePoint & 0x3F));
+                        }
+                        else
+                        {
+                            string += static_cast<char>(0xF0 | *codePoint >> 18);
+                            string += static_cast<char>(0x80 | (*codePoint >> 12 & 0x3F));
+                            string += static_cast<char>(0x80 | (*codePoint >> 6 & 0x3F));
+                            string += static_cast<char>(0x80 | (*codePoint & 0x3F));
+                        }
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+            }
+            return consume('"');
+        }
+
+        bool parseValue(JsonValue& value, uint32_t depth)
+        {
+            if (depth > kMaxDepth)
+                return false;
+
+            skipWhitespace();
+            if (m_Position == m_Text.size())
+                return false;
+
+            value.begin = m_Position;
+            bool isValid = false;
+            switch (m_Text[m_Position])
+            {
+                case '"':
+                    value.type = JsonValue::Type::eString;
+                    isValid    = parseString(value.string);
+                    break;
+                case '[':
+                    value.type = JsonValue::Type::eArray;
+                    isValid    = parseArray(value, depth);
+                    break;
+                case '{':
+                    value.type = JsonValue::Type::eObject;
+                    isValid    = parseObject(value, depth);
+                    break;
+                case 't':
+                    value.type = JsonValue::Type::eBool;
+                    isValid    = consume("true");
+                    break;
+                case 'f':
+                    value.type = JsonValue::Type::eBool;
+                    isValid    = consume("false");
+                    break;
+                case 'n':
+                    isValid = consume("null");
+                    break;
+                default: {
+                    value.type      = JsonValue::Type::eNumber;
+                    const auto last = m_Text.find_first_not_of("+-0123456789.eE", m_Position);
+                    const std::string number {m_Text.substr(m_Position, last - m_Position)};
+
+                    char* numberEnd = nullptr;
+                    value.number    = std::strtod(number.c_str(), &numberEnd);
+                    isValid         = !number.empty() && numberEnd == number.c_str() + number.size();
+                    m_Position     += number.size();
+                    break;
+                }
+            }
+            value.end = m_Position;
+            return isValid;
+        }
+
+        bool parseArray(JsonValue& value, uint32_t depth)
+        {
+            consume('[');
+            if (consume(']'))
+                return true;
+
+            do
+            {
+                if (!parseValue(value.elements.emplace_back(), depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume(']');
+        }
+
+        bool parseObject(JsonValue& value, uint32_t depth)
+        {
+            consume('{');
+            if (consume('}'))
+                return true;
+
+            do
+            {
+                auto& [name, member] = value.members.emplace_back();
+                if (!parseString(name) || !consume(':') || !parseValue(member, depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume('}');
+        }
+
+    private:
+        std::string_view m_Text;
+        size_t           m_Position {0};
+    };
+
+    // The bytes of a base64 data URI, empty when it is not one
+    std::vector<uint8_t> decodeDataURI(std::string_view uri)
+    {
+        const auto payload = uri.find(";base64,");
+        if (!uri.starts_with("data:") || payload == std::string_view::npos)
+            return {};
+
+        std::vector<uint8_t> bytes;
+        uint32_t             bits    = 0;
+        uint32_t             numBits = 0;
+        for (const auto c : uri.substr(payload + 8))
+        {
+            int value = -1;
+            if (c >= 'A' && c <= 'Z')
+                value = c - 'A';
+            else if (c >= 'a' && c <= 'z')
+                value = c - 'a' + 26;
+            else if (c >= '0' && c <= '9')
+                value = c - '0' + 52;
+            else if (c == '+')
+                value = 62;
+            else if (c == '/')
+                value = 63;
+            if (value < 0)
+                break;
+
+            bits = bits << 6 | static_cast<uint32_t>(value);
+            numBits += 6;
+            if (numBits >= 8)
+            {
+                numBits -= 8;
+                bytes.push_back(static_cast<uint8_t>(bits >> numBits));
+            }
+        }
+        return bytes;
+    }
+
+    std::vector<uint8_t> readFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return {};
+
+        std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return file ? bytes : std::vector<uint8_t> {};
+    }
+
+    // Bytes of a glTF image, from its file, its data URI or its buffer view, empty when they cannot be read
+    std::vector<uint8_t>
+    readImage(const JsonValue& gltf, const JsonValue& image, const std::filesystem::path& directory)
+    {
+        const auto readURI = [&](const std::string& uri) {
+            return uri.starts_with("data:") ? decodeDataURI(uri) : readFile(directory / decodePercentEncoding(uri));
+        };
+
+        if (const auto* uri = image.find("uri", JsonValue::Type::eString))
+            return readURI(uri->string);
+
+        const auto bufferViews = gltf.getArray("bufferViews");
+        const auto bufferView  = image.getIndex("bufferView");
+        if (!bufferView || *bufferView >= bufferViews.size())
+            return {};
+
+        const auto& view    = bufferViews[*bufferView];
+        const auto  buffers = gltf.getArray("buffers");
+        const auto  buffer  = view.getIndex("buffer");
+        if (!buffer || *buffer >= buffers.size())
+            return {};
+
+        const auto* uri = buffers[*buffer].find("uri", JsonValue::Type::eString);
+        if (!uri)
+            return {};
+
+        const auto   bytes  = readURI(uri->string);
+        const size_t offset = view.getIndex("byteOffset").value_or(0);
+        const size_t size   = view.getIndex("byteLength").value_or(0);
+        if (offset + size > bytes.size())
+            return {};
+        return {bytes.begin() + static_cast<ptrdiff_t>(offset), bytes.begin() + static_cast<ptrdiff_t>(offset + size)};
+    }
+
+    // A JSON string of the text, which has to be escaped
+    std::string quoteJson(std::string_view text)
+    {
+        std::string quoted = "\"";
+        for (const auto c : text)
+        {
+            if (c == '"' || c == '\\')
+                quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    bool isDecodedByStb(const std::string& uri)
+    {
+        auto extension = std::filesystem::path(uri).extension().string();
+        std::ranges::transform(extension, extension.begin(), [](char c) { return std::tolower(c); });
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+    }
+
+    // 64-bit FNV-1a, like the program cache
+    constexpr uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        return hash;
+    }
+
+    // With its mipmaps
+    size_t getRGBA8Size(uint32_t width, uint32_t height)
+    {
+        size_t size = 0;
+        for (uint32_t level = 0; level < std::bit_width(std::max(width, height)); ++level)
+            size += static_cast<size_t>(std::max(width >> level, 1u)) * std::max(height >> level, 1u) * 4;
+        return size;
+    }
+
+    bool isSRGBFormat(GLint internalFormat)
+    {
+        return internalFormat == GL_SRGB || internalFormat == GL_SRGB_ALPHA || internalFormat == GL_SRGB8 ||
+               internalFormat == GL_SRGB8_ALPHA8;
+    }
+
+    size_t alignUp(size_t offset, size_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+    bool writeFile(const std::filesystem::path& path, const void* data, size_t size)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(file);
+    }
+} // namespace
+
+AssetLoader::AssetLoader(LoadMode loadMode, TextureCompression compression) :
+    m_LoadMode(loadMode), m_Compression(compression)
+{}
+
+AssetLoader::~AssetLoader()
+{
+    {
+        // Under the lock, so that the pool waiting for the uses of the images cannot miss it
+        std::lock_guard lock(m_Mutex);
+        m_IsStopping = true;
+    }
+    m_Condition.notify_all();
+    if (m_Decoder.joinable())
+        m_Decoder.join();
+
+    destroyStagingRing();
+    for (const auto& [placeholder, streamed] : m_Textures)
+        glDeleteTextures(1, &streamed.texture);
+    glDeleteTextures(static_cast<GLsizei>(m_NeutralTextures.size()), m_NeutralTextures.data());
+}
+
+bool AssetLoader::load(const std::filesystem::path&   path,
+                       vgfw::resource::Model&         model,
+                       vgfw::renderer::RenderContext& rc,
+                       const glm::vec3&               scale)
+{
+    VGFW_PROFILE_NAMED_SCOPE("Load Model");
+
+    m_Start = Clock::now();
+
+    std::filesystem::path placeholderPath;
+    if (m_LoadMode == LoadMode::eStreaming)
+    {
+        placeholderPath = writePlaceholderModel(path);
+        if (placeholderPath.empty())
+            m_LoadMode = LoadMode::eBlocking;
+    }
+
+    if (m_LoadMode == LoadMode::eBlocking || !glfwExtensionSupported("GL_EXT_texture_compression_s3tc") ||
+        !glfwExtensionSupported("GL_EXT_texture_sRGB"))
+        m_Compression = TextureCompression::eNone;
+
+    if (m_LoadMode == LoadMode::eStreaming)
+    {
+        if (m_Compression == TextureCompression::eBlockCompressed)
+            m_TextureCache =
+                std::make_unique<TextureCache>(path.parent_path() / (path.stem().string() + ".texture_cache"));
+
+        m_Stats.numImages = static_cast<uint32_t>(m_ImagePaths.size());
+        m_IsDone          = m_ImagePaths.empty();
+        createNeutralTextures();
+
+        // The images decode while vgfw parses the model, the calling thread keeps a core of its own
+        const auto numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        m_Pool                = std::make_unique<lpv_cpu::ThreadPool>(numThreads);
+        m_Stats.numThreads    = m_Pool->getNumThreads();
+        m_Decoder             = std::thread {&AssetLoader::decodeImages, this};
+    }
+
+    const auto isLoaded = vgfw::io::loadModel(
+        (m_LoadMode == LoadMode::eStreaming ? placeholderPath : path).string(), model, rc, scale);
+
+    // vgfw is done with the placeholders once it has created their textures
+    if (!placeholderPath.empty())
+    {
+        std::error_code error;
+        std::filesystem::remove_all(placeholderPath.parent_path(), error);
+    }
+
+    m_Stats.parseMilliseconds = getMilliseconds(Clock::now() - m_Start);
+    if (m_LoadMode == LoadMode::eBlocking)
+        m_Stats.totalMilliseconds = m_Stats.parseMilliseconds;
+
+    return isLoaded;
+}
+
+bool AssetLoader::update()
+{
+    if (m_IsDone)
+        return false;
+
+    VGFW_PROFILE_NAMED_SCOPE("Upload Images");
+
+    const auto start = Clock::now();
+    if (!m_HasUses)
+    {
+        // getTexture() has seen every material texture, the pool can pick the formats
+        {
+            std::lock_guard lock(m_Mutex);
+            m_HasUses = true;
+        }
+        m_Condition.notify_all();
+    }
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stats.numDecoded += static_cast<uint32_t>(m_Decoded.size());
+        std::ranges::move(m_Decoded, std::back_inserter(m_Pending));
+        m_Decoded.clear();
+
+        m_Stats.numCached              = m_NumCached;
+        m_Stats.decodeMilliseconds     = m_DecodeMilliseconds;
+        m_Stats.compressMilliseconds   = m_CompressMilliseconds;
+        m_Stats.decodeWallMilliseconds = m_DecodeWallMilliseconds;
+    }
+    if (m_Pending.empty())
+        return false;
+
+    if (!m_StagingBuffer)
+        createStagingRing();
+
+    // The frame skips the uploads rather than waiting for the GPU to be done with the region
+    auto& fence = m_StagingFences[m_StagingFrame];
+    if (fence)
+    {
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            return false;
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    const auto regionOffset = static_cast<GLsizeiptr>(m_StagingFrame) * kStagingFrameSize;
+    GLsizeiptr offset       = 0;
+    bool       hasUploaded  = false;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingBuffer);
+    while (!m_Pending.empty())
+    {
+        const auto& image = m_Pending.front();
+
+        // Every level starts 16-byte aligned in the region
+        GLsizeiptr size = 0;
+        for (const auto& level : image.levels)
+            size += static_cast<GLsizeiptr>(alignUp(level.size(), 16));
+
+        std::vector<const void*> levels;
+        if (image.levels.empty())
+        {
+            std::cerr << "Failed to decode " << m_ImagePaths[image.index] << std::endl;
+        }
+        else if (size > kStagingFrameSize)
+        {
+            // Larger than a region, uploaded straight from the decoded levels
+            for (const auto& level : image.levels)
+                levels.push_back(level.data());
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            uploadImage(image, levels);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingBuffer);
+        }
+        else
+        {
+            if (offset + size > kStagingFrameSize)
+                break;
+
+            for (const auto& level : image.levels)
+            {
+                std::memcpy(m_StagingMapped + regionOffset + offset, level.data(), level.size());
+                levels.push_back(reinterpret_cast<const void*>(regionOffset + offset));
+                offset += static_cast<GLsizeiptr>(alignUp(level.size(), 16));
+            }
+            uploadImage(image, levels);
+        }
+
+        for (const auto& level : image.levels)
+            m_Stats.numBytes += level.size();
+        hasUploaded = hasUploaded || !image.levels.empty();
+        ++m_Stats.numUploaded;
+        m_Pending.pop_front();
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (offset > 0)
+    {
+        fence          = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_StagingFrame = (m_StagingFrame + 1) % kNumFrames;
+    }
+    if (hasUploaded)
+        ++m_Stats.numFrames;
+
+    const auto end = Clock::now();
+    m_Stats.uploadMilliseconds += getMilliseconds(end - start);
+
+    if (m_Stats.numUploaded == m_Stats.numImages)
+    {
+        // The GPU keeps the staging buffer alive until the last copies are done
+        destroyStagingRing();
+        m_Decoder.join();
+        m_Pool.reset();
+
+        m_Stats.totalMilliseconds = getMilliseconds(end - m_Start);
+        m_IsDone                  = true;
+    }
+    return hasUploaded;
+}
+
+GLuint AssetLoader::getTexture(GLuint texture, uint32_t slot)
+{
+    if (m_LoadMode == LoadMode::eBlocking || m_NotPlaceholders.contains(texture))
+        return 0;
+
+    auto it = m_Textures.find(texture);
+    if (it == m_Textures.end())
+    {
+        // vgfw does not tell which image a texture was created from, the size of a placeholder gives the index of its
+        // glTF image, see writePlaceholderModel()
+        GLint width = 0, height = 0;
+        glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_HEIGHT, &height);
+
+        const auto placeholder = height == m_PlaceholderHeight && width >= 2
+                                     ? m_ImageIndices.find(static_cast<uint32_t>(width - 2))
+                                     : m_ImageIndices.end();
+        if (placeholder == m_ImageIndices.end())
+        {
+            m_NotPlaceholders.insert(texture);
+            return 0;
+        }
+
+        const auto imageIndex = placeholder->second;
+        it = m_Textures.emplace(texture, StreamedTexture {.imageIndex = imageIndex}).first;
+        m_ImagePlaceholders[imageIndex].push_back(texture);
+
+        GLint internalFormat = GL_RGBA8;
+        glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+        m_ImageUses[imageIndex].isSRGB = m_ImageUses[imageIndex].isSRGB || isSRGBFormat(internalFormat);
+    }
+
+    // Read by the pool after the first update()
+    if (!m_HasUses)
+        m_ImageUses[it->second.imageIndex].slots |= 1u << slot;
+
+    return it->second.texture ? it->second.texture : m_NeutralTextures[slot];
+}
+
+const char* AssetLoader::getLoadModeName() const
+{
+    return m_LoadMode == LoadMode::eStreaming ? "streaming" : "blocking";
+}
+
+const char* AssetLoader::getTextureCompressionName() const
+{
+    return m_Compression == TextureCompression::eBlockCompressed ? "BC1-5" : "RGBA8";
+}
+
+std::filesystem::path AssetLoader::writePlaceholderModel(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return {};
+    const std::string model {std::istreambuf_iterator<char>(file), {}};
+
+    const auto gltf = JsonParser(model).parse();
+    if (!gltf || gltf->type != JsonValue::Type::eObject)
+        return {};
+
+    // In a directory of the launch under the temporary one, load() removes it. The asset directory may be read-only,
+    // and another launch may be writing placeholders of its own.
+    std::error_code error;
+    const auto      temporaryDirectory = std::filesystem::temp_directory_path(error);
+    if (error)
+        return {};
+
+    std::random_device random;
+    const auto         directory            = std::filesystem::absolute(path).parent_path();
+    const auto         placeholderDirectory = temporaryDirectory / ("lpv_placeholders_" + std::to_string(random()));
+    std::filesystem::create_directories(placeholderDirectory, error);
+    if (error)
+        return {};
+
+    // The buffer URIs are made relative to the placeholder directory
+    const auto modelDirectory = std::filesystem::relative(directory, placeholderDirectory, error).generic_string();
+    if (error || modelDirectory.empty())
+    {
+        std::filesystem::remove_all(placeholderDirectory, error);
+        return {};
+    }
+
+    // The image files stb_image decodes are streamed when a texture samples them, the images embedded in data URIs
+    // or buffer views are left to vgfw, like the files of other formats
+    const auto           images = gltf->getArray("images");
+    std::vector<uint8_t> isSampled(images.size(), false);
+    for (const auto& texture : gltf->getArray("textures"))
+    {
+        if (const auto source = texture.getIndex("source"); source && *source < images.size())
+            isSampled[*source] = true;
+    }
+
+    std::vector<const JsonValue*> imageURIs(images.size(), nullptr);
+    std::unordered_set<GLint>     vgfwImageHeights;
+    for (uint32_t index = 0; index < images.size(); ++index)
+    {
+        const auto* uri = images[index].find("uri", JsonValue::Type::eString);
+        if (uri && !uri->string.starts_with("data:") && isDecodedByStb(uri->string))
+        {
+            imageURIs[index] = uri;
+            continue;
+        }
+
+        const auto bytes = readImage(*gltf, images[index], directory);
+        int        width = 0, height = 0, numChannels = 0;
+        if (stbi_info_from_memory(bytes.data(), static_cast<int>(bytes.size()), &width, &height, &numChannels))
+            vgfwImageHeights.insert(height);
+    }
+
+    // The placeholder of the image i is (i + 2) x m_PlaceholderHeight texels, a height none of the images vgfw loads
+    // has and a width above the 1x1 textures it may create, so that getTexture() tells its image from its size
+    while (vgfwImageHeights.contains(m_PlaceholderHeight))
+        ++m_PlaceholderHeight;
+
+    // Tokens of the URIs and their replacements
+    std::vector<std::tuple<size_t, size_t, std::string>> replacements;
+
+    bool isWritten = true;
+    for (uint32_t index = 0; index < images.size(); ++index)
+    {
+        const auto* uri = imageURIs[index];
+        if (!uri)
+            continue;
+
+        const auto placeholderUri = std::to_string(index) + ".png";
+        const auto png            = encodePlaceholderPNG(index + 2, static_cast<uint32_t>(m_PlaceholderHeight));
+        isWritten = isWritten && writeFile(placeholderDirectory / placeholderUri, png.data(), png.size());
+        replacements.emplace_back(uri->begin, uri->end, quoteJson(placeholderUri));
+        if (const auto* mimeType = images[index].find("mimeType", JsonValue::Type::eString))
+            replacements.emplace_back(mimeType->begin, mimeType->end, quoteJson("image/png"));
+
+        if (isSampled[index])
+        {
+            m_ImageIndices.emplace(index, static_cast<uint32_t>(m_ImagePaths.size()));
+            m_ImagePaths.push_back(directory / decodePercentEncoding(uri->string));
+        }
+    }
+
+    for (const auto& buffer : gltf->getArray("buffers"))
+    {
+        const auto* uri = buffer.find("uri", JsonValue::Type::eString);
+        if (uri && !uri->string.starts_with("data:"))
+            replacements.emplace_back(uri->begin, uri->end, quoteJson(modelDirectory + "/" + uri->string));
+    }
+
+    std::ranges::sort(replacements);
+    std::string placeholderModel;
+    size_t      last = 0;
+    for (const auto& [begin, end, uri] : replacements)
+    {
+        placeholderModel.append(model, last, begin - last);
+        placeholderModel += uri;
+        last = end;
+    }
+    placeholderModel.append(model, last);
+
+    const auto placeholderPath = placeholderDirectory / path.filename();
+    if (!isWritten || !writeFile(placeholderPath, placeholderModel.data(), placeholderModel.size()))
+    {
+        std::filesystem::remove_all(placeholderDirectory, error);
+        m_ImagePaths.clear();
+        m_ImageIndices.clear();
+        return {};
+    }
+
+    m_ImagePlaceholders.resize(m_ImagePaths.size());
+    m_ImageUses.resize(m_ImagePaths.size());
+    return placeholderPath;
+}
+
+void AssetLoader::createNeutralTextures()
+{
+    glCreateTextures(GL_TEXTURE_2D, static_cast<GLsizei>(m_NeutralTextures.size()), m_NeutralTextures.data());
+    for (uint32_t slot = 0; slot < kNumMaterialTextures; ++slot)
+    {
+        glTextureStorage2D(m_NeutralTextures[slot], 1, GL_RGBA8, 1, 1);
+        glTextureSubImage2D(
+            m_NeutralTextures[slot], 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, kNeutralTexels[slot].data());
+    }
+}
+
+void AssetLoader::decodeImages()
+{
+    m_Pool->parallelFor(static_cast<uint32_t>(m_ImagePaths.size()), [this](uint32_t index) {
+        if (m_IsStopping)
+            return;
+
+        VGFW_PROFILE_NAMED_SCOPE("Decode Image");
+
+        auto       start  = Clock::now();
+        const auto source = readFile(m_ImagePaths[index]);
+
+        DecodedImage image {
+            .index  = index,
+            .width  = 0,
+            .height = 0,
+            .usage  = TextureUsage::eColor,
+            .format = std::nullopt,
+            .levels = {},
+        };
+        double compressMilliseconds = 0.0;
+        bool   isCached             = false;
+        if (m_Compression == TextureCompression::eBlockCompressed)
+        {
+            // The hash of the source is the key of the cache, its format the slots sampling the image
+            auto sourceHash = hashBytes(kHashSeed, &kTextureVersion, sizeof(kTextureVersion));
+            sourceHash      = hashBytes(sourceHash, source.data(), source.size());
+
+            // The wait is not part of the decode time
+            const auto waitStart = Clock::now();
+            ImageUse   use;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_Condition.wait(lock, [this] { return m_HasUses || m_IsStopping; });
+                if (m_IsStopping)
+                    return;
+                use = m_ImageUses[index];
+            }
+            start += Clock::now() - waitStart;
+
+            switch (use.slots)
+            {
+                case 1u << kNormalSlot:
+                    image.usage = TextureUsage::eNormal;
+                    break;
+                case 1u << kMetallicRoughnessSlot:
+                    image.usage = TextureUsage::eMetallicRoughness;
+                    break;
+                case 1u << kOcclusionSlot:
+                    image.usage = TextureUsage::eOcclusion;
+                    break;
+                default:
+                    image.usage = TextureUsage::eColor;
+                    break;
+            }
+            sourceHash = hashBytes(sourceHash, &image.usage, sizeof(image.usage));
+            sourceHash = hashBytes(sourceHash, &use.isSRGB, sizeof(use.isSRGB));
+
+            auto texture = m_TextureCache->load(sourceHash);
+            isCached     = texture.has_value();
+            if (!texture)
+            {
+                const auto compressStart = Clock::now();
+                texture                  = compressImage(source, sourceHash, image.usage, use.isSRGB);
+                compressMilliseconds     = getMilliseconds(Clock::now() - compressStart);
+            }
+
+            if (texture)
+            {
+                image.width  = texture->width;
+                image.height = texture->height;
+                image.format = texture->format;
+                image.levels = std::move(texture->levels);
+            }
+        }
+        else
+        {
+            int   width  = 0;
+            int   height = 0;
+            int   numChannels;
+            auto* pixels = stbi_load_from_memory(
+                source.data(), static_cast<int>(source.size()), &width, &height, &numChannels, 4);
+            if (pixels)
+            {
+                image.width  = static_cast<uint32_t>(width);
+                image.height = static_cast<uint32_t>(height);
+                image.levels.emplace_back(pixels, pixels + static_cast<size_t>(width) * height * 4);
+                stbi_image_free(pixels);
+            }
+        }
+        const auto end = Clock::now();
+
+        std::lock_guard lock(m_Mutex);
+        m_Decoded.push_back(std::move(image));
+        if (isCached)
+            ++m_NumCached;
+        m_DecodeMilliseconds += getMilliseconds(end - start);
+        m_CompressMilliseconds += compressMilliseconds;
+        m_DecodeWallMilliseconds = getMilliseconds(end - m_Start);
+    });
+}
+
+std::optional<TextureCache::Texture> AssetLoader::compressImage(const std::vector<uint8_t>& source,
+                                                                uint64_t                    sourceHash,
+                                                                TextureUsage                usage,
+                                                                bool                        isSRGB)
+{
+    int   width  = 0;
+    int   height = 0;
+    int   numChannels;
+    auto* pixels =
+        stbi_load_from_memory(source.data(), static_cast<int>(source.size()), &width, &height, &numChannels, 4);
+    if (!pixels)
+        return std::nullopt;
+
+    std::vector<uint8_t> rgba(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    auto filter = isSRGB ? MipFilter::eSRGB : MipFilter::eLinear;
+    if (usage == TextureUsage::eNormal)
+        filter = MipFilter::eNormal;
+    const auto levels =
+        generateMipChain(std::move(rgba), static_cast<uint32_t>(width), static_cast<uint32_t>(height), filter);
+
+    // Roughness and metallic are the green and blue channels of glTF
+    auto                    format   = BlockFormat::eBC1;
+    std::array<uint32_t, 2> channels = {0, 1};
+    switch (usage)
+    {
+        case TextureUsage::eColor:
+            format = hasTranslucentTexels(levels.front()) ? BlockFormat::eBC3 : BlockFormat::eBC1;
+            break;
+        case TextureUsage::eNormal:
+            format = BlockFormat::eBC5;
+            break;
+        case TextureUsage::eMetallicRoughness:
+            format   = BlockFormat::eBC5;
+            channels = {1, 2};
+            break;
+        case TextureUsage::eOcclusion:
+            format = BlockFormat::eBC4;
+            break;
+    }
+
+    TextureCache::Texture texture {
+        .format = format,
+        .isSRGB = isSRGB && (format == BlockFormat::eBC1 || format == BlockFormat::eBC3),
+        .width  = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+        .levels = {},
+    };
+    for (const auto& level : levels)
+        texture.levels.push_back(compressLevel(level, format, channels));
+
+    m_TextureCache->save(sourceHash, texture);
+    return texture;
+}
+
+void AssetLoader::uploadImage(const DecodedImage& image, const std::vector<const void*>& levels)
+{
+    for (const auto placeholder : m_ImagePlaceholders[image.index])
+    {
+        const auto internalFormat = getInternalFormat(placeholder, image);
+
+        auto& streamed   = m_Textures.at(placeholder);
+        streamed.texture = createTexture(placeholder, internalFormat, image);
+        if (image.format)
+        {
+            for (uint32_t level = 0; level < image.levels.size(); ++level)
+            {
+                glCompressedTextureSubImage2D(streamed.texture,
+                                              static_cast<GLint>(level),
+                                              0,
+                                              0,
+                                              static_cast<GLsizei>(std::max(image.width >> level, 1u)),
+                                              static_cast<GLsizei>(std::max(image.height >> level, 1u)),
+                                              internalFormat,
+                                              static_cast<GLsizei>(image.levels[level].size()),
+                                              levels[level]);
+                m_Stats.numTextureBytes += image.levels[level].size();
+            }
+        }
+        else
+        {
+            glTextureSubImage2D(streamed.texture,
+                                0,
+                                0,
+                                0,
+                                static_cast<GLsizei>(image.width),
+                                static_cast<GLsizei>(image.height),
+                                GL_RGBA,
+                                GL_UNSIGNED_BYTE,
+                                levels.front());
+            glGenerateTextureMipmap(streamed.texture);
+            m_Stats.numTextureBytes += getRGBA8Size(image.width, image.height);
+        }
+        m_Stats.numRGBA8Bytes += getRGBA8Size(image.width, image.height);
+    }
+}
+
+GLenum AssetLoader::getInternalFormat(GLuint placeholder, const DecodedImage& image) const
+{
+    // The format vgfw picked for the slot, sized for the immutable storage
+    GLint internalFormat = GL_RGBA8;
+    glGetTextureLevelParameteriv(placeholder, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+
+    const auto isSRGB = isSRGBFormat(internalFormat);
+    if (image.format)
+    {
+        switch (*image.format)
+        {
+            case BlockFormat::eBC1:
+                return isSRGB ? kCompressedSRGBDXT1 : kCompressedRGBDXT1;
+            case BlockFormat::eBC3:
+                return isSRGB ? kCompressedSRGBAlphaDXT5 : kCompressedRGBADXT5;
+            case BlockFormat::eBC4:
+                return GL_COMPRESSED_RED_RGTC1;
+            case BlockFormat::eBC5:
+                return GL_COMPRESSED_RG_RGTC2;
+        }
+    }
+
+    switch (internalFormat)
+    {
+        case GL_RGB:
+        case GL_RGBA:
+            return GL_RGBA8;
+        case GL_SRGB:
+        case GL_SRGB_ALPHA:
+            return GL_SRGB8_ALPHA8;
+        default:
+            return static_cast<GLenum>(internalFormat);
+    }
+}
+
+GLuint AssetLoader::createTexture(GLuint placeholder, GLenum internalFormat, const DecodedImage& image) const
+{
+    GLuint texture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture,
+                       static_cast<GLsizei>(std::bit_width(std::max(image.width, image.height))),
+                       internalFormat,
+                       static_cast<GLsizei>(image.width),
+                       static_cast<GLsizei>(image.height));
+
+    // Sampled like the placeholder when the material has no sampler object, and through the mipmaps
+    GLint magFilter = GL_LINEAR, wrapS = GL_REPEAT, wrapT = GL_REPEAT;
+    glGetTextureParameteriv(placeholder, GL_TEXTURE_MAG_FILTER, &magFilter);
+    glGetTextureParameteriv(placeholder, GL_TEXTURE_WRAP_S, &wrapS);
+    glGetTextureParameteriv(placeholder, GL_TEXTURE_WRAP_T, &wrapT);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, magFilter);
+    glTextureParameteri(
+        texture, GL_TEXTURE_MIN_FILTER, magFilter == GL_NEAREST ? GL_NEAREST_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, wrapS);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, wrapT);
+
+    // Roughness and metallic back in the green and blue channels the shaders sample
+    if (image.format && image.usage == TextureUsage::eMetallicRoughness)
+    {
+        const std::array<GLint, 4> swizzle {GL_ZERO, GL_RED, GL_GREEN, GL_ONE};
+        glTextureParameteriv(texture, GL_TEXTURE_SWIZZLE_RGBA, swizzle.data());
+    }
+
+    return texture;
+}
+
+void AssetLoader::createStagingRing()
+{
+    constexpr GLbitfield kFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glCreateBuffers(1, &m_StagingBuffer);
+    glNamedBufferStorage(m_StagingBuffer, kStagingFrameSize * kNumFrames, nullptr, kFlags);
+    m_StagingMapped =
+        static_cast<std::byte*>(glMapNamedBufferRange(m_StagingBuffer, 0, kStagingFrameSize * kNumFrames, kFlags));
+}
+
+void AssetLoader::destroyStagingRing()
+{
+    for (auto& fence : m_StagingFences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (m_StagingBuffer)
+    {
+        glUnmapNamedBuffer(m_StagingBuffer);
+        glDeleteBuffers(1, &m_StagingBuffer);
+    }
+    m_StagingBuffer = 0;
+    m_StagingMapped = nullptr;
+    m_StagingFrame  = 0;
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include "scene_draw_stream.hpp"
+#include "texture_cache.hpp"
+
+#include <lpv_cpu/thread_pool.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+// Loads a glTF model whose external images are decoded on a thread pool and streamed to the GPU over the first frames.
+// vgfw::io::loadModel only parses the model and builds its geometry: it is given a copy of the glTF, written to a
+// temporary directory, whose image files are placeholders whose size gives the index of the glTF image they stand for.
+// The images are decoded while it parses, and every frame uploads the decoded ones through a ring of pixel buffer
+// objects, then generates their mipmaps on the GPU. Until its image is uploaded, a material slot samples a neutral
+// texture, see getTexture().
+//
+// With the block compression, the images are compressed on the pool instead (texture_compression.hpp), their mipmaps
+// computed on the CPU, and saved to a TextureCache next to the model that later launches load them from. The format
+// follows the slots an image is used by, which the pool waits for until the first update():
+//  - base color and emissive: BC1, BC3 with translucent texels
+//  - normal: BC5 of X and Y, lib/material.glsl rebuilds Z
+//  - metallic-roughness: BC5 of roughness and metallic, swizzled back to G and B
+//  - occlusion: BC4
+// An image shared by several kinds of slots is compressed as a base color.
+class AssetLoader
+{
+public:
+    enum class LoadMode
+    {
+        eBlocking,  // vgfw::io::loadModel decodes and uploads every image before load() returns
+        eStreaming, // Images decoded by a thread pool and uploaded by update()
+    };
+
+    enum class TextureCompression
+    {
+        eNone,            // RGBA8, mipmaps generated on the GPU
+        eBlockCompressed, // Of the streamed images, when the GL supports S3TC
+    };
+
+    explicit AssetLoader(LoadMode           loadMode    = LoadMode::eStreaming,
+                         TextureCompression compression = TextureCompression::eBlockCompressed);
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&)            = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Falls back on the blocking load when the placeholder model cannot be written to the temporary directory
+    bool load(const std::filesystem::path&   path,
+              vgfw::resource::Model&         model,
+              vgfw::renderer::RenderContext& rc,
+              const glm::vec3&               scale);
+
+    // Uploads the images decoded since the last frame, as many as the staging region of the frame holds. Returns true
+    // when getTexture() gives new textures. getTexture() has to have been called for every material texture first.
+    bool update();
+    // Every image is uploaded
+    bool isDone() const { return m_IsDone; }
+
+    // Texture a material slot (see lib/material.glsl) samples instead of the one vgfw created, 0 to keep it: the image
+    // of a placeholder once it is uploaded, the neutral texture of the slot before
+    GLuint getTexture(GLuint texture, uint32_t slot);
+
+    // "streaming" or "blocking"
+    const char* getLoadModeName() const;
+    // "BC1-5" or "RGBA8"
+    const char* getTextureCompressionName() const;
+
+    struct Stats
+    {
+        uint32_t numImages {0};   // Streamed, the ones embedded in the buffers of the model are loaded by vgfw
+        uint32_t numThreads {0};  // Of the pool
+        uint32_t numDecoded {0};  // Including the ones that failed
+        uint32_t numUploaded {0}; // Uploaded or failed
+        uint32_t numFrames {0};   // Frames that uploaded an image
+        uint32_t numCached {0};   // Loaded from the texture cache
+        size_t   numBytes {0};    // Uploaded, the mipmaps generated on the GPU excluded
+
+        // Of the textures created for the placeholders, every mipmap included, and of the same textures in RGBA8
+        size_t numTextureBytes {0};
+        size_t numRGBA8Bytes {0};
+
+        double parseMilliseconds {0.0};      // vgfw::io::loadModel, every image included in the blocking mode
+        double decodeMilliseconds {0.0};     // Reading, decoding and compressing, summed over the threads of the pool
+        double compressMilliseconds {0.0};   // Of which decoding and compressing the images missing from the cache
+        double decodeWallMilliseconds {0.0}; // From load() to the last image decoded
+        double uploadMilliseconds {0.0};     // Spent in update() on the calling thread
+        double totalMilliseconds {0.0};      // From load() to the last image uploaded
+    };
+
+    // Read on the thread calling update()
+    const Stats& getStats() const { return m_Stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint32_t   kNumFrames        = 3;
+    static constexpr GLsizeiptr kStagingFrameSize = 16 * 1024 * 1024;
+
+    // Of the material slots sampling an image
+    enum class TextureUsage
+    {
+        eColor,
+        eNormal,
+        eMetallicRoughness,
+        eOcclusion,
+    };
+
+    struct ImageUse
+    {
+        uint32_t slots {0}; // Bit per slot
+        bool     isSRGB {false};
+    };
+
+    struct DecodedImage
+    {
+        uint32_t                          index;
+        uint32_t                          width;
+        uint32_t                          height;
+        TextureUsage                      usage;
+        std::optional<BlockFormat>        format; // Of the levels, RGBA8 without
+        std::vector<std::vector<uint8_t>> levels; // Every mipmap when compressed, empty when the decode failed
+    };
+
+    // Texture standing for a placeholder
+    struct StreamedTexture
+    {
+        uint32_t imageIndex;
+        GLuint   texture {0}; // Until its image is uploaded
+    };
+
+    // Writes the glTF of the placeholders and their images, returns its path or an empty one on a failure
+    std::filesystem::path writePlaceholderModel(const std::filesystem::path& path);
+    void                  createNeutralTextures();
+    void                  decodeImages();
+    // Of an image of the given bytes, from the cache or compressed, std::nullopt when it cannot be decoded
+    std::optional<TextureCache::Texture>
+    compressImage(const std::vector<uint8_t>& source, uint64_t sourceHash, TextureUsage usage, bool isSRGB);
+
+    // The levels are pointers to their bytes, or offsets in the bound pixel unpack buffer
+    void   uploadImage(const DecodedImage& image, const std::vector<const void*>& levels);
+    GLenum getInternalFormat(GLuint placeholder, const DecodedImage& image) const;
+    GLuint createTexture(GLuint placeholder, GLenum internalFormat, const DecodedImage& image) const;
+
+    void createStagingRing();
+    void destroyStagingRing();
+
+    LoadMode           m_LoadMode;
+    TextureCompression m_Compression;
+    Clock::time_point  m_Start;
+    bool               m_IsDone {true};
+    Stats              m_Stats;
+
+    // The paths are read by the pool, the placeholders of every image (from getTexture()) by the calling thread. The
+    // uses are read by the pool once m_HasUses is set.
+    std::vector<std::filesystem::path>          m_ImagePaths;
+    std::vector<std::vector<GLuint>>            m_ImagePlaceholders;
+    std::vector<ImageUse>                       m_ImageUses;
+    std::unordered_map<uint32_t, uint32_t>      m_ImageIndices;      // Of the streamed images, by glTF image index
+    GLint                                       m_PlaceholderHeight {1};
+    std::unordered_map<GLuint, StreamedTexture> m_Textures;          // Of the placeholders
+    std::unordered_set<GLuint>                  m_NotPlaceholders;   // Other textures vgfw created
+    std::array<GLuint, kNumMaterialTextures>    m_NeutralTextures {};
+    std::deque<DecodedImage>                    m_Pending; // Decoded, left for the next frames
+
+    // Decoding thread, the calling thread of the pool
+    std::unique_ptr<lpv_cpu::ThreadPool> m_Pool;
+    std::unique_ptr<TextureCache>        m_TextureCache;
+    std::thread                          m_Decoder;
+    std::atomic<bool>                    m_IsStopping {false};
+    std::mutex                           m_Mutex;
+    std::condition_variable              m_Condition; // Of m_HasUses
+    bool                                 m_HasUses {false};
+    std::vector<DecodedImage>            m_Decoded;
+    uint32_t                             m_NumCached {0};
+    double                               m_DecodeMilliseconds {0.0};
+    double                               m_CompressMilliseconds {0.0};
+    double                               m_DecodeWallMilliseconds {0.0};
+
+    // Pixel buffer split into kNumFrames regions like the UniformRing, a region is only written again once the uploads
+    // of the frame that used it are done
+    GLuint                         m_StagingBuffer {0};
+    std::byte*                     m_StagingMapped {nullptr};
+    std::array<GLsync, kNumFrames> m_StagingFences {};
+    uint32_t                       m_StagingFrame {0};
+};
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "vgfw.hpp"
+
+#include "grid3d.hpp"
+#include "lpv_config.hpp"
+#include "passes/radiance_injection_pass.hpp"
+#include "synthetic_rsm.hpp"
+#include "uniform_ring.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+// Compares the raster, clustered and compute injection on a synthetic RSM. Runs on any GL 4.6 driver, including Mesa
+// llvmpipe (LIBGL_ALWAYS_SOFTWARE=1) for reproducible numbers on CPU-only machines.
+namespace
+{
+    constexpr uint32_t kNumWarmupRuns = 4;
+    constexpr uint32_t kNumRuns       = 32;
+
+    struct Result
+    {
+        double             gpuMilliseconds;
+        double             cpuMilliseconds; // Including the wait for the GPU
+        std::vector<float> volume;          // SH-R, SH-G and SH-B
+    };
+
+    Result run(vgfw::renderer::RenderContext&                  rc,
+               vgfw::renderer::framegraph::TransientResources& transientResources,
+               UniformRing&                                    uniformRing,
+               RadianceInjectionPass&                          injectionPass,
+               SyntheticRSM&                                   rsm,
+               const Grid3D&                                   grid,
+               InjectionMode                                   mode)
+    {
+        Result result {};
+
+        GLuint query;
+        glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+
+        for (uint32_t i = 0; i < kNumWarmupRuns + kNumRuns; ++i)
+        {
+            const bool isLastRun = i + 1 == kNumWarmupRuns + kNumRuns;
+
+            uniformRing.beginFrame();
+
+            FrameGraph fg;
+            const auto radianceData = injectionPass.addToGraph(fg, rsm.import(fg), grid, mode);
+
+            // Keeps the injection alive, reads the volume back after the last run
+            fg.addCallbackPass(
+                "Readback",
+                [&](FrameGraph::Builder& builder, auto&) {
+                    builder.read(radianceData.r);
+                    builder.read(radianceData.g);
+                    builder.read(radianceData.b);
+                    builder.setSideEffect();
+                },
+                [&](const auto&, FrameGraphPassResources& resources, void*) {
+                    if (!isLastRun)
+                        return;
+
+                    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+                    const auto numValues = static_cast<size_t>(grid.size.x) * grid.size.y * grid.size.z * 4;
+                    result.volume.resize(numValues * 3);
+                    for (size_t offset = 0; const auto channel : {radianceData.r, radianceData.g, radianceData.b})
+                    {
+                        glGetTextureImage(
+                            static_cast<GLuint>(vgfw::renderer::framegraph::getTexture(resources, channel)),
+                            0,
+                            GL_RGBA,
+                            GL_FLOAT,
+                            static_cast<GLsizei>(numValues * sizeof(float)),
+                            result.volume.data() + offset);
+                        offset += numValues;
+                    }
+                });
+            fg.compile();
+
+            glFinish();
+            const auto start = std::chrono::steady_clock::now();
+
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            fg.execute(&rc, &transientResources);
+            glEndQuery(GL_TIME_ELAPSED);
+            uniformRing.endFrame();
+            glFinish();
+
+            const auto end = std::chrono::steady_clock::now();
+
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            if (i >= kNumWarmupRuns)
+            {
+                result.gpuMilliseconds += elapsed / 1e6 / kNumRuns;
+                result.cpuMilliseconds += std::chrono::duration<double, std::milli>(end - start).count() / kNumRuns;
+            }
+
+            transientResources.update(0.0f);
+        }
+
+        glDeleteQueries(1, &query);
+        return result;
+    }
+
+    // Relative to the largest coefficient of the reference
+    double getMaxRelativeDifference(const std::vector<float>& volume, const std::vector<float>& reference)
+    {
+        double maxDifference = 0.0, maxValue = 0.0;
+        for (size_t i = 0; i < volume.size(); ++i)
+        {
+            maxDifference = std::max(maxDifference, static_cast<double>(std::abs(volume[i] - reference[i])));
+            maxValue      = std::max(maxValue, static_cast<double>(std::abs(reference[i])));
+        }
+        return maxValue > 0.0 ? maxDifference / maxValue : 0.0;
+    }
+
+    void print(const char* name, const Result& result, const Result& reference)
+    {
+        std::printf("  %-10s %9.3f ms GPU %9.3f ms CPU (speed-up %5.2fx) diff %g\n",
+                    name,
+                    result.gpuMilliseconds,
+                    result.cpuMilliseconds,
+                    reference.gpuMilliseconds / result.gpuMilliseconds,
+                    getMaxRelativeDifference(result.volume, reference.volume));
+    }
+} // namespace
+
+int main()
+try
+{
+    if (!vgfw::init())
+    {
+        std::cerr << "Failed to initialize VGFW" << std::endl;
+        return -1;
+    }
+
+    auto window = vgfw::window::create({.title = "LPV Injection Benchmark", .width = 256, .height = 256});
+    vgfw::renderer::init({.window = window});
+
+    auto& rc = vgfw::renderer::getRenderContext();
+    {
+        vgfw::renderer::framegraph::TransientResources transientResources(rc);
+        UniformRing                                    uniformRing;
+        uniformRing.create(4 * 1024);
+
+        RadianceInjectionPass injectionPass(rc, uniformRing);
+
+        const Grid3D grid({.min = glm::vec3 {0.0f}, .max = glm::vec3 {kSceneExtent}},
+                          glm::uvec3 {kLPVResolution},
+                          kSceneExtent / kLPVResolution);
+
+        std::printf("%s, %u^3 cells, %u runs\n",
+                    reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+                    kLPVResolution,
+                    kNumRuns);
+        for (const auto resolution : kRSMResolutions)
+        {
+            SyntheticRSM rsm(rc, resolution);
+            std::printf("RSM %u^2\n", resolution);
+
+            const auto runMode = [&](InjectionMode mode) {
+                return run(rc, transientResources, uniformRing, injectionPass, rsm, grid, mode);
+            };
+
+            const auto raster = runMode(InjectionMode::eRaster);
+            print("Raster", raster, raster);
+            print("Clustered", runMode(InjectionMode::eClustered), raster);
+            print("Compute", runMode(InjectionMode::eCompute), raster);
+
+            rsm.destroy(rc);
+        }
+
+        uniformRing.destroy();
+        getProgramCache().destroy();
+    }
+
+    vgfw::shutdown();
+
+    return 0;
+}
+catch (std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return -1;
+}
\ No newline at end of file
@@ -0,0 +1,287 @@
+#include "vgfw.hpp"
+
+#include "grid3d.hpp"
+#include "lpv_config.hpp"
+#include "passes/radiance_injection_pass.hpp"
+#include "passes/radiance_propagation_pass.hpp"
+#include "synthetic_rsm.hpp"
+#include "uniform_ring.hpp"
+
+#include <lpv_cpu/propagation.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// Sweeps the selectable LPV resolutions and iteration counts over a synthetic RSM, and writes the GPU time of the
+// injection and the propagation to a CSV file (lpv_resolution_bench.csv, or the first argument). The propagation runs
+// the variants specialized for the grid sizes, see GridSizePrograms.
+//
+// Every resolution is first checked: the RGBA16F volumes of the GPU propagation are read back and compared with
+// lpv_cpu propagating the injected volume read back, rounded to fp16 like the GPU, and the fused propagation of 2 to
+// getMaxFusedIterations() iterations per dispatch is compared with the single-step one. The bench exits with 1 when
+// any of them differ by more than the fp16 rounding.
+namespace
+{
+    constexpr uint32_t kNumWarmupRuns   = 4;
+    constexpr uint32_t kNumRuns         = 16;
+    constexpr auto     kIterationCounts = std::array {4u, 8u, 16u, 32u, 64u};
+
+    // Iterations of the check, and the tolerance relative to the largest coefficient: every iteration may round a
+    // coefficient to another fp16 (2^-11 of its value)
+    constexpr uint32_t kNumCheckIterations = 8;
+    constexpr float    kCheckTolerance     = kNumCheckIterations / 2048.0f;
+
+    struct PassTimings
+    {
+        double injectionMilliseconds;
+        double propagationMilliseconds;
+    };
+
+    PassTimings run(vgfw::renderer::RenderContext&                  rc,
+                    vgfw::renderer::framegraph::TransientResources& transientResources,
+                    UniformRing&                                    uniformRing,
+                    RadianceInjectionPass&                          injectionPass,
+                    RadiancePropagationPass&                        propagationPass,
+                    SyntheticRSM&                                   rsm,
+                    const Grid3D&                                   grid,
+                    uint32_t                                        numIterations)
+    {
+        PassTimings timings {};
+
+        // Before the injection, between both passes and after the propagation
+        std::array<GLuint, 3> queries;
+        glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(queries.size()), queries.data());
+
+        for (uint32_t i = 0; i < kNumWarmupRuns + kNumRuns; ++i)
+        {
+            uniformRing.beginFrame();
+
+            FrameGraph fg;
+
+            // Passes run in the order they are added, the timestamps are kept alive by their side effect
+            const auto addTimestamp = [&](GLuint query, const RadianceData* radianceData) {
+                fg.addCallbackPass(
+                    "Timestamp",
+                    [&](FrameGraph::Builder& builder, auto&) {
+                        if (radianceData)
+                            readRadianceData(builder, *radianceData);
+                        builder.setSideEffect();
+                    },
+                    [query](const auto&, FrameGraphPassResources&, void*) { glQueryCounter(query, GL_TIMESTAMP); });
+            };
+
+            addTimestamp(queries[0], nullptr);
+            const auto injected = injectionPass.addToGraph(fg, rsm.import(fg), grid, InjectionMode::eClustered);
+            addTimestamp(queries[1], &injected);
+            const auto propagated =
+                propagationPass.addToGraph(fg, injected, grid, numIterations, PropagationMode::eCompute, {});
+            addTimestamp(queries[2], &propagated);
+
+            fg.compile();
+            fg.execute(&rc, &transientResources);
+            uniformRing.endFrame();
+
+            std::array<GLuint64, 3> timestamps {};
+            for (uint32_t q = 0; q < queries.size(); ++q)
+                glGetQueryObjectui64v(queries[q], GL_QUERY_RESULT, &timestamps[q]);
+
+            if (i >= kNumWarmupRuns)
+            {
+                timings.injectionMilliseconds += (timestamps[1] - timestamps[0]) / 1e6 / kNumRuns;
+                timings.propagationMilliseconds += (timestamps[2] - timestamps[1]) / 1e6 / kNumRuns;
+            }
+
+            transientResources.update(0.0f);
+        }
+
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+        return timings;
+    }
+
+    // Reads the RGBA16F SH-R/G/B volumes back into `volume` when the frame graph executes
+    void addReadbackPass(FrameGraph& fg, const RadianceData& radianceData, lpv_cpu::SHVolume& volume)
+    {
+        fg.addCallbackPass(
+            "Readback",
+            [&](FrameGraph::Builder& builder, auto&) {
+                readRadianceData(builder, radianceData);
+                builder.setSideEffect();
+            },
+            [radianceData, &volume](const auto&, FrameGraphPassResources& resources, void*) {
+                glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+                const auto&           size = volume.getSize();
+                std::vector<uint16_t> texels(static_cast<size_t>(size[0]) * size[1] * size[2] * 4);
+                for (uint32_t color = 0; const auto channel : radianceData.getVolumes())
+                {
+                    glGetTextureImage(static_cast<GLuint>(vgfw::renderer::framegraph::getTexture(resources, channel)),
+                                      0,
+                                      GL_RGBA,
+                                      GL_HALF_FLOAT,
+                                      static_cast<GLsizei>(texels.size() * sizeof(uint16_t)),
+                                      texels.data());
+                    volume.importHalf(color++, texels.data());
+                }
+            });
+    }
+
+    struct Propagation
+    {
+        lpv_cpu::SHVolume injected;
+        lpv_cpu::SHVolume propagated;
+    };
+
+    // Injects the synthetic RSM and propagates it kNumCheckIterations times, both volumes read back
+    Propagation runPropagation(vgfw::renderer::RenderContext&                  rc,
+                               vgfw::renderer::framegraph::TransientResources& transientResources,
+                               UniformRing&                                    uniformRing,
+                               RadianceInjectionPass&                          injectionPass,
+                               RadiancePropagationPass&                        propagationPass,
+                               SyntheticRSM&                                   rsm,
+                               const Grid3D&                                   grid,
+                               const PropagationOptions&                       options)
+    {
+        const std::array<uint32_t, 3> size {grid.size.x, grid.size.y, grid.size.z};
+        Propagation                   propagation {lpv_cpu::SHVolume(size), lpv_cpu::SHVolume(size)};
+
+        uniformRing.beginFrame();
+
+        FrameGraph fg;
+        const auto injected = injectionPass.addToGraph(fg, rsm.import(fg), grid, InjectionMode::eClustered);
+        addReadbackPass(fg, injected, propagation.injected);
+        const auto propagated =
+            propagationPass.addToGraph(fg, injected, grid, kNumCheckIterations, PropagationMode::eCompute, options);
+        addReadbackPass(fg, propagated, propagation.propagated);
+
+        fg.compile();
+        fg.execute(&rc, &transientResources);
+        uniformRing.endFrame();
+        glFinish();
+
+        transientResources.update(0.0f);
+        return propagation;
+    }
+
+    // Largest difference of `volume` to `reference`, relative to the largest coefficient of the reference
+    bool check(const char* name, const lpv_cpu::SHVolume& volume, const lpv_cpu::SHVolume& reference)
+    {
+        const auto maxValue   = reference.getMaxAbsDifference(lpv_cpu::SHVolume(reference.getSize()));
+        const auto difference = maxValue > 0.0f ? volume.getMaxAbsDifference(reference) / maxValue : 0.0f;
+        const bool isWithin   = difference <= kCheckTolerance;
+        std::printf("  %-24s relative difference %g%s\n", name, difference, isWithin ? "" : " (MISMATCH)");
+        return isWithin;
+    }
+
+    bool checkPropagation(vgfw::renderer::RenderContext&                  rc,
+                          vgfw::renderer::framegraph::TransientResources& transientResources,
+                          UniformRing&                                    uniformRing,
+                          RadianceInjectionPass&                          injectionPass,
+                          RadiancePropagationPass&                        propagationPass,
+                          SyntheticRSM&                                   rsm,
+                          const Grid3D&                                   grid)
+    {
+        const auto gpu =
+            runPropagation(rc, transientResources, uniformRing, injectionPass, propagationPass, rsm, grid, {});
+
+        // Same iterations from the injected volume of the GPU, every one rounded like the RGBA16F volumes
+        std::array<lpv_cpu::SHVolume, 2> volumes {gpu.injected, lpv_cpu::SHVolume(gpu.injected.getSize())};
+        for (uint32_t i = 0; i < kNumCheckIterations; ++i)
+        {
+            lpv_cpu::propagate(volumes[i % 2], volumes[(i + 1) % 2], lpv_cpu::detectIsa());
+            volumes[(i + 1) % 2].roundToHalf();
+        }
+
+        bool isMatching = check("GPU vs lpv_cpu", gpu.propagated, volumes[kNumCheckIterations % 2]);
+
+        // The fused dispatches propagate in shared memory, in fp16 like the volumes between the single steps
+        for (uint32_t numFused = 2; numFused <= propagationPass.getMaxFusedIterations(); ++numFused)
+        {
+            const auto fused = runPropagation(rc,
+                                              transientResources,
+                                              uniformRing,
+                                              injectionPass,
+                                              propagationPass,
+                                              rsm,
+                                              grid,
+                                              {.fusedIterations = numFused});
+
+            const auto name = "fused x" + std::to_string(numFused) + " vs single-step";
+            isMatching      = check(name.c_str(), fused.propagated, gpu.propagated) && isMatching;
+        }
+
+        return isMatching;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+try
+{
+    if (!vgfw::init())
+    {
+        std::cerr << "Failed to initialize VGFW" << std::endl;
+        return -1;
+    }
+
+    auto window = vgfw::window::create({.title = "LPV Resolution Benchmark", .width = 256, .height = 256});
+    vgfw::renderer::init({.window = window});
+
+    const auto*   csvPath    = argc > 1 ? argv[1] : "lpv_resolution_bench.csv";
+    bool          isMatching = true;
+    std::ofstream csv(csvPath);
+    csv << "lpv_resolution,iterations,injection_ms,propagation_ms,propagation_ms_per_iteration\n";
+
+    auto& rc = vgfw::renderer::getRenderContext();
+    {
+        vgfw::renderer::framegraph::TransientResources transientResources(rc);
+        UniformRing                                    uniformRing;
+        uniformRing.create(4 * 1024);
+
+        RadianceInjectionPass   injectionPass(rc, uniformRing);
+        RadiancePropagationPass propagationPass(rc, uniformRing);
+        SyntheticRSM            rsm(rc, kRSMResolution);
+
+        std::printf("%s, RSM %u^2, %u runs\n",
+                    reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+                    kRSMResolution,
+                    kNumRuns);
+        for (const auto resolution : kLPVResolutions)
+        {
+            const Grid3D grid({.min = glm::vec3 {0.0f}, .max = glm::vec3 {kSceneExtent}}, resolution);
+            std::printf("LPV %u^3\n", resolution);
+
+            isMatching =
+                checkPropagation(rc, transientResources, uniformRing, injectionPass, propagationPass, rsm, grid) &&
+                isMatching;
+
+            for (const auto numIterations : kIterationCounts)
+            {
+                const auto timings =
+                    run(rc, transientResources, uniformRing, injectionPass, propagationPass, rsm, grid, numIterations);
+                const auto msPerIteration = timings.propagationMilliseconds / numIterations;
+
+                std::printf("  %2u iterations: injection %8.3f ms, propagation %8.3f ms (%7.3f ms/iteration)\n",
+                            numIterations,
+                            timings.injectionMilliseconds,
+                            timings.propagationMilliseconds,
+                            msPerIteration);
+                csv << resolution << ',' << numIterations << ',' << timings.injectionMilliseconds << ','
+                    << timings.propagationMilliseconds << ',' << msPerIteration << '\n';
+            }
+        }
+
+        rsm.destroy(rc);
+        uniformRing.destroy();
+        getProgramCache().destroy();
+    }
+    std::printf("Written to %s\n", csvPath);
+
+    vgfw::shutdown();
+
+    return isMatching ? 0 : 1;
+}
+catch (std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return -1;
+}
\ No newline at end of file
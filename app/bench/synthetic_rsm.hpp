@@ -0,0 +1,70 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include "pass_resource/reflective_shadow_map_data.hpp"
+
+#include <random>
+
+// Side of the cubic scene of the benchmarks
+constexpr float kSceneExtent = 10.0f;
+
+// VPLs on a lit floor and a wall, like the RSM of a sun hitting a courtyard
+struct SyntheticRSM
+{
+    vgfw::renderer::Texture position, normal, flux;
+    uint32_t                resolution;
+
+    SyntheticRSM(vgfw::renderer::RenderContext& rc, uint32_t rsmResolution) : resolution(rsmResolution)
+    {
+        std::mt19937                          rng(1234);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+        std::vector<glm::vec3> positions, normals, fluxes;
+        for (uint32_t y = 0; y < resolution; ++y)
+        {
+            for (uint32_t x = 0; x < resolution; ++x)
+            {
+                const auto u = (x + distribution(rng)) / resolution;
+                const auto v = (y + distribution(rng)) / resolution;
+                if (u < 0.75f)
+                {
+                    positions.emplace_back(kSceneExtent * u / 0.75f, kSceneExtent * 0.05f, kSceneExtent * v);
+                    normals.emplace_back(0.0f, 1.0f, 0.0f);
+                }
+                else
+                {
+                    positions.emplace_back(
+                        kSceneExtent * 0.95f, kSceneExtent * (u - 0.75f) / 0.25f, kSceneExtent * v);
+                    normals.emplace_back(-1.0f, 0.0f, 0.0f);
+                }
+                fluxes.emplace_back(distribution(rng), distribution(rng), distribution(rng));
+            }
+        }
+
+        position = upload(rc, positions);
+        normal   = upload(rc, normals);
+        flux     = upload(rc, fluxes);
+    }
+
+    vgfw::renderer::Texture upload(vgfw::renderer::RenderContext& rc, const std::vector<glm::vec3>& texels) const
+    {
+        auto texture = rc.createTexture2D({resolution, resolution}, vgfw::renderer::PixelFormat::eRGB16F);
+        glTextureSubImage2D(
+            static_cast<GLuint>(texture), 0, 0, 0, resolution, resolution, GL_RGB, GL_FLOAT, texels.data());
+        return texture;
+    }
+
+    void destroy(vgfw::renderer::RenderContext& rc) { rc.destroy(position).destroy(normal).destroy(flux); }
+
+    ReflectiveShadowMapData import(FrameGraph& fg)
+    {
+        return {
+            .position   = vgfw::renderer::framegraph::importTexture(fg, "RSM-Position", &position),
+            .normal     = vgfw::renderer::framegraph::importTexture(fg, "RSM-Normal", &normal),
+            .flux       = vgfw::renderer::framegraph::importTexture(fg, "RSM-Flux", &flux),
+            .depth      = {},
+            .resolution = resolution,
+        };
+    }
+};
\ No newline at end of file
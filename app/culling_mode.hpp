@@ -0,0 +1,8 @@
+#pragma once
+
+enum class CullingMode
+{
+    eNone = 0,  // Every draw of the scene in every view
+    eFrustum,   // Draws intersecting the frustum of a view, culled on the CPU (SceneDrawStream)
+    eOcclusion, // Frustum culled, then the GBuffer view is occlusion culled on the GPU in two phases (OcclusionCuller)
+};
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "gpu_readback.hpp"
+
+void GpuReadback::create(GLsizeiptr slotSize)
+{
+    destroy();
+
+    constexpr GLbitfield kFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    m_SlotSize = slotSize;
+    for (auto& slot : m_Slots)
+    {
+        glCreateBuffers(1, &slot.buffer);
+        glNamedBufferStorage(slot.buffer, slotSize, nullptr, kFlags);
+        slot.mapped = glMapNamedBufferRange(slot.buffer, 0, slotSize, kFlags);
+    }
+}
+
+void GpuReadback::destroy()
+{
+    for (auto& slot : m_Slots)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+        if (slot.buffer)
+        {
+            glUnmapNamedBuffer(slot.buffer);
+            glDeleteBuffers(1, &slot.buffer);
+        }
+        slot = {};
+    }
+    m_SlotSize = 0;
+    m_Next     = 0;
+    m_Oldest   = 0;
+}
+
+void GpuReadback::enqueue(GLuint buffer, GLsizeiptr size)
+{
+    assert(canEnqueue() && size <= m_SlotSize);
+
+    auto& slot = m_Slots[m_Next];
+    glCopyNamedBufferSubData(buffer, slot.buffer, 0, 0, size);
+    slot.size  = size;
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_Next = (m_Next + 1) % kNumSlots;
+}
+
+bool GpuReadback::poll(std::vector<std::byte>& result)
+{
+    auto& slot = m_Slots[m_Oldest];
+    if (!slot.fence)
+        return false;
+
+    // A zero timeout only queries the fence
+    const auto status = glClientWaitSync(slot.fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        return false;
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    const auto* data = static_cast<const std::byte*>(slot.mapped);
+    result.assign(data, data + slot.size);
+
+    m_Oldest = (m_Oldest + 1) % kNumSlots;
+    return true;
+}
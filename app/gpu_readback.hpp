@@ -0,0 +1,39 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+// Ring of persistently mapped buffers GPU results get copied into. A result is only read once the fence following
+// its copy has signaled, so the CPU never waits for the GPU; results arrive a few frames late instead.
+class GpuReadback
+{
+public:
+    static constexpr uint32_t kNumSlots = 3;
+
+    void create(GLsizeiptr slotSize);
+    void destroy();
+
+    bool isValid() const { return m_Slots.front().buffer != 0; }
+
+    // False when every slot still waits for the GPU, the result has to be dropped then
+    bool canEnqueue() const { return m_Slots[m_Next].fence == nullptr; }
+
+    // Copies `size` bytes of `buffer` into the next slot and fences the copy
+    void enqueue(GLuint buffer, GLsizeiptr size);
+
+    // Copies the oldest result out if the GPU is done with it
+    bool poll(std::vector<std::byte>& result);
+
+private:
+    struct Slot
+    {
+        GLuint      buffer {0};
+        const void* mapped {nullptr};
+        GLsizeiptr  size {0};
+        GLsync      fence {nullptr};
+    };
+
+    std::array<Slot, kNumSlots> m_Slots;
+    GLsizeiptr                  m_SlotSize {0};
+    uint32_t                    m_Next {0};
+    uint32_t                    m_Oldest {0};
+};
@@ -0,0 +1,63 @@
+#include "gpu_timer.hpp"
+
+void GpuTimer::create()
+{
+    destroy();
+
+    for (auto& query : m_Queries)
+        glCreateQueries(GL_TIME_ELAPSED, 1, &query.query);
+}
+
+void GpuTimer::destroy()
+{
+    for (auto& query : m_Queries)
+    {
+        if (query.query)
+            glDeleteQueries(1, &query.query);
+        query = {};
+    }
+    m_Next     = 0;
+    m_Oldest   = 0;
+    m_IsTiming = false;
+}
+
+void GpuTimer::begin()
+{
+    poll();
+
+    m_IsTiming = !m_Queries[m_Next].isPending;
+    if (m_IsTiming)
+        glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_Next].query);
+}
+
+void GpuTimer::end()
+{
+    if (!m_IsTiming)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_Queries[m_Next].isPending = true;
+    m_IsTiming                  = false;
+
+    m_Next = (m_Next + 1) % kNumQueries;
+}
+
+void GpuTimer::poll()
+{
+    while (m_Queries[m_Oldest].isPending)
+    {
+        auto& query = m_Queries[m_Oldest];
+
+        GLint isAvailable = GL_FALSE;
+        glGetQueryObjectiv(query.query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (!isAvailable)
+            break;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query.query, GL_QUERY_RESULT, &nanoseconds);
+        m_Milliseconds  = static_cast<double>(nanoseconds) / 1e6;
+        query.isPending = false;
+
+        m_Oldest = (m_Oldest + 1) % kNumQueries;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+// GPU time of a span of commands, measured with a ring of GL_TIME_ELAPSED queries. A query is only read once its
+// result is available, the time arrives a few frames late instead of stalling the CPU.
+class GpuTimer
+{
+public:
+    static constexpr uint32_t kNumQueries = 3;
+
+    void create();
+    void destroy();
+
+    // Spans can't nest, and are skipped while every query still waits for its result
+    void begin();
+    void end();
+
+    // Of the last span whose result was read
+    double getMilliseconds() const { return m_Milliseconds; }
+
+private:
+    // Reads the results available so far
+    void poll();
+
+    struct Query
+    {
+        GLuint query {0};
+        bool   isPending {false};
+    };
+
+    std::array<Query, kNumQueries> m_Queries;
+    uint32_t                       m_Next {0};
+    uint32_t                       m_Oldest {0};
+    bool                           m_IsTiming {false};
+    double                         m_Milliseconds {0.0};
+};
\ No newline at end of file
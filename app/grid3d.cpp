@@ -1,10 +1,61 @@
 #include "grid3d.hpp"
 
-#include "lpv_config.hpp"
-
-Grid3D::Grid3D(const vgfw::math::AABB& aabb) : aabb {aabb}
+Grid3D::Grid3D(const vgfw::math::AABB& aabb, uint32_t resolution) : aabb {aabb}
 {
     const auto extent = aabb.getExtent();
-    cellSize          = vgfw::math::max3(extent) / kLPVResolution;
+    cellSize          = vgfw::math::max3(extent) / static_cast<float>(resolution);
     size              = glm::uvec3 {extent / cellSize + 0.5f};
+}
+
+Grid3D::Grid3D(const vgfw::math::AABB& aabb, const glm::uvec3& size, float cellSize) :
+    aabb {aabb}, size {size}, cellSize {cellSize}
+{}
+
+glm::mat4 Grid3D::fitLightViewProjection(const glm::vec3& lightDirection) const
+{
+    const auto direction = glm::normalize(lightDirection);
+    const auto center    = (aabb.min + aabb.max) * 0.5f;
+    const auto radius    = glm::length(aabb.max - aabb.min) * 0.5f;
+    const auto up        = glm::abs(direction.y) > 0.99f ? glm::vec3 {0.0f, 0.0f, 1.0f} : glm::vec3 {0.0f, 1.0f, 0.0f};
+    const auto view      = glm::lookAt(center - direction * radius, center, up);
+
+    // Tight light space bounds of the 8 AABB corners
+    glm::vec3 lightSpaceMin {std::numeric_limits<float>::max()};
+    glm::vec3 lightSpaceMax {std::numeric_limits<float>::lowest()};
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const glm::vec3 corner {
+            i & 1 ? aabb.max.x : aabb.min.x,
+            i & 2 ? aabb.max.y : aabb.min.y,
+            i & 4 ? aabb.max.z : aabb.min.z,
+        };
+        const auto lightSpaceCorner = glm::vec3 {view * glm::vec4 {corner, 1.0f}};
+        lightSpaceMin               = glm::min(lightSpaceMin, lightSpaceCorner);
+        lightSpaceMax               = glm::max(lightSpaceMax, lightSpaceCorner);
+    }
+
+    // Looking down -Z, so the nearest corner has the largest z
+    const auto projection = glm::ortho(
+        lightSpaceMin.x, lightSpaceMax.x, lightSpaceMin.y, lightSpaceMax.y, -lightSpaceMax.z, -lightSpaceMin.z);
+
+    return projection * view;
+}
+
+std::vector<Grid3D> buildLPVCascades(const glm::vec3& center,
+                                     float            baseCellSize,
+                                     uint32_t         numCascades,
+                                     uint32_t         resolution)
+{
+    std::vector<Grid3D> cascades;
+    cascades.reserve(numCascades);
+
+    for (uint32_t i = 0; i < numCascades; ++i)
+    {
+        const auto cellSize = baseCellSize * static_cast<float>(1u << i);
+        const auto min      = (glm::floor(center / cellSize) - static_cast<float>(resolution) / 2.0f) * cellSize;
+
+        cascades.emplace_back(vgfw::math::AABB {min, min + cellSize * static_cast<float>(resolution)}, resolution);
+    }
+
+    return cascades;
 }
\ No newline at end of file
@@ -1,12 +1,24 @@
 #pragma once
 
-#include "vgfw.hpp"
+#include "lpv_config.hpp"
 
 struct Grid3D
 {
-    explicit Grid3D(const vgfw::math::AABB&);
+    // resolution cells along the longest axis of the AABB
+    explicit Grid3D(const vgfw::math::AABB&, uint32_t resolution = kLPVResolution);
+    Grid3D(const vgfw::math::AABB&, const glm::uvec3& size, float cellSize);
+
+    // Orthographic light view-projection enclosing the whole grid, independent of the camera
+    glm::mat4 fitLightViewProjection(const glm::vec3& lightDirection) const;
 
     vgfw::math::AABB aabb;
     glm::uvec3       size;
     float            cellSize;
-};
\ No newline at end of file
+};
+
+// Nested cubic grids of resolution^3 cells centered on a point, the cell size doubles with every cascade.
+// Every cascade is snapped to its own cells, so moving the center only scrolls whole cells.
+std::vector<Grid3D> buildLPVCascades(const glm::vec3& center,
+                                     float            baseCellSize,
+                                     uint32_t         numCascades,
+                                     uint32_t         resolution);
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+enum class InjectionMode
+{
+    eRaster = 0, // One point per VPL, additively blended into the cell layer set by radiance_injection.geom
+    eClustered,  // One aggregated VPL per cell, see vpl_clustering.comp
+    eCompute,    // Every VPL, binned in shared memory and accumulated with fixed point atomics
+};
\ No newline at end of file
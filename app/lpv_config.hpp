@@ -2,9 +2,20 @@
 
 #include "vgfw.hpp"
 
-constexpr auto kRSMResolution = 512;
-constexpr auto kNumVPL        = kRSMResolution * kRSMResolution;
-constexpr auto kLPVResolution = 32;
+// RSM resolutions selectable at runtime, VPL flux is scaled to the texel footprint of the reference resolution
+constexpr auto kRSMResolutions   = std::array {256u, 512u, 1024u, 2048u};
+constexpr auto kRSMResolution    = 512u;
+
+// LPV resolutions (cells along the longest axis of the grid) selectable at runtime, the propagation has variants
+// specialized for their grid sizes
+constexpr auto kLPVResolutions   = std::array {16u, 32u, 64u, 128u};
+constexpr auto kLPVResolution    = 32u;
+constexpr auto kMaxLPVCascades   = 4;
+constexpr auto kLPVBrickSize     = 4u;  // Cells along a brick edge of the sparse propagation, its workgroup size
+constexpr auto kMaxLPVIterations = 64u; // Upper bound of the adaptive iteration count and the energy readback
+
+// Iterations a dispatch of radiance_propagation_fused.comp can propagate, its shared memory grows with the halo
+constexpr auto kMaxFusedLPVIterations = 3u;
 
 constexpr auto kAdditiveBlending = vgfw::renderer::BlendState {
     .enabled   = true,
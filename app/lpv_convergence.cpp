@@ -0,0 +1,22 @@
+#include "lpv_convergence.hpp"
+
+void LpvConvergence::update(const std::vector<float>& energyDeltas,
+                            uint32_t                  minIterations,
+                            uint32_t                  maxIterations,
+                            float                     threshold)
+{
+    m_History = energyDeltas;
+
+    // The first iteration only copies the injected radiance, it never converges
+    auto numIterations = maxIterations;
+    for (uint32_t i = 1; i < energyDeltas.size(); ++i)
+    {
+        if (energyDeltas[i] < threshold)
+        {
+            numIterations = i + 1;
+            break;
+        }
+    }
+
+    m_NumIterations = glm::clamp(numIterations, minIterations, maxIterations);
+}
\ No newline at end of file
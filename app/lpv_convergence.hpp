@@ -0,0 +1,24 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+// Picks the LPV iteration count from the energy deltas of a previous frame: the first iteration whose relative
+// delta drops below the threshold. The deltas are only measured up to the current count, so without convergence
+// the next frames probe the maximum count.
+class LpvConvergence
+{
+public:
+    void update(const std::vector<float>& energyDeltas,
+                uint32_t                  minIterations,
+                uint32_t                  maxIterations,
+                float                     threshold);
+
+    uint32_t getNumIterations() const { return m_NumIterations; }
+
+    // Energy deltas of the latest measurement
+    const std::vector<float>& getHistory() const { return m_History; }
+
+private:
+    uint32_t           m_NumIterations {0};
+    std::vector<float> m_History;
+};
\ No newline at end of file
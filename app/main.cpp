@@ -18,21 +18,50 @@
 #include "passes/final_composition_pass.hpp"
 #include "passes/fxaa_pass.hpp"
 #include "passes/gaussian_blur_pass.hpp"
+#include "passes/baked_lpv_pass.hpp"
 #include "passes/gbuffer_pass.hpp"
 #include "passes/hbao_pass.hpp"
+#include "passes/lpv_cache_pass.hpp"
 #include "passes/radiance_injection_pass.hpp"
 #include "passes/radiance_propagation_pass.hpp"
 #include "passes/reflective_shadow_map_pass.hpp"
 #include "passes/ssr_pass.hpp"
 #include "passes/tonemapping_pass.hpp"
 
+#include "asset_loader.hpp"
 #include "grid3d.hpp"
 #include "lpv_config.hpp"
+#include "lpv_convergence.hpp"
+#include "occlusion_culler.hpp"
 #include "render_settings.hpp"
+#include "scene_draw_stream.hpp"
+#include "startup_timeline.hpp"
+#include "uniform_ring.hpp"
 
-int main()
+#include <cstdio>
+#include <string_view>
+
+int main(int argc, char** argv)
 try
 {
+    StartupTimeline startupTimeline;
+
+    // --blocking-compile links every program before the first frame and --blocking-load has vgfw decode and upload
+    // every image of the model before it, to compare the startup with the default. --uncompressed-textures streams the
+    // images in RGBA8, to compare the memory and the GBuffer time with the block compressed textures.
+    auto compileMode        = ProgramCache::CompileMode::eParallel;
+    auto loadMode           = AssetLoader::LoadMode::eStreaming;
+    auto textureCompression = AssetLoader::TextureCompression::eBlockCompressed;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string_view {argv[i]} == "--blocking-compile")
+            compileMode = ProgramCache::CompileMode::eBlocking;
+        else if (std::string_view {argv[i]} == "--blocking-load")
+            loadMode = AssetLoader::LoadMode::eBlocking;
+        else if (std::string_view {argv[i]} == "--uncompressed-textures")
+            textureCompression = AssetLoader::TextureCompression::eNone;
+    }
+
     // Init VGFW
     if (!vgfw::init())
     {
@@ -49,15 +78,38 @@ try
     // Get render context
     auto& rc = vgfw::renderer::getRenderContext();
 
+    startupTimeline.mark("GL context");
+
+    // Programs are shared by the passes, and linked from the binaries of a previous launch when they are still valid.
+    // The others are compiled in the background, the passes wait for them before they join the frames.
+    getProgramCache().init("shader_cache", compileMode);
+
     // Create transient resources
     vgfw::renderer::framegraph::TransientResources transientResources(rc);
 
-    // Load model
+    // Load model, its images are decoded on a thread pool and uploaded over the first frames
+    constexpr auto        kSponzaPath = "assets/models/Sponza/glTF/Sponza.gltf";
+    AssetLoader           assetLoader(loadMode, textureCompression);
     vgfw::resource::Model sponza {};
-    if (!vgfw::io::loadModel("assets/models/Sponza/glTF/Sponza.gltf", sponza, rc, glm::vec3(0.035f)))
+    if (!assetLoader.load(kSponzaPath, sponza, rc, glm::vec3(0.035f)))
     {
         return -1;
     }
+    if (assetLoader.isDone())
+    {
+        startupTimeline.mark("Textures loaded");
+    }
+
+    // Merged geometry and per draw data of the scene, the geometry passes multi-draw it
+    SceneDrawStream sceneDrawStream(rc, sponza.meshPrimitives);
+
+    // The materials sample neutral textures until the images of their placeholders are uploaded
+    sceneDrawStream.remapTextures(std::bind_front(&AssetLoader::getTexture, &assetLoader));
+
+    // Two-phase Hi-Z occlusion culling of the GBuffer draws
+    OcclusionCuller occlusionCuller(rc, sceneDrawStream);
+
+    startupTimeline.mark("Scene loaded");
 
     DirectionalLight light {};
     light.direction = {0.000, -0.984, 0.177};
@@ -74,28 +126,66 @@ try
 
     vgfw::time::TimePoint lastTime = vgfw::time::Clock::now();
 
+    // Per frame uniform blocks of the passes
+    UniformRing uniformRing;
+    uniformRing.create(64 * 1024);
+
     // Define render passes
-    CascadedShadowMapPass   csmPass(rc);
-    ReflectiveShadowMapPass rsmPass(rc);
-    RadianceInjectionPass   radianceInjectionPass(rc);
-    RadiancePropagationPass radiancePropagationPass(rc);
-    GBufferPass             gBufferPass(rc);
-    HbaoPass                hbaoPass(rc);
+    CascadedShadowMapPass   csmPass(rc, uniformRing);
+    ReflectiveShadowMapPass rsmPass(rc, uniformRing);
+    RadianceInjectionPass   radianceInjectionPass(rc, uniformRing);
+    RadiancePropagationPass radiancePropagationPass(rc, uniformRing);
+    LpvCachePass            lpvCachePass(rc);
+    BakedLpvPass            bakedLpvPass(rc);
+    GBufferPass             gBufferPass(rc, uniformRing);
+    HbaoPass                hbaoPass(rc, uniformRing);
     GaussianBlurPass        gaussianBlurPass(rc);
-    DeferredLightingPass    deferredLightingPass(rc);
+    DeferredLightingPass    deferredLightingPass(rc, uniformRing);
     BloomPass               bloomPass(rc);
-    SsrPass                 ssrPass(rc);
+    SsrPass                 ssrPass(rc, uniformRing);
     BlitPass                blitPass(rc);
     TonemappingPass         tonemappingPass(rc);
     FxaaPass                fxaaPass(rc);
     FinalCompositionPass    finalCompositionPass(rc);
 
-    // Get scene grid
-    Grid3D sceneGrid {sponza.aabb};
+    startupTimeline.mark("Passes created");
+
+    // Passes every frame needs, the frames only show the progress of the compilation until their programs are linked.
+    // The optional ones (HBAO, bloom, SSR, FXAA, occlusion culling and the fused propagation) join once theirs are.
+    const std::array<const BasePass*, 9> requiredPasses {&csmPass,
+                                                         &rsmPass,
+                                                         &radianceInjectionPass,
+                                                         &radiancePropagationPass,
+                                                         &lpvCachePass,
+                                                         &gBufferPass,
+                                                         &deferredLightingPass,
+                                                         &tonemappingPass,
+                                                         &finalCompositionPass};
+    bool                                 isSceneReady = false;
 
     // Render settings
     RenderSettings settings {};
 
+    // Get scene grid, rebuilt when the LPV resolution changes
+    Grid3D sceneGrid {sponza.aabb, settings.lpvResolution};
+
+    // Bumped whenever the (otherwise static) scene changes, invalidates the LPV cache
+    uint64_t sceneRevision = 0;
+
+    // Static lighting baked by a previous run skips the whole LPV pipeline from the first frame, as long as it was
+    // baked with the same light and scene
+    constexpr auto kBakedLPVPath  = "lpv_baked.lpvb";
+    const auto     bakedLPVScene  = BakedLpvPass::computeSceneHash(kSponzaPath, sponza);
+    bool           exportBakedLPV = false;
+    settings.enableBakedLPV =
+        bakedLpvPass.load(kBakedLPVPath) && bakedLpvPass.isMatching(BakedLpvPass::makeLighting(light, bakedLPVScene));
+
+    // Iteration count of the adaptive propagation, fed by energy deltas read back from previous frames
+    LpvConvergence     lpvConvergence;
+    std::vector<float> lpvEnergyDeltas;
+
+    bool isStartupPrinted = false;
+
     // Main loop
     while (!window->shouldClose())
     {
@@ -111,50 +201,231 @@ try
 
         camera.update(window, dt);
 
+        // Images decoded since the last frame
+        if (assetLoader.update())
+        {
+            sceneDrawStream.remapTextures(std::bind_front(&AssetLoader::getTexture, &assetLoader));
+        }
+
+        if (!isSceneReady)
+        {
+            isSceneReady = std::ranges::all_of(requiredPasses, [](const BasePass* pass) { return pass->isReady(); });
+        }
+        if (!isSceneReady)
+        {
+            VGFW_PROFILE_NAMED_SCOPE("Wait for Programs");
+
+            vgfw::renderer::beginFrame();
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, window->getWidth(), window->getHeight());
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            const auto* viewport = ImGui::GetMainViewport();
+            ImGui::SetNextWindowPos(viewport->GetCenter(), ImGuiCond_Always, {0.5f, 0.5f});
+            if (ImGui::Begin("CompilationProgress",
+                             nullptr,
+                             ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                                 ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoNav))
+            {
+                ImGui::Text("Compiling programs (%s): %u left",
+                            getProgramCache().getCompileModeName(),
+                            getProgramCache().getStats().numPending);
+            }
+            ImGui::End();
+
+            vgfw::renderer::endFrame();
+
+            vgfw::renderer::present();
+
+            startupTimeline.mark("First frame");
+
+            VGFW_PROFILE_END_OF_FRAME
+            continue;
+        }
+
+        // The optional passes are left out until their programs are linked
+        auto frameSettings        = settings;
+        frameSettings.enableHBAO  = settings.enableHBAO && hbaoPass.isReady() && gaussianBlurPass.isReady();
+        frameSettings.enableBloom = settings.enableBloom && bloomPass.isReady() && gaussianBlurPass.isReady();
+        frameSettings.enableSSR   = settings.enableSSR && ssrPass.isReady() && blitPass.isReady();
+        frameSettings.enableFXAA  = settings.enableFXAA && fxaaPass.isReady();
+        const bool isOcclusionCulling = settings.cullingMode == CullingMode::eOcclusion && occlusionCuller.isReady();
+
         FrameGraph           fg;
         FrameGraphBlackboard blackboard;
 
-        uploadCameraUniform(fg, blackboard, camera.data);
-        uploadLightUniform(fg, blackboard, light);
+        uniformRing.beginFrame();
+        sceneDrawStream.setSortingEnabled(settings.enableDrawSorting);
+        sceneDrawStream.setFrustumCullingEnabled(settings.cullingMode != CullingMode::eNone);
+
+        uploadCameraUniform(blackboard, uniformRing, camera.data);
+        uploadLightUniform(blackboard, uniformRing, light);
 
         // Build Shadow map cascades
-        csmPass.addToGraph(fg, blackboard, camera, light, sponza.meshPrimitives);
-
-        // Build RSM cascade
-        auto rsmCascade = vgfw::renderer::shadow::buildCascades(camera.zNear,
-                                                                camera.zFar,
-                                                                camera.data.projection * camera.data.view,
-                                                                light.direction,
-                                                                1,
-                                                                1,
-                                                                kRSMResolution);
-        auto rsmLightVP = rsmCascade[0].viewProjection;
-
-        // RSM pass
-        rsmPass.addToGraph(fg, blackboard, rsmLightVP, sponza.meshPrimitives);
-
-        // Radiance Injection Pass
-        auto rsmData      = blackboard.get<ReflectiveShadowMapData>();
-        auto radianceData = radianceInjectionPass.addToGraph(fg, rsmData, sceneGrid);
-
-        // Radiance Propagation Pass
-        std::optional<RadianceData> propagatedRadiance;
-        for (auto i = 0; i < settings.lpvIteration; ++i)
-            propagatedRadiance = radiancePropagationPass.addToGraph(
-                fg, propagatedRadiance ? *propagatedRadiance : radianceData, sceneGrid, i);
-        blackboard.add<RadianceData>(propagatedRadiance ? *propagatedRadiance : radianceData);
+        csmPass.addToGraph(fg, blackboard, camera, light, sceneDrawStream);
+
+        // LPV grids, either the static scene grid, the grid of the baked volume or nested cascades following the
+        // camera
+        const auto bakedLighting = BakedLpvPass::makeLighting(light, bakedLPVScene);
+        const bool isBakedLPV    = settings.enableBakedLPV && bakedLpvPass.isMatching(bakedLighting);
+        const bool isCascadedLPV = !isBakedLPV && settings.lpvNumCascades > 1;
+        const auto lpvGrids =
+            isCascadedLPV ?
+                buildLPVCascades(camera.data.position,
+                                 settings.lpvCascadeCellSize,
+                                 settings.lpvNumCascades,
+                                 settings.lpvResolution) :
+                std::vector<Grid3D> {isBakedLPV ? bakedLpvPass.getGrid() : sceneGrid};
+
+        // Fit the RSM to the (coarsest) LPV grid rather than to the camera frustum, so that camera motion alone keeps
+        // the static LPV valid
+        const auto rsmLightVP = lpvGrids.back().fitLightViewProjection(light.direction);
+
+        // Adaptive iterations only apply to the within-frame compute propagation of a single grid
+        const bool isAdaptiveLPV = settings.enableAdaptiveLPVIterations && !isBakedLPV && !isCascadedLPV &&
+                                   settings.lpvPropagationMode == PropagationMode::eCompute;
+        int        lpvIteration  = settings.lpvIteration;
+        if (isAdaptiveLPV)
+        {
+            if (radiancePropagationPass.fetchEnergyDeltas(lpvEnergyDeltas))
+            {
+                lpvConvergence.update(lpvEnergyDeltas,
+                                      static_cast<uint32_t>(settings.lpvMinIterations),
+                                      static_cast<uint32_t>(settings.lpvMaxIterations),
+                                      settings.lpvConvergenceThreshold);
+            }
+
+            // Start from the maximum until the first measurement arrives
+            const auto numIterations = lpvConvergence.getNumIterations();
+            lpvIteration = numIterations > 0 ? static_cast<int>(numIterations) : settings.lpvMaxIterations;
+        }
+
+        // The amortized mode keeps converging over frames and the cascades move with the camera, both bypass the
+        // cache. Cascades are propagated within the frame.
+        const auto lpvPropagationMode = isCascadedLPV && settings.lpvPropagationMode == PropagationMode::eAmortized ?
+                                            PropagationMode::eCompute :
+                                            settings.lpvPropagationMode;
+        const bool isAmortizedLPV = lpvPropagationMode == PropagationMode::eAmortized;
+
+        // Only compute writes packed volumes, the raster injection, the geometry shader propagation and the baked
+        // format stay RGBA16F
+        const bool isPackableLPV = settings.lpvInjectionMode != InjectionMode::eRaster &&
+                                   lpvPropagationMode != PropagationMode::eGeometryShader && !exportBakedLPV;
+        const auto lpvSHEncoding = isPackableLPV ? settings.lpvSHEncoding : SHEncoding::eRGBA16F;
+
+        const auto lpvCacheKey = LpvCacheKey::make(light,
+                                                   sceneGrid,
+                                                   settings.rsmResolution,
+                                                   settings.lpvInjectionMode,
+                                                   lpvIteration,
+                                                   settings.lpvPropagationMode,
+                                                   lpvSHEncoding,
+                                                   sceneRevision);
+        const bool lpvCacheHit = !isBakedLPV && settings.enableLPVCache && !isAmortizedLPV && !isCascadedLPV &&
+                                 lpvCachePass.lookup(lpvCacheKey);
+
+        // Only the first frame of an amortized propagation cycle consumes injected radiance
+        const bool needsInjection =
+            !isBakedLPV && !lpvCacheHit &&
+            (!isAmortizedLPV ||
+             radiancePropagationPass.isStartingCycle(sceneGrid, settings.lpvIteration, lpvSHEncoding));
+
+        // RSM pass, the RSM render targets still need it when the injection is skipped
+        const bool isRSMRenderTarget = settings.renderTarget == RenderTarget::eRSMPosition ||
+                                       settings.renderTarget == RenderTarget::eRSMNormal ||
+                                       settings.renderTarget == RenderTarget::eRSMFlux;
+        if (needsInjection || isRSMRenderTarget)
+        {
+            rsmPass.addToGraph(fg, blackboard, rsmLightVP, sceneDrawStream, settings.rsmResolution);
+        }
+
+        CascadedRadianceData radianceCascades;
+        int                  lpvNumTransients = 0;
+
+        if (isBakedLPV)
+        {
+            radianceCascades.cascades.push_back(bakedLpvPass.import(fg));
+        }
+        else if (lpvCacheHit)
+        {
+            // Reuse the volumes propagated by a previous frame
+            radianceCascades.cascades.push_back(lpvCachePass.import(fg));
+        }
+        else if (isAmortizedLPV)
+        {
+            // Radiance Injection Pass
+            std::optional<RadianceData> radianceData;
+            if (needsInjection)
+            {
+                radianceData = radianceInjectionPass.addToGraph(fg,
+                                                                blackboard.get<ReflectiveShadowMapData>(),
+                                                                sceneGrid,
+                                                                settings.lpvInjectionMode,
+                                                                lpvSHEncoding);
+            }
+
+            // Radiance Propagation Pass, sliced over several frames
+            radianceCascades.cascades.push_back(radiancePropagationPass.addAmortizedToGraph(
+                fg, radianceData, sceneGrid, settings.lpvIteration, settings.lpvIterationsPerFrame));
+        }
+        else
+        {
+            // Every cascade is injected from the same RSM and propagated on its own
+            const auto rsmData            = blackboard.get<ReflectiveShadowMapData>();
+            const auto propagationOptions = PropagationOptions {
+                .useBrickMask    = settings.enableLPVBrickMask,
+                .measureEnergy   = isAdaptiveLPV,
+                .fusedIterations = static_cast<uint32_t>(settings.lpvFusedIterations),
+            };
+            for (uint32_t i = 0; i < lpvGrids.size(); ++i)
+            {
+                const auto numIterations = isCascadedLPV ? settings.lpvCascadeIterations[i] : lpvIteration;
+
+                // Radiance Injection Pass
+                auto radianceData = radianceInjectionPass.addToGraph(
+                    fg, rsmData, lpvGrids[i], settings.lpvInjectionMode, lpvSHEncoding);
+
+                // Radiance Propagation Pass
+                auto propagatedRadiance = radiancePropagationPass.addToGraph(
+                    fg, radianceData, lpvGrids[i], numIterations, lpvPropagationMode, propagationOptions, i);
+
+                if (settings.enableLPVCache && !isCascadedLPV)
+                {
+                    propagatedRadiance = lpvCachePass.addToGraph(fg, propagatedRadiance, sceneGrid);
+                }
+                radianceCascades.cascades.push_back(propagatedRadiance);
+
+                if (lpvPropagationMode == PropagationMode::eGeometryShader)
+                {
+                    lpvNumTransients += numIterations;
+                }
+            }
+        }
+        blackboard.add<CascadedRadianceData>(radianceCascades);
+
+        // Bake the propagated radiance of the static scene grid
+        const bool isExportingBakedLPV = exportBakedLPV && !isBakedLPV && !isCascadedLPV;
+        if (isExportingBakedLPV)
+        {
+            bakedLpvPass.addExportToGraph(
+                fg, radianceCascades.cascades.front(), sceneGrid, bakedLighting, kBakedLPVPath);
+        }
+        exportBakedLPV = false;
 
         // GBuffer pass
         gBufferPass.addToGraph(fg,
                                blackboard,
                                {.width = window->getWidth(), .height = window->getHeight()},
                                camera,
-                               sponza.meshPrimitives);
+                               sceneDrawStream,
+                               isOcclusionCulling ? &occlusionCuller : nullptr);
 
-        if (settings.enableHBAO)
+        if (frameSettings.enableHBAO)
         {
             // HBAO pass
-            hbaoPass.addToGraph(fg, blackboard, settings.hbaoProperties);
+            hbaoPass.addToGraph(fg, blackboard, settings.hbaoProperties, settings.enableShaderPermutations);
 
             // 2-pass Gaussian blur
             auto& hbao = blackboard.get<HBAOData>().hbao;
@@ -162,10 +433,10 @@ try
         }
 
         // Deferred Lighting pass
-        deferredLightingPass.addToGraph(fg, blackboard, rsmLightVP, sceneGrid, settings);
+        deferredLightingPass.addToGraph(fg, blackboard, rsmLightVP, lpvGrids, frameSettings);
         auto& sceneColor = blackboard.get<SceneColorData>();
 
-        if (settings.enableBloom)
+        if (frameSettings.enableBloom)
         {
             // Blur bright
             sceneColor.bright = gaussianBlurPass.addToGraph(fg, sceneColor.bright, 1.0f);
@@ -174,7 +445,7 @@ try
             sceneColor.hdr = bloomPass.addToGraph(fg, sceneColor.hdr, sceneColor.bright, settings.bloomFactor);
         }
 
-        if (settings.enableSSR)
+        if (frameSettings.enableSSR)
         {
             // SSR pass
             const auto ssr = ssrPass.addToGraph(fg, blackboard, settings);
@@ -185,14 +456,14 @@ try
         // Tone-mapping pass
         sceneColor.ldr = tonemappingPass.addToGraph(fg, sceneColor.hdr);
 
-        if (settings.enableFXAA)
+        if (frameSettings.enableFXAA)
         {
             // FXAA pass
             sceneColor.aa = fxaaPass.addToGraph(fg, sceneColor.ldr);
         }
 
         // Final composition pass
-        finalCompositionPass.compose(fg, blackboard, settings);
+        finalCompositionPass.compose(fg, blackboard, frameSettings);
 
         {
             VGFW_PROFILE_NAMED_SCOPE("Compile FrameGraph");
@@ -206,6 +477,8 @@ try
             fg.execute(&rc, &transientResources);
         }
 
+        uniformRing.endFrame();
+
 #ifndef NDEBUG
         {
             VGFW_PROFILE_NAMED_SCOPE("Export FrameGraph");
@@ -216,6 +489,11 @@ try
 
         transientResources.update(dt);
 
+        if (isExportingBakedLPV)
+        {
+            bakedLpvPass.load(kBakedLPVPath);
+        }
+
         {
             VGFW_PROFILE_NAMED_SCOPE("ImGui");
             const auto windowFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
@@ -231,6 +509,119 @@ try
             {
                 const auto frameRate = ImGui::GetIO().Framerate;
                 ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / frameRate, frameRate);
+
+                // Every propagation volume holds 3 RGBA16F textures, all the LPV grids have the same cell count
+                const auto& lpvGridSize = lpvGrids.front().size;
+                const auto  volumeMiB   = lpvGridSize.x * lpvGridSize.y * lpvGridSize.z * 3 * 8 / (1024.0f * 1024.0f);
+                ImGui::Text("LPV propagation: %d transient volumes (%.2f MiB)",
+                            lpvNumTransients,
+                            lpvNumTransients * volumeMiB);
+                if (isAmortizedLPV)
+                {
+                    ImGui::Text("LPV amortized propagation: %u / %d iterations",
+                                radiancePropagationPass.getCycleProgress(),
+                                settings.lpvIteration);
+                }
+                if (isAdaptiveLPV)
+                {
+                    ImGui::Text("LPV adaptive propagation: %d iterations", lpvIteration);
+                }
+                ImGui::Text("LPV cache: %llu hits / %llu misses",
+                            static_cast<unsigned long long>(lpvCachePass.getNumHits()),
+                            static_cast<unsigned long long>(lpvCachePass.getNumMisses()));
+
+                // Every primitive used to be a draw call of its own in each geometry pass
+                ImGui::Text("Scene: %u draws in %u multi-draws per pass (%s materials)",
+                            sceneDrawStream.getNumDraws(),
+                            sceneDrawStream.getNumMultiDraws(true),
+                            hasBindlessMaterials() ? "bindless" : "bound");
+                ImGui::Text("Scene submission: GBuffer %.3f ms, CSM %.3f ms, RSM %.3f ms",
+                            gBufferPass.getSubmissionMilliseconds(),
+                            csmPass.getSubmissionMilliseconds(),
+                            rsmPass.getSubmissionMilliseconds());
+
+                // Pipeline, vertex buffer and material binds of the views, and the redundant ones skipped
+                const auto showBindStats = [](const char* name, const StateTracker::Stats& stats) {
+                    const auto [pipelines, vertexBuffers, materials] = stats.numBinds;
+                    const auto numSkipped = stats.numSkipped[0] + stats.numSkipped[1] + stats.numSkipped[2];
+                    ImGui::Text("%s binds: %u pipelines, %u vertex buffers, %u materials (%u skipped)",
+                                name,
+                                pipelines,
+                                vertexBuffers,
+                                materials,
+                                numSkipped);
+                };
+                showBindStats("GBuffer", gBufferPass.getBindStats());
+                showBindStats("CSM", csmPass.getBindStats());
+                showBindStats("RSM", rsmPass.getBindStats());
+
+                // Visible draws of every view, frustum culled on the CPU
+                ImGui::Text("Scene culling: GBuffer %.3f ms, CSM %.3f ms, RSM %.3f ms (%s)",
+                            gBufferPass.getCullingMilliseconds(),
+                            csmPass.getCullingMilliseconds(),
+                            rsmPass.getCullingMilliseconds(),
+                            lpv_cpu::toString(sceneDrawStream.getCullingIsa()));
+                ImGui::Text("Visible draws: GBuffer %u / %u, RSM %u / %u",
+                            gBufferPass.getViews().front().getNumVisible(),
+                            sceneDrawStream.getNumDraws(),
+                            rsmPass.getViews().front().getNumVisible(),
+                            sceneDrawStream.getNumDraws());
+                for (uint32_t i = 0; i < csmPass.getViews().size(); ++i)
+                    ImGui::Text("Visible draws: CSM #%u %u / %u",
+                                i,
+                                csmPass.getViews()[i].getNumVisible(),
+                                sceneDrawStream.getNumDraws());
+
+                // Draws of the two occlusion culling phases out of the frustum culled ones, read back a few frames late
+                if (settings.cullingMode == CullingMode::eOcclusion)
+                {
+                    const auto& occlusionStats = occlusionCuller.getStats();
+                    ImGui::Text("Occlusion culling: GBuffer %u early + %u late / %u",
+                                occlusionStats.numEarly,
+                                occlusionStats.numLate,
+                                gBufferPass.getViews().front().getNumVisible());
+                }
+                ImGui::Text("GBuffer GPU: %.3f ms", gBufferPass.getGpuMilliseconds());
+
+                // Specialized variants against the generic ones, toggled by "Shader Permutations"
+                ImGui::Text("Deferred lighting GPU: %.3f ms, HBAO GPU: %.3f ms (%u + %u variants)",
+                            deferredLightingPass.getGpuMilliseconds(),
+                            hbaoPass.getGpuMilliseconds(),
+                            deferredLightingPass.getNumVariants(),
+                            hbaoPass.getNumVariants());
+
+                // Linked programs, a program used by several passes or vertex formats is only built once
+                const auto& programStats = getProgramCache().getStats();
+                ImGui::Text("Programs: %u compiled, %u loaded, %u shared, %u linking (%s, %.1f ms)",
+                            programStats.numCompiled,
+                            programStats.numLoaded,
+                            programStats.numShared,
+                            programStats.numPending,
+                            getProgramCache().getCompileModeName(),
+                            programStats.milliseconds);
+
+                // Streamed images of the model, the parse is vgfw::io::loadModel with the placeholders
+                const auto& assetStats = assetLoader.getStats();
+                ImGui::Text("Assets: %u / %u images uploaded (%s), parse %.1f ms, decode %.1f ms, upload %.1f ms",
+                            assetStats.numUploaded,
+                            assetStats.numImages,
+                            assetLoader.getLoadModeName(),
+                            assetStats.parseMilliseconds,
+                            assetStats.decodeWallMilliseconds,
+                            assetStats.uploadMilliseconds);
+                ImGui::Text("Textures: %.1f MiB in VRAM (%s), %.1f MiB in RGBA8, %u cached",
+                            assetStats.numTextureBytes / (1024.0 * 1024.0),
+                            assetLoader.getTextureCompressionName(),
+                            assetStats.numRGBA8Bytes / (1024.0 * 1024.0),
+                            assetStats.numCached);
+
+                // Every block used to be set with a glUniform* call per member, see README
+                const auto& uniformStats = uniformRing.getLastFrameStats();
+                ImGui::Text("Uniforms: %u blocks (%.1f KiB), %u GL calls (%u with the setters)",
+                            uniformStats.numBlocks,
+                            uniformStats.numBytes / 1024.0f,
+                            uniformStats.numGLCalls,
+                            uniformStats.numSetterCalls);
             }
             ImGui::End();
 
@@ -270,7 +661,191 @@ try
                 ImGui::DragFloat("Bloom Factor", &settings.bloomFactor, 0.001f, 0.0f, 5.0f);
             }
 
-            ImGui::SliderInt("LPV Iteration", &settings.lpvIteration, 0, 200);
+            ImGui::Checkbox("Shader Permutations", &settings.enableShaderPermutations);
+
+            ImGui::Checkbox("Sort Scene Draws", &settings.enableDrawSorting);
+
+            const char* cullingModeItems[] = {
+                "None",
+                "Frustum (CPU)",
+                "Frustum + Hi-Z Occlusion (GPU)",
+            };
+
+            int currentCullingMode = static_cast<int>(settings.cullingMode);
+
+            if (ImGui::Combo("Scene Culling", &currentCullingMode, cullingModeItems, IM_ARRAYSIZE(cullingModeItems)))
+            {
+                settings.cullingMode = static_cast<CullingMode>(currentCullingMode);
+            }
+
+            const char* rsmResolutionItems[] = {
+                "256",
+                "512",
+                "1024",
+                "2048",
+            };
+            static_assert(IM_ARRAYSIZE(rsmResolutionItems) == kRSMResolutions.size());
+
+            int currentRSMResolution = static_cast<int>(
+                std::ranges::find(kRSMResolutions, settings.rsmResolution) - kRSMResolutions.begin());
+
+            if (ImGui::Combo("RSM Resolution",
+                             &currentRSMResolution,
+                             rsmResolutionItems,
+                             IM_ARRAYSIZE(rsmResolutionItems)))
+            {
+                settings.rsmResolution = kRSMResolutions[currentRSMResolution];
+            }
+
+            const char* lpvResolutionItems[] = {
+                "16",
+                "32",
+                "64",
+                "128",
+            };
+            static_assert(IM_ARRAYSIZE(lpvResolutionItems) == kLPVResolutions.size());
+
+            int currentLPVResolution = static_cast<int>(
+                std::ranges::find(kLPVResolutions, settings.lpvResolution) - kLPVResolutions.begin());
+
+            // The volumes of every pass follow the grid size, the transient ones of the old size expire unused
+            if (ImGui::Combo("LPV Resolution",
+                             &currentLPVResolution,
+                             lpvResolutionItems,
+                             IM_ARRAYSIZE(lpvResolutionItems)))
+            {
+                settings.lpvResolution = kLPVResolutions[currentLPVResolution];
+                sceneGrid              = Grid3D {sponza.aabb, settings.lpvResolution};
+            }
+
+            const char* injectionModeItems[] = {
+                "Raster",
+                "Clustered",
+                "Compute",
+            };
+
+            int currentInjectionMode = static_cast<int>(settings.lpvInjectionMode);
+
+            if (ImGui::Combo("LPV Injection Mode",
+                             &currentInjectionMode,
+                             injectionModeItems,
+                             IM_ARRAYSIZE(injectionModeItems)))
+            {
+                settings.lpvInjectionMode = static_cast<InjectionMode>(currentInjectionMode);
+            }
+
+            const char* shEncodingItems[] = {
+                "RGBA16F (24 B/cell)",
+                "Shared Exponent (16 B/cell)",
+            };
+
+            int currentSHEncoding = static_cast<int>(settings.lpvSHEncoding);
+
+            // Raster injection and geometry shader propagation only write RGBA16F volumes
+            if (ImGui::Combo("LPV SH Encoding", &currentSHEncoding, shEncodingItems, IM_ARRAYSIZE(shEncodingItems)))
+            {
+                settings.lpvSHEncoding = static_cast<SHEncoding>(currentSHEncoding);
+            }
+
+            ImGui::SliderInt("LPV Cascades", &settings.lpvNumCascades, 1, kMaxLPVCascades);
+
+            if (settings.lpvNumCascades > 1)
+            {
+                ImGui::DragFloat("LPV Cascade Cell Size", &settings.lpvCascadeCellSize, 0.05f, 0.05f, 100.0f);
+                for (auto i = 0; i < settings.lpvNumCascades; ++i)
+                {
+                    ImGui::SliderInt(fmt::format("LPV Cascade #{0} Iteration", i).c_str(),
+                                     &settings.lpvCascadeIterations[i],
+                                     0,
+                                     200);
+                }
+            }
+            else
+            {
+                ImGui::SliderInt("LPV Iteration", &settings.lpvIteration, 0, 200);
+            }
+
+            const char* propagationModeItems[] = {
+                "GeometryShader",
+                "Compute",
+                "Amortized",
+            };
+
+            int currentPropagationMode = static_cast<int>(settings.lpvPropagationMode);
+
+            if (ImGui::Combo("LPV Propagation Mode",
+                             &currentPropagationMode,
+                             propagationModeItems,
+                             IM_ARRAYSIZE(propagationModeItems)))
+            {
+                settings.lpvPropagationMode = static_cast<PropagationMode>(currentPropagationMode);
+            }
+
+            if (settings.lpvPropagationMode == PropagationMode::eAmortized)
+            {
+                ImGui::SliderInt("LPV Iterations Per Frame", &settings.lpvIterationsPerFrame, 1, 200);
+            }
+
+            if (settings.lpvPropagationMode == PropagationMode::eCompute)
+            {
+                ImGui::Checkbox("Enable LPV Brick Mask", &settings.enableLPVBrickMask);
+                ImGui::SliderInt("LPV Fused Iterations",
+                                 &settings.lpvFusedIterations,
+                                 1,
+                                 static_cast<int>(radiancePropagationPass.getMaxFusedIterations()));
+
+                if (settings.lpvNumCascades == 1)
+                {
+                    ImGui::Checkbox("Enable Adaptive LPV Iterations", &settings.enableAdaptiveLPVIterations);
+                }
+
+                if (settings.enableAdaptiveLPVIterations && settings.lpvNumCascades == 1)
+                {
+                    ImGui::SliderFloat("LPV Convergence Threshold",
+                                       &settings.lpvConvergenceThreshold,
+                                       0.0001f,
+                                       0.1f,
+                                       "%.4f",
+                                       ImGuiSliderFlags_Logarithmic);
+                    ImGui::SliderInt("LPV Min Iterations", &settings.lpvMinIterations, 1, settings.lpvMaxIterations);
+                    ImGui::SliderInt("LPV Max Iterations",
+                                     &settings.lpvMaxIterations,
+                                     settings.lpvMinIterations,
+                                     static_cast<int>(kMaxLPVIterations));
+
+                    const auto& history = lpvConvergence.getHistory();
+                    ImGui::PlotLines("LPV Energy Deltas",
+                                     history.data(),
+                                     static_cast<int>(history.size()),
+                                     0,
+                                     nullptr,
+                                     0.0f,
+                                     FLT_MAX,
+                                     ImVec2(0.0f, 60.0f));
+                }
+            }
+
+            ImGui::Checkbox("Enable LPV Cache", &settings.enableLPVCache);
+
+            if (ImGui::Button("Invalidate LPV Cache"))
+            {
+                ++sceneRevision;
+            }
+
+            if (bakedLpvPass.isLoaded())
+            {
+                ImGui::Checkbox("Use Baked LPV", &settings.enableBakedLPV);
+                if (!bakedLpvPass.isMatching(BakedLpvPass::makeLighting(light, bakedLPVScene)))
+                {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("(stale, baked with another light or scene)");
+                }
+            }
+
+            if (ImGui::Button("Export Baked LPV"))
+            {
+                exportBakedLPV = true;
+            }
 
             const char* visualModeItems[] = {
                 "Default",
@@ -313,10 +888,65 @@ try
 
         vgfw::renderer::present();
 
+        // Cold startup compiles every program, a warm one loads them from the binary cache. The images of the model
+        // stream in meanwhile.
+        startupTimeline.mark("First frame");
+        startupTimeline.mark("First scene frame");
+        if (!isStartupPrinted)
+        {
+            if (getProgramCache().isEveryProgramReady())
+                startupTimeline.mark("Programs linked");
+            if (assetLoader.isDone())
+                startupTimeline.mark("Textures loaded");
+        }
+        if (!isStartupPrinted && startupTimeline.hasMark("Programs linked") &&
+            startupTimeline.hasMark("Textures loaded"))
+        {
+            startupTimeline.print();
+
+            const auto& programStats = getProgramCache().getStats();
+            std::printf("Programs (%s): %u compiled, %u loaded, %u shared (%.1f ms on the main thread)\n",
+                        getProgramCache().getCompileModeName(),
+                        programStats.numCompiled,
+                        programStats.numLoaded,
+                        programStats.numShared,
+                        programStats.milliseconds);
+
+            // The decode overlaps the parse, and the upload the frames
+            const auto& assetStats = assetLoader.getStats();
+            std::printf("Assets (%s): %u images, parse %.1f ms, decode %.1f ms (%.1f ms on %u threads), upload %.1f ms "
+                        "in %u frames (%.1f MiB)\n",
+                        assetLoader.getLoadModeName(),
+                        assetStats.numImages,
+                        assetStats.parseMilliseconds,
+                        assetStats.decodeWallMilliseconds,
+                        assetStats.decodeMilliseconds,
+                        assetStats.numThreads,
+                        assetStats.uploadMilliseconds,
+                        assetStats.numFrames,
+                        assetStats.numBytes / (1024.0 * 1024.0));
+
+            // The GBuffer samples the same textures, the time of its pass on the overlay gives the bandwidth saved
+            if (assetStats.numRGBA8Bytes > 0)
+                std::printf("Textures (%s): %.1f MiB in VRAM, %.1f MiB in RGBA8 (%.0f%% saved), %u of %u cached, "
+                            "compress %.1f ms\n",
+                            assetLoader.getTextureCompressionName(),
+                            assetStats.numTextureBytes / (1024.0 * 1024.0),
+                            assetStats.numRGBA8Bytes / (1024.0 * 1024.0),
+                            100.0 - 100.0 * assetStats.numTextureBytes / assetStats.numRGBA8Bytes,
+                            assetStats.numCached,
+                            assetStats.numImages,
+                            assetStats.compressMilliseconds);
+            isStartupPrinted = true;
+        }
+
         VGFW_PROFILE_END_OF_FRAME
     }
 
     // Cleanup
+    uniformRing.destroy();
+    getProgramCache().destroy();
+
     vgfw::shutdown();
 
     return 0;
@@ -0,0 +1,165 @@
+#include "occlusion_culler.hpp"
+#include "program_cache.hpp"
+
+#include <bit>
+#include <numeric>
+
+namespace
+{
+    // Local sizes of hiz_build.comp and occlusion_culling.comp
+    constexpr uint32_t kHiZGroupSize     = 8;
+    constexpr uint32_t kCullingGroupSize = 64;
+
+    GLuint createBuffer(GLsizeiptr size, const void* data, GLbitfield flags = 0)
+    {
+        GLuint buffer = 0;
+        glCreateBuffers(1, &buffer);
+        glNamedBufferStorage(buffer, size, data, flags);
+        return buffer;
+    }
+} // namespace
+
+OcclusionCuller::OcclusionCuller(vgfw::renderer::RenderContext& rc, const SceneDrawStream& drawStream) :
+    m_RenderContext(rc), m_NumDraws(drawStream.getNumDraws())
+{
+    m_HiZProgram = getProgramCache().getComputeProgram(vgfw::utils::readFileAllText("shaders/hiz_build.comp"));
+    m_CullingProgram =
+        getProgramCache().getComputeProgram(vgfw::utils::readFileAllText("shaders/occlusion_culling.comp"));
+
+    const auto&            bounds = drawStream.getBounds();
+    std::vector<glm::vec4> corners;
+    corners.reserve(2 * m_NumDraws);
+    for (uint32_t i = 0; i < m_NumDraws; ++i)
+    {
+        corners.emplace_back(bounds.getMin(0)[i], bounds.getMin(1)[i], bounds.getMin(2)[i], 1.0f);
+        corners.emplace_back(bounds.getMax(0)[i], bounds.getMax(1)[i], bounds.getMax(2)[i], 1.0f);
+    }
+    m_BoundsBuffer = createBuffer(corners.size() * sizeof(glm::vec4), corners.data());
+
+    // Every draw counts as visible before the first frame, its early phase draws them all
+    const std::vector<GLuint> visibility(m_NumDraws, 1);
+    m_VisibilityBuffer = createBuffer(visibility.size() * sizeof(GLuint), visibility.data());
+
+    m_MultiDrawBuffer = createBuffer(m_NumDraws * sizeof(glm::uvec2), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    m_CountBuffer     = createBuffer(2 * m_NumDraws * sizeof(GLuint), nullptr);
+    for (auto& commandBuffer : m_CommandBuffers)
+        commandBuffer = createBuffer(m_NumDraws * sizeof(DrawElementsIndirectCommand), nullptr);
+
+    m_CountReadback.create(2 * m_NumDraws * sizeof(GLuint));
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    glDeleteTextures(1, &m_HiZ);
+    glDeleteBuffers(1, &m_BoundsBuffer);
+    glDeleteBuffers(1, &m_VisibilityBuffer);
+    glDeleteBuffers(1, &m_MultiDrawBuffer);
+    glDeleteBuffers(1, &m_CountBuffer);
+    glDeleteBuffers(static_cast<GLsizei>(m_CommandBuffers.size()), m_CommandBuffers.data());
+    m_CountReadback.destroy();
+}
+
+bool OcclusionCuller::isReady() const
+{
+    return getProgramCache().isReady(std::array {m_HiZProgram, m_CullingProgram});
+}
+
+void OcclusionCuller::cull(Phase phase, const SceneDrawStream::View& view, const glm::mat4& viewProjection)
+{
+    const auto phaseIndex  = static_cast<uint32_t>(phase);
+    const auto numCommands = view.getNumVisible();
+
+    if (phase == Phase::eEarly)
+    {
+        if (m_CountReadback.poll(m_Counts))
+        {
+            const auto* counts = reinterpret_cast<const GLuint*>(m_Counts.data());
+            m_Stats.numEarly   = std::accumulate(counts, counts + m_NumDraws, 0u);
+            m_Stats.numLate    = std::accumulate(counts + m_NumDraws, counts + 2 * m_NumDraws, 0u);
+        }
+
+        // The multi-draws count the commands they keep from zero in both phases
+        glClearNamedBufferData(m_CountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+        m_MultiDraws.clear();
+        const auto& multiDraws = view.getMultiDraws();
+        for (uint32_t i = 0; i < multiDraws.size(); ++i)
+            m_MultiDraws.insert(m_MultiDraws.end(), multiDraws[i].numCommands, {i, multiDraws[i].firstCommand});
+        if (!m_MultiDraws.empty())
+            glNamedBufferSubData(m_MultiDrawBuffer, 0, m_MultiDraws.size() * sizeof(glm::uvec2), m_MultiDraws.data());
+    }
+
+    if (numCommands > 0)
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, view.getCommandBuffer());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_MultiDrawBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_BoundsBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_VisibilityBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_CommandBuffers[phaseIndex]);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_CountBuffer);
+        glBindTextureUnit(0, m_HiZ);
+        glBindSampler(0, 0);
+
+        glProgramUniform1ui(m_CullingProgram, 0, numCommands);
+        glProgramUniform1ui(m_CullingProgram, 1, phaseIndex);
+        glProgramUniform1ui(m_CullingProgram, 2, phaseIndex * m_NumDraws);
+        glProgramUniformMatrix4fv(m_CullingProgram, 3, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        m_RenderContext.dispatch(m_CullingProgram, {(numCommands + kCullingGroupSize - 1) / kCullingGroupSize, 1, 1});
+
+        // The commands and counts are read by the multi-draws, the visibility by the next early phase
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    if (phase == Phase::eLate && m_CountReadback.canEnqueue())
+    {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        m_CountReadback.enqueue(m_CountBuffer, 2 * m_NumDraws * sizeof(GLuint));
+    }
+}
+
+void OcclusionCuller::buildHiZ(const vgfw::renderer::Texture& depth, const vgfw::renderer::Extent2D& extent)
+{
+    if (!m_HiZ || m_DepthExtent.width != extent.width || m_DepthExtent.height != extent.height)
+    {
+        // The previous power of two halves exactly at every level, the texels of level 0 cover up to 3x3 depth texels
+        m_DepthExtent  = extent;
+        m_HiZExtent    = {.width = std::bit_floor(extent.width), .height = std::bit_floor(extent.height)};
+        m_NumHiZLevels = static_cast<GLsizei>(std::bit_width(std::max(m_HiZExtent.width, m_HiZExtent.height)));
+
+        glDeleteTextures(1, &m_HiZ);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_HiZ);
+        glTextureStorage2D(m_HiZ,
+                           m_NumHiZLevels,
+                           GL_R32F,
+                           static_cast<GLsizei>(m_HiZExtent.width),
+                           static_cast<GLsizei>(m_HiZExtent.height));
+        glTextureParameteri(m_HiZ, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(m_HiZ, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    glBindSampler(0, 0);
+    for (GLsizei level = 0; level < m_NumHiZLevels; ++level)
+    {
+        // Level 0 reduces the depth buffer, the other levels the one above
+        glBindTextureUnit(0, level == 0 ? static_cast<GLuint>(depth) : m_HiZ);
+        glBindImageTexture(0, m_HiZ, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glProgramUniform1i(m_HiZProgram, 0, level == 0 ? 0 : level - 1);
+
+        const auto width  = std::max(m_HiZExtent.width >> level, 1u);
+        const auto height = std::max(m_HiZExtent.height >> level, 1u);
+        m_RenderContext.dispatch(
+            m_HiZProgram,
+            {(width + kHiZGroupSize - 1) / kHiZGroupSize, (height + kHiZGroupSize - 1) / kHiZGroupSize, 1});
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+}
+
+SceneDrawStream::IndirectCount OcclusionCuller::getIndirectCount(Phase phase) const
+{
+    const auto phaseIndex = static_cast<uint32_t>(phase);
+    return {
+        .commandBuffer = m_CommandBuffers[phaseIndex],
+        .countBuffer   = m_CountBuffer,
+        .firstCount    = phaseIndex * m_NumDraws,
+    };
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include "gpu_readback.hpp"
+#include "scene_draw_stream.hpp"
+
+// Two-phase occlusion culling of the frustum culled draws of a view on the GPU. The early phase draws what was visible
+// in the last frame, a max depth pyramid (Hi-Z) of that depth buffer then tests the bounds of every draw in the late
+// phase, which draws the ones that became visible and records the visibility for the next frame. Both phases compact
+// the commands of the view into an indirect buffer of their own, counted per multi-draw for
+// glMultiDrawElementsIndirectCount.
+class OcclusionCuller
+{
+public:
+    enum class Phase
+    {
+        eEarly = 0,
+        eLate,
+    };
+
+    OcclusionCuller(vgfw::renderer::RenderContext& rc, const SceneDrawStream& drawStream);
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller&)            = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    // Whether the programs are linked, the view stays frustum culled before (see ProgramCache)
+    bool isReady() const;
+
+    // Compacts the commands of the view kept by the phase, the late phase tests them against the Hi-Z built before
+    void cull(Phase phase, const SceneDrawStream::View& view, const glm::mat4& viewProjection);
+
+    // Hi-Z of the depth buffer the early phase drew, resized with it
+    void buildHiZ(const vgfw::renderer::Texture& depth, const vgfw::renderer::Extent2D& extent);
+
+    SceneDrawStream::IndirectCount getIndirectCount(Phase phase) const;
+
+    struct Stats
+    {
+        uint32_t numEarly {0}; // Draws of the phases
+        uint32_t numLate {0};
+    };
+
+    // Of a frame a few frames ago, read back without stalling
+    const Stats& getStats() const { return m_Stats; }
+
+private:
+    vgfw::renderer::RenderContext& m_RenderContext;
+
+    GLuint m_HiZProgram {0};
+    GLuint m_CullingProgram {0};
+
+    // R32F, the previous power of two of the depth buffer and its mip chain
+    GLuint                   m_HiZ {0};
+    vgfw::renderer::Extent2D m_DepthExtent {};
+    vgfw::renderer::Extent2D m_HiZExtent {};
+    GLsizei                  m_NumHiZLevels {0};
+
+    uint32_t m_NumDraws {0};
+    GLuint   m_BoundsBuffer {0};     // Min and max corners of every draw
+    GLuint   m_VisibilityBuffer {0}; // A uint per draw, visible in the late phase of the last frame
+    GLuint   m_MultiDrawBuffer {0};  // Multi-draw and its first command, per command of the view
+    GLuint   m_CountBuffer {0};      // Commands per multi-draw, m_NumDraws GLuints per phase
+
+    std::array<GLuint, 2> m_CommandBuffers {}; // Per phase
+
+    std::vector<glm::uvec2> m_MultiDraws;
+
+    GpuReadback            m_CountReadback;
+    std::vector<std::byte> m_Counts;
+    Stats                  m_Stats;
+};
\ No newline at end of file
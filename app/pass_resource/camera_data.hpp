@@ -1,8 +1,8 @@
 #pragma once
 
-#include <fg/Fwd.hpp>
+#include "uniform_ring.hpp"
 
 struct CameraData
 {
-    FrameGraphResource cameraUniform;
+    UniformAllocation cameraUniform;
 };
\ No newline at end of file
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <fg/Fwd.hpp>
+#include "uniform_ring.hpp"
 
 struct LightData
 {
-    FrameGraphResource lightUniform;
+    UniformAllocation lightUniform;
 };
\ No newline at end of file
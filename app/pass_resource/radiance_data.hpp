@@ -1,10 +1,29 @@
 #pragma once
 
+#include "sh_encoding.hpp"
+
 #include <fg/Fwd.hpp>
 
+#include <vector>
+
 struct RadianceData
 {
     FrameGraphResource r;
     FrameGraphResource g;
     FrameGraphResource b;
+    SHEncoding         encoding {SHEncoding::eRGBA16F};
+
+    // Textures holding the coefficients, r is the only one of a packed encoding
+    std::vector<FrameGraphResource> getVolumes() const
+    {
+        if (getNumSHVolumes(encoding) == 1)
+            return {r};
+        return {r, g, b};
+    }
+};
+
+// One RadianceData per LPV cascade, the first one is the finest
+struct CascadedRadianceData
+{
+    std::vector<RadianceData> cascades;
 };
\ No newline at end of file
@@ -8,4 +8,6 @@ struct ReflectiveShadowMapData
     FrameGraphResource normal;
     FrameGraphResource flux;
     FrameGraphResource depth;
+
+    uint32_t resolution {0};
 };
\ No newline at end of file
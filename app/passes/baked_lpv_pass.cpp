@@ -0,0 +1,140 @@
+#include "passes/baked_lpv_pass.hpp"
+
+namespace
+{
+    // 64-bit FNV-1a, like the program cache
+    constexpr uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        return hash;
+    }
+} // namespace
+
+BakedLpvPass::BakedLpvPass(vgfw::renderer::RenderContext& rc) : BasePass(rc) {}
+
+BakedLpvPass::~BakedLpvPass() { m_Volume.destroy(m_RenderContext); }
+
+uint64_t BakedLpvPass::computeSceneHash(std::string_view modelPath, const vgfw::resource::Model& model)
+{
+    const std::array<float, 6> bounds {
+        model.aabb.min.x, model.aabb.min.y, model.aabb.min.z, model.aabb.max.x, model.aabb.max.y, model.aabb.max.z};
+    const auto numPrimitives = static_cast<uint64_t>(model.meshPrimitives.size());
+
+    auto hash = hashBytes(kHashSeed, modelPath.data(), modelPath.size());
+    hash      = hashBytes(hash, bounds.data(), sizeof(bounds));
+    return hashBytes(hash, &numPrimitives, sizeof(numPrimitives));
+}
+
+lpv_cpu::BakedLighting BakedLpvPass::makeLighting(const DirectionalLight& light, uint64_t sceneHash)
+{
+    return {
+        .lightDirection = {light.direction.x, light.direction.y, light.direction.z},
+        .lightColor     = {light.color.r, light.color.g, light.color.b},
+        .lightIntensity = light.intensity,
+        .sceneHash      = sceneHash,
+    };
+}
+
+bool BakedLpvPass::load(const std::string& path)
+{
+    VGFW_PROFILE_FUNCTION
+
+    lpv_cpu::MappedBakedVolume baked;
+    if (!baked.open(path))
+        return false;
+
+    const auto& header = baked.getHeader();
+    const auto  size   = glm::uvec3 {header.size[0], header.size[1], header.size[2]};
+    m_Volume.resize(m_RenderContext, size);
+
+    // The payloads already are RGBA16F texels, the driver reads them from the mapped pages
+    const auto textures = {&m_Volume.r, &m_Volume.g, &m_Volume.b};
+    for (uint32_t color = 0; auto* texture : textures)
+    {
+        glTextureSubImage3D(static_cast<GLuint>(*texture),
+                            0,
+                            0,
+                            0,
+                            0,
+                            size.x,
+                            size.y,
+                            size.z,
+                            GL_RGBA,
+                            GL_HALF_FLOAT,
+                            baked.getPayload(color++));
+    }
+
+    const vgfw::math::AABB aabb {
+        glm::vec3 {header.aabbMin[0], header.aabbMin[1], header.aabbMin[2]},
+        glm::vec3 {header.aabbMax[0], header.aabbMax[1], header.aabbMax[2]},
+    };
+    m_Grid.emplace(aabb, size, header.cellSize);
+    m_Lighting = header.lighting;
+
+    return true;
+}
+
+RadianceData BakedLpvPass::import(FrameGraph& fg)
+{
+    assert(isLoaded());
+    return m_Volume.import(fg, "Baked LPV");
+}
+
+void BakedLpvPass::addExportToGraph(FrameGraph&                   fg,
+                                    const RadianceData&           radianceData,
+                                    const Grid3D&                 grid,
+                                    const lpv_cpu::BakedLighting& lighting,
+                                    const std::string&            path)
+{
+    VGFW_PROFILE_FUNCTION
+
+    // The baked format stores the RGBA16F volumes as is
+    assert(radianceData.encoding == SHEncoding::eRGBA16F);
+
+    fg.addCallbackPass(
+        "Export Baked LPV",
+        [&](FrameGraph::Builder& builder, auto&) {
+            builder.read(radianceData.r);
+            builder.read(radianceData.g);
+            builder.read(radianceData.b);
+            builder.setSideEffect();
+        },
+        [=](const auto&, FrameGraphPassResources& resources, void*) {
+            NAMED_DEBUG_MARKER("Export Baked LPV");
+            VGFW_PROFILE_GL("Export Baked LPV");
+            VGFW_PROFILE_NAMED_SCOPE("Export Baked LPV");
+
+            // The propagation may have written the volumes as images
+            glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+            const lpv_cpu::Grid cpuGrid {
+                .aabbMin  = {grid.aabb.min.x, grid.aabb.min.y, grid.aabb.min.z},
+                .size     = {grid.size.x, grid.size.y, grid.size.z},
+                .cellSize = grid.cellSize,
+            };
+            lpv_cpu::SHVolume volume(cpuGrid.size);
+
+            std::vector<uint16_t> texels(cpuGrid.getNumCells() * lpv_cpu::kNumSHCoeffs);
+            const auto            channels = {radianceData.r, radianceData.g, radianceData.b};
+            for (uint32_t color = 0; const auto channel : channels)
+            {
+                const auto& texture = vgfw::renderer::framegraph::getTexture(resources, channel);
+                glGetTextureImage(static_cast<GLuint>(texture),
+                                  0,
+                                  GL_RGBA,
+                                  GL_HALF_FLOAT,
+                                  static_cast<GLsizei>(texels.size() * sizeof(uint16_t)),
+                                  texels.data());
+                volume.importHalf(color++, texels.data());
+            }
+
+            if (!lpv_cpu::writeBakedVolume(path, cpuGrid, volume, lighting))
+            {
+                std::cerr << "Failed to write the baked LPV: " << path << std::endl;
+            }
+        });
+}
\ No newline at end of file
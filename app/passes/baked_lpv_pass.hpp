@@ -0,0 +1,46 @@
+#pragma once
+
+#include "base_pass.hpp"
+
+#include "grid3d.hpp"
+#include "light.hpp"
+#include "pass_resource/radiance_data.hpp"
+#include "radiance_volume.hpp"
+
+#include <lpv_cpu/baked_volume.hpp>
+
+// Propagated LPV baked to disk for static lighting, see lpv_cpu/baked_volume.hpp for the format
+class BakedLpvPass : public BasePass
+{
+public:
+    explicit BakedLpvPass(vgfw::renderer::RenderContext& rc);
+    ~BakedLpvPass();
+
+    // Hash of the model file and of its bounds and primitive count, a baked volume of another scene is stale
+    static uint64_t               computeSceneHash(std::string_view modelPath, const vgfw::resource::Model& model);
+    static lpv_cpu::BakedLighting makeLighting(const DirectionalLight& light, uint64_t sceneHash);
+
+    // Maps a baked volume and uploads it straight from the mapping, returns false if it is missing or invalid
+    bool load(const std::string& path);
+
+    bool          isLoaded() const { return m_Grid.has_value(); }
+    const Grid3D& getGrid() const { return *m_Grid; }
+
+    // Whether the loaded volume was baked with this light and scene
+    bool isMatching(const lpv_cpu::BakedLighting& lighting) const { return isLoaded() && m_Lighting == lighting; }
+
+    // Imports the loaded volumes
+    RadianceData import(FrameGraph& fg);
+
+    // Reads the propagated volumes back once they are computed and writes them in the baked format
+    void addExportToGraph(FrameGraph&                   fg,
+                          const RadianceData&           radianceData,
+                          const Grid3D&                 grid,
+                          const lpv_cpu::BakedLighting& lighting,
+                          const std::string&            path);
+
+private:
+    RadianceVolume         m_Volume;
+    std::optional<Grid3D>  m_Grid;
+    lpv_cpu::BakedLighting m_Lighting;
+};
\ No newline at end of file
@@ -1,18 +1,85 @@
 #include "passes/base_geometry_pass.hpp"
+#include "uniforms/pass_uniforms.hpp"
 
-BaseGeometryPass::BaseGeometryPass(vgfw::renderer::RenderContext& rc) : BasePass(rc) {}
+#include <algorithm>
+#include <chrono>
 
-BaseGeometryPass::~BaseGeometryPass()
+BaseGeometryPass::BaseGeometryPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing, uint32_t numViews) :
+    BasePass(rc), m_UniformRing(uniformRing), m_Views(numViews), m_BindStats(numViews)
+{}
+
+void BaseGeometryPass::drawScene(vgfw::renderer::RenderContext& rc,
+                                 const SceneDrawStream&         drawStream,
+                                 uint32_t                       viewIndex,
+                                 const glm::mat4&               viewProjection,
+                                 std::optional<uint32_t>        materialBinding)
+{
+    cullView(drawStream, viewIndex, viewProjection, materialBinding.has_value());
+    drawView(rc, drawStream, viewIndex, viewProjection, materialBinding);
+}
+
+void BaseGeometryPass::cullView(const SceneDrawStream& drawStream,
+                                uint32_t               viewIndex,
+                                const glm::mat4&       viewProjection,
+                                bool                   bindsMaterials)
+{
+    // Every frame culls its first view first, the views then add up their submission time and binds
+    if (viewIndex == 0)
+    {
+        m_SubmissionMilliseconds = 0.0;
+        std::fill(m_BindStats.begin(), m_BindStats.end(), StateTracker::Stats {});
+    }
+
+    drawStream.cull(m_Views[viewIndex], viewProjection, bindsMaterials);
+}
+
+void BaseGeometryPass::drawView(vgfw::renderer::RenderContext&                        rc,
+                                const SceneDrawStream&                                drawStream,
+                                uint32_t                                              viewIndex,
+                                const glm::mat4&                                      viewProjection,
+                                std::optional<uint32_t>                               materialBinding,
+                                const std::optional<SceneDrawStream::IndirectCount>& indirectCount)
 {
-    for (auto& [_, pipeline] : m_Pipelines)
+    const auto& view  = m_Views[viewIndex];
+    const auto  start = std::chrono::steady_clock::now();
+
+    m_UniformRing.bind(3, m_UniformRing.push(TransformUniform {.viewProjection = viewProjection}, 1));
+
+    m_StateTracker.reset();
+    drawStream.bind(view, indirectCount);
+    const auto& multiDraws = view.getMultiDraws();
+    for (uint32_t i = 0; i < multiDraws.size(); ++i)
     {
-        m_RenderContext.destroy(pipeline);
+        // Batches of a vertex format with different index types share its pipeline
+        const auto& vertexFormat = *drawStream.getBatches()[multiDraws[i].batchIndex].vertexFormat;
+        if (m_StateTracker.setPipeline(vertexFormat.getHash()))
+            rc.bindGraphicsPipeline(getPipeline(vertexFormat));
+        drawStream.draw(rc,
+                        multiDraws[i],
+                        materialBinding,
+                        m_StateTracker,
+                        indirectCount ? std::optional {indirectCount->firstCount + i} : std::nullopt);
     }
+    m_BindStats[viewIndex] += m_StateTracker.getStats();
+
+    const auto end = std::chrono::steady_clock::now();
+    m_SubmissionMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double BaseGeometryPass::getCullingMilliseconds() const
+{
+    double cullingMilliseconds = 0.0;
+    for (const auto& view : m_Views)
+        cullingMilliseconds += view.getCullingMilliseconds();
+    return cullingMilliseconds;
 }
 
-void BaseGeometryPass::setTransform(const glm::mat4& modelMatrix)
+StateTracker::Stats BaseGeometryPass::getBindStats() const
 {
-    m_RenderContext.setUniformMat4("uTransform.model", modelMatrix);
+    StateTracker::Stats bindStats;
+    for (const auto& viewStats : m_BindStats)
+        bindStats += viewStats;
+    return bindStats;
 }
 
 vgfw::renderer::GraphicsPipeline& BaseGeometryPass::getPipeline(const vgfw::renderer::VertexFormat& vertexFormat)
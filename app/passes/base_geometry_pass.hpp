@@ -2,17 +2,59 @@
 
 #include "base_pass.hpp"
 
+#include "scene_draw_stream.hpp"
+#include "uniform_ring.hpp"
+
 class BaseGeometryPass : public BasePass
 {
 public:
-    explicit BaseGeometryPass(vgfw::renderer::RenderContext& rc);
-    virtual ~BaseGeometryPass();
+    // A pass drawing the scene from several frustums (CSM cascades) has a view for each
+    BaseGeometryPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing, uint32_t numViews = 1);
+    virtual ~BaseGeometryPass() = default;
+
+    // CPU time the views took to submit the scene in the last frame, without the culling
+    double getSubmissionMilliseconds() const { return m_SubmissionMilliseconds; }
+
+    const std::vector<SceneDrawStream::View>& getViews() const { return m_Views; }
+    // CPU time the views took to cull the scene in the last frame
+    double getCullingMilliseconds() const;
+    // Binds issued and skipped as redundant by the views in the last frame
+    StateTracker::Stats getBindStats() const;
 
 protected:
-    void                                     setTransform(const glm::mat4& modelMatrix);
+    // Culls the scene to the frustum of viewProjection into a view of the pass, and multi-draws what is visible with
+    // the pipeline of every vertex format, skipping the redundant binds. The pass binds its other resources before.
+    // The passes that sample the materials give the binding of their PrimitiveMaterial uniform block.
+    void drawScene(vgfw::renderer::RenderContext& rc,
+                   const SceneDrawStream&         drawStream,
+                   uint32_t                       viewIndex,
+                   const glm::mat4&               viewProjection,
+                   std::optional<uint32_t>        materialBinding);
+
+    // The two halves of drawScene, for passes that cull further on the GPU in between. drawView multi-draws the
+    // commands the GPU compacted for the view instead of its own with an indirectCount, and can be called several
+    // times per cullView.
+    void cullView(const SceneDrawStream& drawStream,
+                  uint32_t               viewIndex,
+                  const glm::mat4&       viewProjection,
+                  bool                   bindsMaterials);
+    void drawView(vgfw::renderer::RenderContext&                        rc,
+                  const SceneDrawStream&                                drawStream,
+                  uint32_t                                              viewIndex,
+                  const glm::mat4&                                      viewProjection,
+                  std::optional<uint32_t>                               materialBinding,
+                  const std::optional<SceneDrawStream::IndirectCount>& indirectCount = std::nullopt);
+
     vgfw::renderer::GraphicsPipeline&        getPipeline(const vgfw::renderer::VertexFormat&);
     virtual vgfw::renderer::GraphicsPipeline createPipeline(const vgfw::renderer::VertexFormat&) = 0;
 
 protected:
+    UniformRing&                                                 m_UniformRing;
+    GLuint                                                       m_Program {0}; // Of the pipelines, created by the pass
     std::unordered_map<size_t, vgfw::renderer::GraphicsPipeline> m_Pipelines;
+    std::vector<SceneDrawStream::View>                           m_Views;
+    StateTracker                                                 m_StateTracker;
+    std::vector<StateTracker::Stats>                             m_BindStats; // Of every view
+
+    double m_SubmissionMilliseconds {0.0};
 };
\ No newline at end of file
@@ -2,14 +2,29 @@
 
 #include "vgfw.hpp"
 
+#include "program_cache.hpp"
+
 #include <fg/Fwd.hpp>
 
+#include <span>
+
 class BasePass
 {
 public:
     explicit BasePass(vgfw::renderer::RenderContext& rc) : m_RenderContext(rc) {}
     ~BasePass() = default;
 
+    // Whether the programs of the pass are linked, a pass is not added to a FrameGraph before (see ProgramCache)
+    bool isReady() const { return getProgramCache().isReady(m_Programs); }
+
+protected:
+    void addProgram(GLuint program) { m_Programs.push_back(program); }
+    void addPrograms(std::span<const GLuint> programs)
+    {
+        m_Programs.insert(m_Programs.end(), programs.begin(), programs.end());
+    }
+
 protected:
     vgfw::renderer::RenderContext&   m_RenderContext;
+    std::vector<GLuint>              m_Programs; // Waited for by isReady()
 };
\ No newline at end of file
@@ -2,8 +2,9 @@
 
 BlitPass::BlitPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/blit.frag"));
+    auto program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                        vgfw::utils::readFileAllText("shaders/blit.frag"));
+    addProgram(program);
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -25,8 +26,6 @@ BlitPass::BlitPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
                      .build();
 }
 
-BlitPass::~BlitPass() { m_RenderContext.destroy(m_Pipeline); }
-
 FrameGraphResource BlitPass::addToGraph(FrameGraph& fg, FrameGraphResource target, FrameGraphResource source)
 {
     VGFW_PROFILE_FUNCTION
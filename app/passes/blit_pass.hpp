@@ -6,7 +6,7 @@ class BlitPass : public BasePass
 {
 public:
     explicit BlitPass(vgfw::renderer::RenderContext& rc);
-    ~BlitPass();
+    ~BlitPass() = default;
 
     FrameGraphResource addToGraph(FrameGraph& fg, FrameGraphResource target, FrameGraphResource source);
 
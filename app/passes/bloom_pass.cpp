@@ -2,8 +2,9 @@
 
 BloomPass::BloomPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/bloom.frag"));
+    auto program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                        vgfw::utils::readFileAllText("shaders/bloom.frag"));
+    addProgram(program);
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -19,8 +20,6 @@ BloomPass::BloomPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
                      .build();
 }
 
-BloomPass::~BloomPass() { m_RenderContext.destroy(m_Pipeline); }
-
 FrameGraphResource BloomPass::addToGraph(FrameGraph&        fg,
                                          FrameGraphResource sceneColor,
                                          FrameGraphResource sceneColorBrightBlur,
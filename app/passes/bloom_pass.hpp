@@ -6,7 +6,7 @@ class BloomPass : public BasePass
 {
 public:
     explicit BloomPass(vgfw::renderer::RenderContext& rc);
-    ~BloomPass();
+    ~BloomPass() = default;
 
     FrameGraphResource
     addToGraph(FrameGraph& fg, FrameGraphResource sceneColor, FrameGraphResource sceneColorBrightBlur, float factor);
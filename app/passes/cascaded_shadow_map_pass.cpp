@@ -56,18 +56,23 @@ void uploadCascades(FrameGraph&                                    fg,
         });
 }
 
-CascadedShadowMapPass::CascadedShadowMapPass(vgfw::renderer::RenderContext& rc) : BaseGeometryPass(rc)
+CascadedShadowMapPass::CascadedShadowMapPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) :
+    BaseGeometryPass(rc, uniformRing, kNumCascades)
 {
+    m_Program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/geometry.vert"),
+                                                     vgfw::utils::readFileAllText("shaders/shadow_map.frag"));
+    addProgram(m_Program);
+
     m_CascadedUniformBuffer = rc.createBuffer(sizeof(CascadesUniform));
 }
 
 CascadedShadowMapPass::~CascadedShadowMapPass() { m_RenderContext.destroy(m_CascadedUniformBuffer); }
 
-void CascadedShadowMapPass::addToGraph(FrameGraph&                                       fg,
-                                       FrameGraphBlackboard&                             blackboard,
-                                       const Camera&                                     camera,
-                                       const DirectionalLight&                           light,
-                                       const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives)
+void CascadedShadowMapPass::addToGraph(FrameGraph&             fg,
+                                       FrameGraphBlackboard&   blackboard,
+                                       const Camera&           camera,
+                                       const DirectionalLight& light,
+                                       const SceneDrawStream&  drawStream)
 {
     VGFW_PROFILE_FUNCTION
 
@@ -87,7 +92,7 @@ void CascadedShadowMapPass::addToGraph(FrameGraph&
     for (uint32_t i = 0; i < cascades.size(); ++i)
     {
         const auto& lightViewProj = cascades[i].viewProjection;
-        cascadedShadowMaps        = addCascadePass(fg, cascadedShadowMaps, lightViewProj, std::move(meshPrimitives), i);
+        cascadedShadowMaps        = addCascadePass(fg, cascadedShadowMaps, lightViewProj, drawStream, i);
     }
     assert(cascadedShadowMaps);
     shadowMapData.cascadedShadowMaps = *cascadedShadowMaps;
@@ -95,11 +100,11 @@ void CascadedShadowMapPass::addToGraph(FrameGraph&
 }
 
 FrameGraphResource
-CascadedShadowMapPass::addCascadePass(FrameGraph&                                       fg,
-                                      std::optional<FrameGraphResource>                 cascadedShadowMaps,
-                                      const glm::mat4&                                  lightViewProjection,
-                                      const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
-                                      uint32_t                                          cascadeIdx)
+CascadedShadowMapPass::addCascadePass(FrameGraph&                       fg,
+                                      std::optional<FrameGraphResource> cascadedShadowMaps,
+                                      const glm::mat4&                  lightViewProjection,
+                                      const SceneDrawStream&            drawStream,
+                                      uint32_t                          cascadeIdx)
 {
     assert(cascadeIdx < kNumCascades);
     const auto name = fmt::format("CSM #{0}", cascadeIdx);
@@ -126,7 +131,7 @@ CascadedShadowMapPass::addCascadePass(FrameGraph&
 
             data.output = builder.write(*cascadedShadowMaps);
         },
-        [=, this, &meshPrimitives](const Data& data, FrameGraphPassResources& resources, void* ctx) {
+        [=, this, &drawStream](const Data& data, FrameGraphPassResources& resources, void* ctx) {
             NAMED_DEBUG_MARKER(name);
             VGFW_PROFILE_GL("CSM Pass");
             VGFW_PROFILE_NAMED_SCOPE("CSM Pass");
@@ -144,13 +149,7 @@ CascadedShadowMapPass::addCascadePass(FrameGraph&
             auto&      rc          = *static_cast<vgfw::renderer::RenderContext*>(ctx);
             const auto framebuffer = rc.beginRendering(renderingInfo);
 
-            for (const auto& meshPrimitive : meshPrimitives)
-            {
-                rc.bindGraphicsPipeline(getPipeline(*meshPrimitive.vertexFormat))
-                    .setUniformMat4("uTransform.model", meshPrimitive.modelMatrix)
-                    .setUniformMat4("uTransform.viewProjection", lightViewProjection)
-                    .drawMeshPrimitive(meshPrimitive);
-            }
+            drawScene(rc, drawStream, cascadeIdx, lightViewProjection, std::nullopt);
             rc.endRendering(framebuffer);
         });
 
@@ -161,9 +160,6 @@ vgfw::renderer::GraphicsPipeline CascadedShadowMapPass::createPipeline(const vgf
 {
     auto vertexArrayObject = m_RenderContext.getVertexArray(vertexFormat.getAttributes());
 
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/geometry.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/shadow_map.frag"));
-
     return vgfw::renderer::GraphicsPipeline::Builder {}
         .setDepthStencil({
             .depthTest      = true,
@@ -176,6 +172,6 @@ vgfw::renderer::GraphicsPipeline CascadedShadowMapPass::createPipeline(const vgf
             .scissorTest = false,
         })
         .setVAO(vertexArrayObject)
-        .setShaderProgram(program)
+        .setShaderProgram(m_Program)
         .build();
 }
\ No newline at end of file
@@ -8,21 +8,21 @@
 class CascadedShadowMapPass : public BaseGeometryPass
 {
 public:
-    explicit CascadedShadowMapPass(vgfw::renderer::RenderContext& rc);
+    CascadedShadowMapPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
     ~CascadedShadowMapPass();
 
-    void addToGraph(FrameGraph&                                       fg,
-                    FrameGraphBlackboard&                             blackboard,
-                    const Camera&                                     camera,
-                    const DirectionalLight&                           light,
-                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives);
+    void addToGraph(FrameGraph&             fg,
+                    FrameGraphBlackboard&   blackboard,
+                    const Camera&           camera,
+                    const DirectionalLight& light,
+                    const SceneDrawStream&  drawStream);
 
 private:
-    FrameGraphResource addCascadePass(FrameGraph&                                       fg,
-                                      std::optional<FrameGraphResource>                 cascadedShadowMaps,
-                                      const glm::mat4&                                  lightViewProjection,
-                                      const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
-                                      uint32_t                                          cascadeIdx);
+    FrameGraphResource addCascadePass(FrameGraph&                       fg,
+                                      std::optional<FrameGraphResource> cascadedShadowMaps,
+                                      const glm::mat4&                  lightViewProjection,
+                                      const SceneDrawStream&            drawStream,
+                                      uint32_t                          cascadeIdx);
 
     virtual vgfw::renderer::GraphicsPipeline createPipeline(const vgfw::renderer::VertexFormat&) override final;
 
@@ -7,42 +7,85 @@
 #include "pass_resource/scene_color_data.hpp"
 #include "pass_resource/shadow_data.hpp"
 
-DeferredLightingPass::DeferredLightingPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+#include "lpv_config.hpp"
+#include "shader_source.hpp"
+#include "uniforms/pass_uniforms.hpp"
+
+DeferredLightingPass::DeferredLightingPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) :
+    BasePass(rc), m_UniformRing(uniformRing)
 {
-    auto program =
-        m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                              vgfw::utils::readFileAllText("shaders/deferred_lighting.frag"));
-
-    m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
-                     .setDepthStencil({
-                         .depthTest  = false,
-                         .depthWrite = false,
-                     })
-                     .setRasterizerState({
-                         .polygonMode = vgfw::renderer::PolygonMode::eFill,
-                         .cullMode    = vgfw::renderer::CullMode::eBack,
-                         .scissorTest = false,
-                     })
-                     .setShaderProgram(program)
-                     .build();
+    for (uint32_t i = 0; i < kNumSHEncodings; ++i)
+    {
+        m_Permutations[i].create(
+            "shaders/fullscreen.vert", "shaders/deferred_lighting.frag", {{"SH_ENCODING", std::to_string(i)}});
+        addProgram(m_Permutations[i].getGeneric());
+    }
+
+    m_GpuTimer.create();
 }
 
-DeferredLightingPass::~DeferredLightingPass() { m_RenderContext.destroy(m_Pipeline); }
+DeferredLightingPass::~DeferredLightingPass() { m_GpuTimer.destroy(); }
 
-void DeferredLightingPass::addToGraph(FrameGraph&           fg,
-                                      FrameGraphBlackboard& blackboard,
-                                      const glm::mat4&      lightViewProjection,
-                                      const Grid3D&         grid,
-                                      RenderSettings&       settings)
+uint32_t DeferredLightingPass::getNumVariants() const
+{
+    uint32_t numVariants = 0;
+    for (const auto& permutations : m_Permutations)
+        numVariants += permutations.getNumVariants();
+    return numVariants;
+}
+
+void DeferredLightingPass::addToGraph(FrameGraph&             fg,
+                                      FrameGraphBlackboard&   blackboard,
+                                      const glm::mat4&        lightViewProjection,
+                                      std::span<const Grid3D> lpvGrids,
+                                      RenderSettings&         settings)
 {
     VGFW_PROFILE_FUNCTION
 
     const auto [cameraUniform] = blackboard.get<CameraData>();
     const auto [lightUniform]  = blackboard.get<LightData>();
     const auto gBuffer         = blackboard.get<GBufferData>();
-    const auto radianceData    = blackboard.get<RadianceData>();
+    const auto radianceData    = blackboard.get<CascadedRadianceData>();
     const auto shadowData      = blackboard.get<ShadowData>();
 
+    assert(!radianceData.cascades.empty() && radianceData.cascades.size() <= kMaxLPVCascades);
+    assert(radianceData.cascades.size() == lpvGrids.size());
+
+    // Every cascade is stored the same way
+    const auto encoding = radianceData.cascades.front().encoding;
+    assert(std::ranges::all_of(radianceData.cascades, [&](const auto& c) { return c.encoding == encoding; }));
+
+    // The variant of the settings, without the sampling and the branches of the features they disable
+    auto& permutations = m_Permutations[static_cast<uint32_t>(encoding)];
+    auto  program      = permutations.getGeneric();
+    if (settings.enableShaderPermutations)
+    {
+        program = permutations.get({
+            {"ENABLE_HBAO", settings.enableHBAO ? "true" : "false"},
+            {"ENABLE_BLOOM", settings.enableBloom ? "true" : "false"},
+            {"VISUAL_MODE", std::to_string(static_cast<uint32_t>(settings.visualMode)) + "u"},
+            {"NUM_LPV_CASCADES", std::to_string(lpvGrids.size()) + "u"},
+        });
+    }
+
+    DeferredLightingUniform deferredLightingUniform {
+        .lightViewProjection = lightViewProjection,
+        .numCascades         = static_cast<uint32_t>(lpvGrids.size()),
+        .settings =
+            {
+                .enableHBAO  = settings.enableHBAO,
+                .enableSSR   = settings.enableSSR,
+                .enableFXAA  = settings.enableFXAA,
+                .enableBloom = settings.enableBloom,
+                .visualMode  = static_cast<uint32_t>(settings.visualMode),
+            },
+    };
+    for (uint32_t i = 0; i < lpvGrids.size(); ++i)
+        deferredLightingUniform.cascades[i] = RadianceInjectionUniform::make(lpvGrids[i]);
+    // The setters took the light view-projection, the cascade count, the 5 settings and 3 members per cascade
+    const auto deferredLighting =
+        m_UniformRing.push(deferredLightingUniform, 7 + 3 * static_cast<uint32_t>(lpvGrids.size()));
+
     HBAOData hbaoData {};
     if (settings.enableHBAO)
     {
@@ -55,18 +98,17 @@ void DeferredLightingPass::addToGraph(FrameGraph&           fg,
         "Deferred Lighting Pass",
         [&](FrameGraph::Builder& builder, SceneColorData& data) {
             VGFW_PROFILE_NAMED_SCOPE("Deferred Lighting Pass Setup");
-            builder.read(cameraUniform);
-            builder.read(lightUniform);
-
             builder.read(gBuffer.normal);
             builder.read(gBuffer.albedo);
             builder.read(gBuffer.emissive);
             builder.read(gBuffer.metallicRoughnessAO);
             builder.read(gBuffer.depth);
 
-            builder.read(radianceData.r);
-            builder.read(radianceData.g);
-            builder.read(radianceData.b);
+            for (const auto& cascade : radianceData.cascades)
+            {
+                for (const auto volume : cascade.getVolumes())
+                    builder.read(volume);
+            }
 
             builder.read(shadowData.cascadedShadowMaps);
             builder.read(shadowData.cascadedUniformBuffer);
@@ -111,18 +153,13 @@ void DeferredLightingPass::addToGraph(FrameGraph&           fg,
 
             const auto framebuffer = rc.beginRendering(renderingInfo);
 
-            rc.bindGraphicsPipeline(m_Pipeline)
-                .setUniformVec3("uInjection.gridAABBMin", grid.aabb.min)
-                .setUniformVec3("uInjection.gridSize", grid.size)
-                .setUniform1f("uInjection.gridCellSize", grid.cellSize)
-                .setUniformMat4("uLightVP", lightViewProjection)
-                .setUniform1i("uSettings.enableHBAO", settings.enableHBAO)
-                .setUniform1i("uSettings.enableSSR", settings.enableSSR)
-                .setUniform1i("uSettings.enableFXAA", settings.enableFXAA)
-                .setUniform1i("uSettings.enableBloom", settings.enableBloom)
-                .setUniform1ui("uSettings.visualMode", static_cast<uint32_t>(settings.visualMode))
-                .bindUniformBuffer(0, vgfw::renderer::framegraph::getBuffer(resources, cameraUniform))
-                .bindUniformBuffer(1, vgfw::renderer::framegraph::getBuffer(resources, lightUniform))
+            m_UniformRing.bind(0, cameraUniform);
+            m_UniformRing.bind(1, lightUniform);
+            m_UniformRing.bind(3, deferredLighting);
+
+            m_GpuTimer.begin();
+
+            rc.bindGraphicsPipeline(getPipeline(program))
                 .bindUniformBuffer(2,
                                    vgfw::renderer::framegraph::getBuffer(resources, shadowData.cascadedUniformBuffer))
                 .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, gBuffer.normal))
@@ -130,10 +167,17 @@ void DeferredLightingPass::addToGraph(FrameGraph&           fg,
                 .bindTexture(2, vgfw::renderer::framegraph::getTexture(resources, gBuffer.emissive))
                 .bindTexture(3, vgfw::renderer::framegraph::getTexture(resources, gBuffer.metallicRoughnessAO))
                 .bindTexture(4, vgfw::renderer::framegraph::getTexture(resources, gBuffer.depth))
-                .bindTexture(5, vgfw::renderer::framegraph::getTexture(resources, shadowData.cascadedShadowMaps))
-                .bindTexture(6, vgfw::renderer::framegraph::getTexture(resources, radianceData.r))
-                .bindTexture(7, vgfw::renderer::framegraph::getTexture(resources, radianceData.g))
-                .bindTexture(8, vgfw::renderer::framegraph::getTexture(resources, radianceData.b));
+                .bindTexture(5, vgfw::renderer::framegraph::getTexture(resources, shadowData.cascadedShadowMaps));
+
+            // The first cascade is bound to 6-8, the coarser ones from 10 onwards. Packed cascades only use their first
+            // unit.
+            for (uint32_t i = 0; i < radianceData.cascades.size(); ++i)
+            {
+                const auto firstUnit = i == 0 ? 6 : 10 + (i - 1) * 3;
+                const auto volumes   = radianceData.cascades[i].getVolumes();
+                for (uint32_t j = 0; j < volumes.size(); ++j)
+                    rc.bindTexture(firstUnit + j, vgfw::renderer::framegraph::getTexture(resources, volumes[j]));
+            }
 
             if (settings.enableHBAO)
             {
@@ -141,5 +185,28 @@ void DeferredLightingPass::addToGraph(FrameGraph&           fg,
             }
 
             rc.drawFullScreenTriangle().endRendering(framebuffer);
+
+            m_GpuTimer.end();
         });
+}
+
+vgfw::renderer::GraphicsPipeline& DeferredLightingPass::getPipeline(GLuint program)
+{
+    auto [it, isNew] = m_Pipelines.try_emplace(program);
+    if (isNew)
+    {
+        it->second = vgfw::renderer::GraphicsPipeline::Builder {}
+                         .setDepthStencil({
+                             .depthTest  = false,
+                             .depthWrite = false,
+                         })
+                         .setRasterizerState({
+                             .polygonMode = vgfw::renderer::PolygonMode::eFill,
+                             .cullMode    = vgfw::renderer::CullMode::eBack,
+                             .scissorTest = false,
+                         })
+                         .setShaderProgram(program)
+                         .build();
+    }
+    return it->second;
 }
\ No newline at end of file
@@ -2,21 +2,41 @@
 
 #include "passes/base_pass.hpp"
 
+#include "gpu_timer.hpp"
 #include "grid3d.hpp"
 #include "render_settings.hpp"
+#include "sh_encoding.hpp"
+#include "shader_permutations.hpp"
+#include "uniform_ring.hpp"
+
+#include <span>
 
 class DeferredLightingPass : public BasePass
 {
 public:
-    explicit DeferredLightingPass(vgfw::renderer::RenderContext& rc);
+    DeferredLightingPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
     ~DeferredLightingPass();
 
-    void addToGraph(FrameGraph&           fg,
-                    FrameGraphBlackboard& blackboard,
-                    const glm::mat4&      lightViewProjection,
-                    const Grid3D&         grid,
-                    RenderSettings&       settings);
+    void addToGraph(FrameGraph&             fg,
+                    FrameGraphBlackboard&   blackboard,
+                    const glm::mat4&        lightViewProjection,
+                    std::span<const Grid3D> lpvGrids,
+                    RenderSettings&         settings);
+
+    // GPU time of the pass a few frames ago
+    double getGpuMilliseconds() const { return m_GpuTimer.getMilliseconds(); }
+    // Of every SH encoding
+    uint32_t getNumVariants() const;
+
+private:
+    vgfw::renderer::GraphicsPipeline& getPipeline(GLuint program);
 
 private:
-    vgfw::renderer::GraphicsPipeline m_Pipeline;
+    UniformRing& m_UniformRing;
+
+    // Variants of every SH encoding of the LPV cascades, specialized for the settings, and the pipeline of each
+    std::array<ShaderPermutations, kNumSHEncodings>              m_Permutations;
+    std::unordered_map<GLuint, vgfw::renderer::GraphicsPipeline> m_Pipelines;
+
+    GpuTimer m_GpuTimer;
 };
\ No newline at end of file
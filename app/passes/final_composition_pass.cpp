@@ -8,8 +8,9 @@
 
 FinalCompositionPass::FinalCompositionPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/final.frag"));
+    auto program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                        vgfw::utils::readFileAllText("shaders/final.frag"));
+    addProgram(program);
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -25,8 +26,6 @@ FinalCompositionPass::FinalCompositionPass(vgfw::renderer::RenderContext& rc) :
                      .build();
 }
 
-FinalCompositionPass::~FinalCompositionPass() { m_RenderContext.destroy(m_Pipeline); }
-
 void FinalCompositionPass::compose(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderSettings& settings)
 {
     VGFW_PROFILE_FUNCTION
@@ -7,7 +7,7 @@ class FinalCompositionPass : public BasePass
 {
 public:
     explicit FinalCompositionPass(vgfw::renderer::RenderContext& rc);
-    ~FinalCompositionPass();
+    ~FinalCompositionPass() = default;
 
     void compose(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderSettings& settings);
 
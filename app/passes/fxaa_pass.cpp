@@ -2,8 +2,9 @@
 
 FxaaPass::FxaaPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/fxaa.frag"));
+    auto program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                        vgfw::utils::readFileAllText("shaders/fxaa.frag"));
+    addProgram(program);
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -19,8 +20,6 @@ FxaaPass::FxaaPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
                      .build();
 }
 
-FxaaPass::~FxaaPass() { m_RenderContext.destroy(m_Pipeline); }
-
 FrameGraphResource FxaaPass::addToGraph(FrameGraph& fg, FrameGraphResource input)
 {
     VGFW_PROFILE_FUNCTION
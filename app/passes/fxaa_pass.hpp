@@ -6,7 +6,7 @@ class FxaaPass : public BasePass
 {
 public:
     explicit FxaaPass(vgfw::renderer::RenderContext& rc);
-    ~FxaaPass();
+    ~FxaaPass() = default;
 
     FrameGraphResource addToGraph(FrameGraph& fg, FrameGraphResource input);
 
@@ -2,8 +2,9 @@
 
 GaussianBlurPass::GaussianBlurPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/gaussian_blur.frag"));
+    auto program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                        vgfw::utils::readFileAllText("shaders/gaussian_blur.frag"));
+    addProgram(program);
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -19,8 +20,6 @@ GaussianBlurPass::GaussianBlurPass(vgfw::renderer::RenderContext& rc) : BasePass
                      .build();
 }
 
-GaussianBlurPass::~GaussianBlurPass() { m_RenderContext.destroy(m_Pipeline); }
-
 FrameGraphResource GaussianBlurPass::addToGraph(FrameGraph& fg, FrameGraphResource input, float scale)
 {
     input = addToGraph(fg, input, scale, false);
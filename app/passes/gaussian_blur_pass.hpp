@@ -6,7 +6,7 @@ class GaussianBlurPass : public BasePass
 {
 public:
     explicit GaussianBlurPass(vgfw::renderer::RenderContext& rc);
-    ~GaussianBlurPass();
+    ~GaussianBlurPass() = default;
 
     FrameGraphResource addToGraph(FrameGraph& fg, FrameGraphResource input, float scale);
 
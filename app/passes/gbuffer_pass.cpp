@@ -2,21 +2,31 @@
 #include "pass_resource/camera_data.hpp"
 #include "pass_resource/gbuffer_data.hpp"
 
-GBufferPass::GBufferPass(vgfw::renderer::RenderContext& rc) : BaseGeometryPass(rc) {}
+GBufferPass::GBufferPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) :
+    BaseGeometryPass(rc, uniformRing)
+{
+    m_Program = getProgramCache().getGraphicsProgram(
+        vgfw::utils::readFileAllText("shaders/geometry.vert"),
+        addShaderDefines(vgfw::utils::readFileAllText("shaders/gbuffer.frag"), getMaterialShaderDefines()));
+    addProgram(m_Program);
+
+    m_GpuTimer.create();
+}
+
+GBufferPass::~GBufferPass() { m_GpuTimer.destroy(); }
 
-void GBufferPass::addToGraph(FrameGraph&                                       fg,
-                             FrameGraphBlackboard&                             blackboard,
-                             const vgfw::renderer::Extent2D&                   resolution,
-                             const Camera&                                     camera,
-                             const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives)
+void GBufferPass::addToGraph(FrameGraph&                     fg,
+                             FrameGraphBlackboard&           blackboard,
+                             const vgfw::renderer::Extent2D& resolution,
+                             const Camera&                   camera,
+                             const SceneDrawStream&          drawStream,
+                             OcclusionCuller*                occlusionCuller)
 {
     const auto [cameraUniform] = blackboard.get<CameraData>();
 
     blackboard.add<GBufferData>() = fg.addCallbackPass<GBufferData>(
         "GBuffer Pass",
         [&, resolution](FrameGraph::Builder& builder, GBufferData& data) {
-            builder.read(cameraUniform);
-
             data.normal = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
                 "Normal", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eRGB16F});
             data.normal = builder.write(data.normal);
@@ -37,7 +47,7 @@ void GBufferPass::addToGraph(FrameGraph&                                       f
                 "Depth", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eDepth32F});
             data.depth = builder.write(data.depth);
         },
-        [=, &meshPrimitives, &camera, this](const GBufferData& data, FrameGraphPassResources& resources, void* ctx) {
+        [=, &drawStream, &camera, this](const GBufferData& data, FrameGraphPassResources& resources, void* ctx) {
             NAMED_DEBUG_MARKER("GBuffer Pass");
             VGFW_PROFILE_GL("GBuffer Pass");
             VGFW_PROFILE_NAMED_SCOPE("GBuffer Pass");
@@ -63,21 +73,54 @@ void GBufferPass::addToGraph(FrameGraph&                                       f
                 .depthAttachment = vgfw::renderer::AttachmentInfo {
                     .image = vgfw::renderer::framegraph::getTexture(resources, data.depth), .clearValue = kFarPlane}};
 
-            auto frameBuffer = rc.beginRendering(renderingInfo);
+            const auto viewProjection = camera.data.projection * camera.data.view;
+
+            m_GpuTimer.begin();
+            m_UniformRing.bind(0, cameraUniform);
 
-            // Draw
-            for (const auto& meshPrimitive : meshPrimitives)
+            if (!occlusionCuller)
             {
-                rc.bindGraphicsPipeline(getPipeline(*meshPrimitive.vertexFormat))
-                    .setUniformMat4("uTransform.model", meshPrimitive.modelMatrix)
-                    .setUniformMat4("uTransform.viewProjection", camera.data.projection * camera.data.view)
-                    .bindUniformBuffer(0, vgfw::renderer::framegraph::getBuffer(resources, cameraUniform))
-                    .bindMeshPrimitiveMaterialBuffer(1, meshPrimitive)
-                    .bindMeshPrimitiveTextures(0, meshPrimitive)
-                    .drawMeshPrimitive(meshPrimitive);
+                auto frameBuffer = rc.beginRendering(renderingInfo);
+                drawScene(rc, drawStream, 0, viewProjection, 1);
+                rc.endRendering(frameBuffer);
+
+                m_GpuTimer.end();
+                return;
             }
 
+            // Early phase, the draws visible in the last frame
+            cullView(drawStream, 0, viewProjection, true);
+            occlusionCuller->cull(OcclusionCuller::Phase::eEarly, m_Views[0], viewProjection);
+
+            auto frameBuffer = rc.beginRendering(renderingInfo);
+            drawView(rc,
+                     drawStream,
+                     0,
+                     viewProjection,
+                     1,
+                     occlusionCuller->getIndirectCount(OcclusionCuller::Phase::eEarly));
             rc.endRendering(frameBuffer);
+
+            // Late phase, the draws the Hi-Z of the early depth does not occlude and were not drawn yet
+            const auto& depth = vgfw::renderer::framegraph::getTexture(resources, data.depth);
+            occlusionCuller->buildHiZ(depth, resolution);
+            occlusionCuller->cull(OcclusionCuller::Phase::eLate, m_Views[0], viewProjection);
+
+            // On top of the early phase
+            for (auto& attachment : renderingInfo.colorAttachments)
+                attachment.clearValue = std::nullopt;
+            renderingInfo.depthAttachment->clearValue = std::nullopt;
+
+            frameBuffer = rc.beginRendering(renderingInfo);
+            drawView(rc,
+                     drawStream,
+                     0,
+                     viewProjection,
+                     1,
+                     occlusionCuller->getIndirectCount(OcclusionCuller::Phase::eLate));
+            rc.endRendering(frameBuffer);
+
+            m_GpuTimer.end();
         });
 }
 
@@ -85,9 +128,6 @@ vgfw::renderer::GraphicsPipeline GBufferPass::createPipeline(const vgfw::rendere
 {
     auto vertexArrayObject = m_RenderContext.getVertexArray(vertexFormat.getAttributes());
 
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/geometry.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/gbuffer.frag"));
-
     return vgfw::renderer::GraphicsPipeline::Builder {}
         .setDepthStencil({
             .depthTest      = true,
@@ -100,6 +140,6 @@ vgfw::renderer::GraphicsPipeline GBufferPass::createPipeline(const vgfw::rendere
             .scissorTest = false,
         })
         .setVAO(vertexArrayObject)
-        .setShaderProgram(program)
+        .setShaderProgram(m_Program)
         .build();
 }
\ No newline at end of file
@@ -3,19 +3,29 @@
 #include "passes/base_geometry_pass.hpp"
 
 #include "camera.hpp"
+#include "gpu_timer.hpp"
+#include "occlusion_culler.hpp"
 
 class GBufferPass : public BaseGeometryPass
 {
 public:
-    explicit GBufferPass(vgfw::renderer::RenderContext& rc);
-    ~GBufferPass() = default;
+    GBufferPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
+    ~GBufferPass();
 
-    void addToGraph(FrameGraph&                                       fg,
-                    FrameGraphBlackboard&                             blackboard,
-                    const vgfw::renderer::Extent2D&                   resolution,
-                    const Camera&                                     camera,
-                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives);
+    // With an occlusionCuller, the frustum culled draws are drawn in its two phases around the build of its Hi-Z
+    void addToGraph(FrameGraph&                     fg,
+                    FrameGraphBlackboard&           blackboard,
+                    const vgfw::renderer::Extent2D& resolution,
+                    const Camera&                   camera,
+                    const SceneDrawStream&          drawStream,
+                    OcclusionCuller*                occlusionCuller = nullptr);
+
+    // GPU time of the pass a few frames ago, culling included
+    double getGpuMilliseconds() const { return m_GpuTimer.getMilliseconds(); }
 
 private:
     virtual vgfw::renderer::GraphicsPipeline createPipeline(const vgfw::renderer::VertexFormat&) override final;
+
+private:
+    GpuTimer m_GpuTimer;
 };
\ No newline at end of file
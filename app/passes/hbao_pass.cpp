@@ -2,45 +2,73 @@
 #include "pass_resource/camera_data.hpp"
 #include "pass_resource/gbuffer_data.hpp"
 #include "pass_resource/hbao_data.hpp"
+#include "uniforms/pass_uniforms.hpp"
 
+#include <algorithm>
 #include <random>
 
-HbaoPass::HbaoPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+namespace
+{
+    // Step and direction counts with a variant of their own. The sliders reach every other count, which stay uniforms
+    // so that dragging them does not compile, cache and keep a variant per value.
+    constexpr std::array<std::pair<int, int>, 4> kCountPresets {{{4, 4}, {4, 8}, {8, 8}, {8, 16}}};
+} // namespace
+
+HbaoPass::HbaoPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) :
+    BasePass(rc), m_UniformRing(uniformRing)
 {
     generateNoiseTexture();
 
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/hbao.frag"));
-
-    m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
-                     .setShaderProgram(program)
-                     .setDepthStencil({
-                         .depthTest  = false,
-                         .depthWrite = false,
-                     })
-                     .setRasterizerState({
-                         .polygonMode = vgfw::renderer::PolygonMode::eFill,
-                         .cullMode    = vgfw::renderer::CullMode::eBack,
-                         .scissorTest = false,
-                     })
-                     .build();
+    m_Permutations.create("shaders/fullscreen.vert", "shaders/hbao.frag");
+    addProgram(m_Permutations.getGeneric());
+
+    m_GpuTimer.create();
 }
 
-HbaoPass::~HbaoPass() { m_RenderContext.destroy(m_Pipeline).destroy(m_Noise); }
+HbaoPass::~HbaoPass()
+{
+    m_RenderContext.destroy(m_Noise);
+    m_GpuTimer.destroy();
+}
 
-void HbaoPass::addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard, const HBAOProperties& properties)
+void HbaoPass::addToGraph(FrameGraph&           fg,
+                          FrameGraphBlackboard& blackboard,
+                          const HBAOProperties& properties,
+                          bool                  enablePermutations)
 {
     VGFW_PROFILE_FUNCTION
 
     const auto [cameraUniform] = blackboard.get<CameraData>();
 
+    const HBAOUniform hbao {
+        .radius          = properties.radius,
+        .bias            = properties.bias,
+        .intensity       = properties.intensity,
+        .negInvRadius2   = -1.0f / (properties.radius * properties.radius),
+        .maxRadiusPixels = properties.maxRadiusPixels,
+        .stepCount       = properties.stepCount,
+        .directionCount  = properties.directionCount,
+    };
+    const auto hbaoUniform = m_UniformRing.push(hbao, 7);
+
+    const auto counts   = std::pair {properties.stepCount, properties.directionCount};
+    const bool isPreset = std::ranges::find(kCountPresets, counts) != kCountPresets.end();
+
+    auto program = m_Permutations.getGeneric();
+    if (enablePermutations && isPreset)
+    {
+        program = m_Permutations.get({
+            {"HBAO_STEP_COUNT", std::to_string(properties.stepCount)},
+            {"HBAO_DIRECTION_COUNT", std::to_string(properties.directionCount)},
+        });
+    }
+
     const auto& gBuffer = blackboard.get<GBufferData>();
     const auto  extent  = fg.getDescriptor<vgfw::renderer::framegraph::FrameGraphTexture>(gBuffer.depth).extent;
 
     blackboard.add<HBAOData>() = fg.addCallbackPass<HBAOData>(
         "HBAO Pass",
         [&](FrameGraph::Builder& builder, HBAOData& data) {
-            builder.read(cameraUniform);
             builder.read(gBuffer.depth);
 
             data.hbao = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
@@ -62,22 +90,40 @@ void HbaoPass::addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard, cons
 
             auto&      rc          = *static_cast<vgfw::renderer::RenderContext*>(ctx);
             const auto framebuffer = rc.beginRendering(renderingInfo);
-            rc.bindGraphicsPipeline(m_Pipeline)
-                .bindUniformBuffer(0, vgfw::renderer::framegraph::getBuffer(resources, cameraUniform))
-                .setUniform1f("uHBAO_radius", properties.radius)
-                .setUniform1f("uHBAO_bias", properties.bias)
-                .setUniform1f("uHBAO_intensity", properties.intensity)
-                .setUniform1f("uHBAO_negInvRadius2", -1.0 / (properties.radius * properties.radius))
-                .setUniform1i("uHBAO_maxRadiusPixels", properties.maxRadiusPixels)
-                .setUniform1i("uHBAO_stepCount", properties.stepCount)
-                .setUniform1i("uHBAO_directionCount", properties.directionCount)
+            m_UniformRing.bind(0, cameraUniform);
+            m_UniformRing.bind(1, hbaoUniform);
+
+            m_GpuTimer.begin();
+            rc.bindGraphicsPipeline(getPipeline(program))
                 .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, gBuffer.depth))
                 .bindTexture(1, m_Noise)
                 .drawFullScreenTriangle()
                 .endRendering(framebuffer);
+            m_GpuTimer.end();
         });
 }
 
+vgfw::renderer::GraphicsPipeline& HbaoPass::getPipeline(GLuint program)
+{
+    auto [it, isNew] = m_Pipelines.try_emplace(program);
+    if (isNew)
+    {
+        it->second = vgfw::renderer::GraphicsPipeline::Builder {}
+                         .setShaderProgram(program)
+                         .setDepthStencil({
+                             .depthTest  = false,
+                             .depthWrite = false,
+                         })
+                         .setRasterizerState({
+                             .polygonMode = vgfw::renderer::PolygonMode::eFill,
+                             .cullMode    = vgfw::renderer::CullMode::eBack,
+                             .scissorTest = false,
+                         })
+                         .build();
+    }
+    return it->second;
+}
+
 void HbaoPass::generateNoiseTexture()
 {
     constexpr auto kSize = 4u;
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "base_pass.hpp"
+#include "gpu_timer.hpp"
+#include "shader_permutations.hpp"
+#include "uniform_ring.hpp"
 
 struct HBAOProperties
 {
@@ -15,15 +18,31 @@ struct HBAOProperties
 class HbaoPass : public BasePass
 {
 public:
-    explicit HbaoPass(vgfw::renderer::RenderContext& rc);
+    HbaoPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
     ~HbaoPass();
 
-    void addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard, const HBAOProperties& properties);
+    // With shader permutations, the loops are unrolled by a variant specialized for the step and direction counts of
+    // a few presets
+    void addToGraph(FrameGraph&           fg,
+                    FrameGraphBlackboard& blackboard,
+                    const HBAOProperties& properties,
+                    bool                  enablePermutations);
+
+    // GPU time of the pass a few frames ago
+    double   getGpuMilliseconds() const { return m_GpuTimer.getMilliseconds(); }
+    uint32_t getNumVariants() const { return m_Permutations.getNumVariants(); }
 
 private:
     void generateNoiseTexture();
 
+    vgfw::renderer::GraphicsPipeline& getPipeline(GLuint program);
+
 private:
-    vgfw::renderer::GraphicsPipeline m_Pipeline;
-    vgfw::renderer::Texture          m_Noise;
+    UniformRing& m_UniformRing;
+
+    ShaderPermutations                                           m_Permutations;
+    std::unordered_map<GLuint, vgfw::renderer::GraphicsPipeline> m_Pipelines; // Of every variant
+    vgfw::renderer::Texture                                      m_Noise;
+
+    GpuTimer m_GpuTimer;
 };
\ No newline at end of file
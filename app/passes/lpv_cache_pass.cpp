@@ -0,0 +1,86 @@
+#include "passes/lpv_cache_pass.hpp"
+
+LpvCacheKey LpvCacheKey::make(const DirectionalLight& light,
+                              const Grid3D&           grid,
+                              uint32_t                rsmResolution,
+                              InjectionMode           injectionMode,
+                              int                     numIterations,
+                              PropagationMode         propagationMode,
+                              SHEncoding              encoding,
+                              uint64_t                sceneRevision)
+{
+    return {
+        .lightDirection  = light.direction,
+        .lightColor      = light.color,
+        .lightIntensity  = light.intensity,
+        .gridAABBMin     = grid.aabb.min,
+        .gridAABBMax     = grid.aabb.max,
+        .gridSize        = grid.size,
+        .gridCellSize    = grid.cellSize,
+        .rsmResolution   = rsmResolution,
+        .injectionMode   = injectionMode,
+        .numIterations   = numIterations,
+        .propagationMode = propagationMode,
+        .encoding        = encoding,
+        .sceneRevision   = sceneRevision,
+    };
+}
+
+LpvCachePass::LpvCachePass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+{
+    m_CopyPrograms.create("shaders/radiance_copy.comp");
+    addPrograms(m_CopyPrograms.programs);
+}
+
+LpvCachePass::~LpvCachePass()
+{
+    m_Volume.destroy(m_RenderContext);
+}
+
+bool LpvCachePass::lookup(const LpvCacheKey& key)
+{
+    if (m_Key && *m_Key == key)
+    {
+        ++m_NumHits;
+        return true;
+    }
+
+    ++m_NumMisses;
+    m_PendingKey = key;
+    return false;
+}
+
+RadianceData LpvCachePass::import(FrameGraph& fg)
+{
+    assert(m_Key);
+    return m_Volume.import(fg, "LPV Cache");
+}
+
+RadianceData LpvCachePass::addToGraph(FrameGraph& fg, const RadianceData& radianceData, const Grid3D& grid)
+{
+    VGFW_PROFILE_FUNCTION
+
+    if (m_Volume.resize(m_RenderContext, grid.size, radianceData.encoding))
+        m_Key.reset();
+
+    const auto cached = m_Volume.import(fg, "LPV Cache");
+
+    const auto& pass = fg.addCallbackPass<RadianceData>(
+        "Store LPV Cache",
+        [&](FrameGraph::Builder& builder, RadianceData& data) {
+            readRadianceData(builder, radianceData);
+            data = writeRadianceData(builder, cached);
+        },
+        [=, this](const RadianceData& data, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("Store LPV Cache");
+            VGFW_PROFILE_GL("Store LPV Cache");
+            VGFW_PROFILE_NAMED_SCOPE("Store LPV Cache");
+
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            dispatchRadianceKernel(rc, resources, m_CopyPrograms, radianceData, data, grid.size);
+        });
+
+    m_Key = m_PendingKey;
+
+    return pass;
+}
\ No newline at end of file
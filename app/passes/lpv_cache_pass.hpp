@@ -0,0 +1,67 @@
+#pragma once
+
+#include "base_pass.hpp"
+
+#include "grid3d.hpp"
+#include "injection_mode.hpp"
+#include "light.hpp"
+#include "pass_resource/radiance_data.hpp"
+#include "propagation_mode.hpp"
+#include "radiance_volume.hpp"
+
+// Everything the propagated LPV depends on, the camera is deliberately not a part of it
+struct LpvCacheKey
+{
+    glm::vec3       lightDirection;
+    glm::vec3       lightColor;
+    float           lightIntensity;
+    glm::vec3       gridAABBMin;
+    glm::vec3       gridAABBMax;
+    glm::uvec3      gridSize;
+    float           gridCellSize;
+    uint32_t        rsmResolution;
+    InjectionMode   injectionMode;
+    int             numIterations;
+    PropagationMode propagationMode;
+    SHEncoding      encoding;
+    uint64_t        sceneRevision;
+
+    static LpvCacheKey make(const DirectionalLight& light,
+                            const Grid3D&           grid,
+                            uint32_t                rsmResolution,
+                            InjectionMode           injectionMode,
+                            int                     numIterations,
+                            PropagationMode         propagationMode,
+                            SHEncoding              encoding,
+                            uint64_t                sceneRevision);
+
+    bool operator==(const LpvCacheKey&) const = default;
+};
+
+class LpvCachePass : public BasePass
+{
+public:
+    explicit LpvCachePass(vgfw::renderer::RenderContext& rc);
+    ~LpvCachePass();
+
+    // Returns true if the cached volumes match the key, counts hits and misses
+    bool lookup(const LpvCacheKey& key);
+
+    // Imports the volumes stored by a previous frame
+    RadianceData import(FrameGraph& fg);
+
+    // Stores the propagated radiance for the following frames, returns the cached copy
+    RadianceData addToGraph(FrameGraph& fg, const RadianceData& radianceData, const Grid3D& grid);
+
+    uint64_t getNumHits() const { return m_NumHits; }
+    uint64_t getNumMisses() const { return m_NumMisses; }
+
+private:
+    SHEncodingPrograms         m_CopyPrograms;
+    RadianceVolume             m_Volume;
+    std::optional<LpvCacheKey> m_Key;
+    std::optional<LpvCacheKey> m_PendingKey;
+
+    uint64_t m_NumHits {0};
+    uint64_t m_NumMisses {0};
+};
\ No newline at end of file
@@ -1,13 +1,15 @@
 #include "radiance_injection_pass.hpp"
 
 #include "lpv_config.hpp"
+#include "uniforms/pass_uniforms.hpp"
 
-RadianceInjectionPass::RadianceInjectionPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+RadianceInjectionPass::RadianceInjectionPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) :
+    BasePass(rc), m_UniformRing(uniformRing)
 {
     auto program =
-        m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/radiance_injection.vert"),
-                                              vgfw::utils::readFileAllText("shaders/radiance_injection.frag"),
-                                              vgfw::utils::readFileAllText("shaders/radiance_injection.geom"));
+        getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/radiance_injection.vert"),
+                                             vgfw::utils::readFileAllText("shaders/radiance_injection.frag"),
+                                             vgfw::utils::readFileAllText("shaders/radiance_injection.geom"));
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setDepthStencil({.depthTest = false, .depthWrite = false})
@@ -17,17 +19,53 @@ RadianceInjectionPass::RadianceInjectionPass(vgfw::renderer::RenderContext& rc)
                      .setBlendState(2, kAdditiveBlending)
                      .setShaderProgram(program)
                      .build();
+
+    m_ClusteringProgram =
+        getProgramCache().getComputeProgram(vgfw::utils::readFileAllText("shaders/vpl_clustering.comp"));
+    m_ClusterInjectionPrograms.create("shaders/vpl_cluster_injection.comp");
+    m_ComputeProgram =
+        getProgramCache().getComputeProgram(vgfw::utils::readFileAllText("shaders/radiance_injection.comp"));
+    m_ResolvePrograms.create("shaders/radiance_injection_resolve.comp");
+
+    addProgram(program);
+    addProgram(m_ClusteringProgram);
+    addPrograms(m_ClusterInjectionPrograms.programs);
+    addProgram(m_ComputeProgram);
+    addPrograms(m_ResolvePrograms.programs);
 }
 
-RadianceInjectionPass::~RadianceInjectionPass() { m_RenderContext.destroy(m_Pipeline); }
+RadianceInjectionPass::~RadianceInjectionPass() { glDeleteBuffers(1, &m_Accumulation); }
 
-RadianceData
-RadianceInjectionPass::addToGraph(FrameGraph& fg, const ReflectiveShadowMapData& rsmData, const Grid3D& grid)
+namespace
+{
+    // Every VPL stands for the RSM texels of the reference resolution it covers
+    float getVPLFluxScale(uint32_t rsmResolution)
+    {
+        const auto texelFootprint = static_cast<float>(kRSMResolution) / static_cast<float>(rsmResolution);
+        return texelFootprint * texelFootprint;
+    }
+
+    // Fixed point scales of the compute accumulations at the reference RSM resolution
+    constexpr float kClusterFixedPointScale  = 256.0f;
+    constexpr float kRadianceFixedPointScale = 1024.0f;
+} // namespace
+
+RadianceData RadianceInjectionPass::addToGraph(FrameGraph&                    fg,
+                                               const ReflectiveShadowMapData& rsmData,
+                                               const Grid3D&                  grid,
+                                               InjectionMode                  mode,
+                                               SHEncoding                     encoding)
 {
     VGFW_PROFILE_FUNCTION
 
+    if (mode != InjectionMode::eRaster)
+        return addComputePass(fg, rsmData, grid, mode, encoding);
+
     const auto extent = vgfw::renderer::Extent2D {.width = grid.size.x, .height = grid.size.y};
 
+    const auto injectionUniform = m_UniformRing.push(
+        RadianceInjectionUniform::make(grid, rsmData.resolution, getVPLFluxScale(rsmData.resolution)), 5);
+
     auto data = fg.addCallbackPass<RadianceData>(
         "RadianceInjection",
         [&](FrameGraph::Builder& builder, RadianceData& data) {
@@ -35,37 +73,7 @@ RadianceInjectionPass::addToGraph(FrameGraph& fg, const ReflectiveShadowMapData&
             builder.read(rsmData.normal);
             builder.read(rsmData.flux);
 
-            data.r = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "SH-R",
-                {
-                    .extent   = extent,
-                    .depth    = grid.size.z,
-                    .format   = vgfw::renderer::PixelFormat::eRGBA16F,
-                    .wrapMode = vgfw::renderer::WrapMode::eClampToOpaqueBlack,
-                    .filter   = vgfw::renderer::TexelFilter::eNearest,
-                });
-            data.g = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "SH-G",
-                {
-                    .extent   = extent,
-                    .depth    = grid.size.z,
-                    .format   = vgfw::renderer::PixelFormat::eRGBA16F,
-                    .wrapMode = vgfw::renderer::WrapMode::eClampToOpaqueBlack,
-                    .filter   = vgfw::renderer::TexelFilter::eNearest,
-                });
-            data.b = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "SH-B",
-                {
-                    .extent   = extent,
-                    .depth    = grid.size.z,
-                    .format   = vgfw::renderer::PixelFormat::eRGBA16F,
-                    .wrapMode = vgfw::renderer::WrapMode::eClampToOpaqueBlack,
-                    .filter   = vgfw::renderer::TexelFilter::eNearest,
-                });
-
-            data.r = builder.write(data.r);
-            data.g = builder.write(data.g);
-            data.b = builder.write(data.b);
+            data = writeRadianceData(builder, createRadianceData(builder, "Injected", grid.size, SHEncoding::eRGBA16F));
         },
         [=, this](const RadianceData& data, FrameGraphPassResources& resources, void* ctx) {
             NAMED_DEBUG_MARKER("RadianceInjection Pass");
@@ -95,23 +103,92 @@ RadianceInjectionPass::addToGraph(FrameGraph& fg, const ReflectiveShadowMapData&
             auto&      rc          = *static_cast<vgfw::renderer::RenderContext*>(ctx);
             const auto framebuffer = rc.beginRendering(renderingInfo);
 
+            m_UniformRing.bind(0, injectionUniform);
             rc.bindGraphicsPipeline(m_Pipeline)
                 .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, rsmData.position))
                 .bindTexture(1, vgfw::renderer::framegraph::getTexture(resources, rsmData.normal))
                 .bindTexture(2, vgfw::renderer::framegraph::getTexture(resources, rsmData.flux))
-                .setUniform1i("uInjection.rsmResolution", kRSMResolution)
-                .setUniformVec3("uInjection.gridAABBMin", grid.aabb.min)
-                .setUniformVec3("uInjection.gridSize", grid.size)
-                .setUniform1f("uInjection.gridCellSize", grid.cellSize)
                 .draw({},
                       {},
                       vgfw::renderer::GeometryInfo {
                           .topology    = vgfw::renderer::PrimitiveTopology::ePointList,
-                          .numVertices = kNumVPL,
+                          .numVertices = rsmData.resolution * rsmData.resolution,
                       });
 
             rc.endRendering(framebuffer);
         });
 
     return data;
+}
+
+RadianceData RadianceInjectionPass::addComputePass(FrameGraph&                    fg,
+                                                   const ReflectiveShadowMapData& rsmData,
+                                                   const Grid3D&                  grid,
+                                                   InjectionMode                  mode,
+                                                   SHEncoding                     encoding)
+{
+    const bool isClustered         = mode == InjectionMode::eClustered;
+    const auto accumulationProgram = isClustered ? m_ClusteringProgram : m_ComputeProgram;
+    const auto resolveProgram      = isClustered ? m_ClusterInjectionPrograms[encoding] : m_ResolvePrograms[encoding];
+    const auto texelLocalSize      = isClustered ? 8u : 16u;
+    const auto cellSize            = (isClustered ? 6 : 12) * sizeof(GLint);
+
+    // A quantization step relative to the unscaled flux of a VPL, so that the many dim VPLs of a large RSM do not round
+    // to zero. Each doubling of the resolution takes 2 bits of headroom off the sums of a cell.
+    const auto fluxScale       = getVPLFluxScale(rsmData.resolution);
+    const auto fixedPointScale = (isClustered ? kClusterFixedPointScale : kRadianceFixedPointScale) / fluxScale;
+
+    const auto accumulationSize = static_cast<GLsizeiptr>(grid.size.x * grid.size.y * grid.size.z * cellSize);
+    if (accumulationSize > m_AccumulationSize)
+    {
+        glDeleteBuffers(1, &m_Accumulation);
+        glCreateBuffers(1, &m_Accumulation);
+        glNamedBufferStorage(m_Accumulation, accumulationSize, nullptr, 0);
+        m_AccumulationSize = accumulationSize;
+    }
+
+    return fg.addCallbackPass<RadianceData>(
+        isClustered ? "VPLClusterInjection" : "ComputeRadianceInjection",
+        [&](FrameGraph::Builder& builder, RadianceData& data) {
+            builder.read(rsmData.position);
+            builder.read(rsmData.normal);
+            builder.read(rsmData.flux);
+
+            data = writeRadianceData(builder, createRadianceData(builder, "Injected", grid.size, encoding));
+        },
+        [=, this](const RadianceData& data, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("ComputeRadianceInjection Pass");
+            VGFW_PROFILE_GL("ComputeRadianceInjection Pass");
+            VGFW_PROFILE_NAMED_SCOPE("ComputeRadianceInjection Pass");
+
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+
+            // Accumulate the VPLs of every cell, either as a single cluster or as SH coefficients
+            glClearNamedBufferSubData(
+                m_Accumulation, GL_R32UI, 0, accumulationSize, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_Accumulation);
+
+            glProgramUniform3fv(accumulationProgram, 0, 1, glm::value_ptr(grid.aabb.min));
+            glProgramUniform3uiv(accumulationProgram, 1, 1, glm::value_ptr(grid.size));
+            glProgramUniform1f(accumulationProgram, 2, grid.cellSize);
+            glProgramUniform1i(accumulationProgram, 3, rsmData.resolution);
+            glProgramUniform1f(accumulationProgram, 4, fluxScale);
+            glProgramUniform1f(accumulationProgram, 5, fixedPointScale);
+            glProgramUniform1f(resolveProgram, 0, fixedPointScale);
+
+            constexpr auto kCellLocalSize = 4u;
+            const auto     numGroups      = (rsmData.resolution + texelLocalSize - 1u) / texelLocalSize;
+            rc.bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, rsmData.position))
+                .bindTexture(1, vgfw::renderer::framegraph::getTexture(resources, rsmData.normal))
+                .bindTexture(2, vgfw::renderer::framegraph::getTexture(resources, rsmData.flux))
+                .dispatch(accumulationProgram, {numGroups, numGroups, 1});
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+            // Then resolve them into the SH volumes, every cell is written exactly once
+            const auto volumes = data.getVolumes();
+            for (uint32_t i = 0; i < volumes.size(); ++i)
+                rc.bindImage(i, vgfw::renderer::framegraph::getTexture(resources, volumes[i]), 0, GL_WRITE_ONLY);
+            rc.dispatch(resolveProgram, (grid.size + kCellLocalSize - 1u) / kCellLocalSize);
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+        });
 }
\ No newline at end of file
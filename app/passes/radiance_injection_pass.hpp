@@ -3,17 +3,44 @@
 #include "base_pass.hpp"
 
 #include "grid3d.hpp"
+#include "injection_mode.hpp"
 #include "pass_resource/radiance_data.hpp"
 #include "pass_resource/reflective_shadow_map_data.hpp"
+#include "radiance_volume.hpp"
+#include "uniform_ring.hpp"
 
 class RadianceInjectionPass : public BasePass
 {
 public:
-    explicit RadianceInjectionPass(vgfw::renderer::RenderContext& rc);
+    RadianceInjectionPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
     ~RadianceInjectionPass();
 
-    RadianceData addToGraph(FrameGraph& fg, const ReflectiveShadowMapData& rsmData, const Grid3D& grid);
+    // The raster mode can only blend into RGBA16F volumes, the compute modes write the requested encoding
+    RadianceData addToGraph(FrameGraph&                    fg,
+                            const ReflectiveShadowMapData& rsmData,
+                            const Grid3D&                  grid,
+                            InjectionMode                  mode,
+                            SHEncoding                     encoding = SHEncoding::eRGBA16F);
 
 private:
+    // The clustered and compute modes: accumulate the VPLs per cell into a fixed point buffer, then resolve it into
+    // the SH volumes
+    RadianceData addComputePass(FrameGraph&                    fg,
+                                const ReflectiveShadowMapData& rsmData,
+                                const Grid3D&                  grid,
+                                InjectionMode                  mode,
+                                SHEncoding                     encoding);
+
+private:
+    UniformRing& m_UniformRing;
+
     vgfw::renderer::GraphicsPipeline m_Pipeline;
+    GLuint                           m_ClusteringProgram;
+    SHEncodingPrograms               m_ClusterInjectionPrograms;
+    GLuint                           m_ComputeProgram;
+    SHEncodingPrograms               m_ResolvePrograms;
+
+    // Fixed point accumulation of the compute passes: 6 ints per cell (clusters) or 12 (SH coefficients)
+    GLuint     m_Accumulation {0};
+    GLsizeiptr m_AccumulationSize {0};
 };
\ No newline at end of file
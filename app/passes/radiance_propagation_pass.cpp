@@ -1,13 +1,25 @@
 #include "passes/radiance_propagation_pass.hpp"
 
 #include "lpv_config.hpp"
+#include "uniforms/pass_uniforms.hpp"
 
-RadiancePropagationPass::RadiancePropagationPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+namespace
+{
+    // Both copies of a brick grown by a halo of fusedIterations cells, a uvec2 of fp16 per color and cell
+    GLint getFusedSharedMemorySize(uint32_t fusedIterations)
+    {
+        const auto regionSize = kLPVBrickSize + 2 * fusedIterations;
+        return static_cast<GLint>(2 * 3 * regionSize * regionSize * regionSize * sizeof(glm::uvec2));
+    }
+} // namespace
+
+RadiancePropagationPass::RadiancePropagationPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) :
+    BasePass(rc), m_UniformRing(uniformRing)
 {
     auto program =
-        m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/radiance_propagation.vert"),
-                                              vgfw::utils::readFileAllText("shaders/radiance_propagation.frag"),
-                                              vgfw::utils::readFileAllText("shaders/radiance_propagation.geom"));
+        getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/radiance_propagation.vert"),
+                                             vgfw::utils::readFileAllText("shaders/radiance_propagation.frag"),
+                                             vgfw::utils::readFileAllText("shaders/radiance_propagation.geom"));
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setDepthStencil({.depthTest = false, .depthWrite = false})
@@ -17,17 +29,91 @@ RadiancePropagationPass::RadiancePropagationPass(vgfw::renderer::RenderContext&
                      .setBlendState(2, kAdditiveBlending)
                      .setShaderProgram(program)
                      .build();
+
+    m_ComputePrograms.create("shaders/radiance_propagation.comp");
+    m_CopyPrograms.create("shaders/radiance_copy.comp");
+    m_BrickOccupancyPrograms.create("shaders/lpv_brick_occupancy.comp");
+    m_BrickDilationProgram =
+        getProgramCache().getComputeProgram(vgfw::utils::readFileAllText("shaders/lpv_brick_dilation.comp"));
+    m_EnergyReduceProgram =
+        getProgramCache().getComputeProgram(vgfw::utils::readFileAllText("shaders/lpv_energy_reduce.comp"));
+
+    // The fused variants are not waited for, the iterations are propagated one at a time until they are linked
+    addProgram(program);
+    addPrograms(m_ComputePrograms.getGeneric().programs);
+    addPrograms(m_CopyPrograms.programs);
+    addPrograms(m_BrickOccupancyPrograms.programs);
+    addProgram(m_BrickDilationProgram);
+    addProgram(m_EnergyReduceProgram);
+
+    // Only the variants whose halo fits in the shared memory of the device
+    GLint maxSharedMemorySize = 0;
+    glGetIntegerv(GL_MAX_COMPUTE_SHARED_MEMORY_SIZE, &maxSharedMemorySize);
+    for (auto k = 2u; k <= kMaxFusedLPVIterations && getFusedSharedMemorySize(k) <= maxSharedMemorySize; ++k)
+    {
+        m_FusedPrograms[k - 2].create("shaders/radiance_propagation_fused.comp",
+                                      {{"LPV_FUSED_ITERATIONS", std::to_string(k)}});
+        m_MaxFusedIterations = k;
+    }
+
+    // A vec2 per iteration
+    constexpr auto kEnergyDeltasSize = kMaxLPVIterations * sizeof(glm::vec2);
+    glCreateBuffers(1, &m_EnergyDeltas);
+    glNamedBufferStorage(m_EnergyDeltas, kEnergyDeltasSize, nullptr, 0);
+    m_EnergyReadback.create(kEnergyDeltasSize);
 }
 
-RadiancePropagationPass::~RadiancePropagationPass() { m_RenderContext.destroy(m_Pipeline); }
+RadiancePropagationPass::~RadiancePropagationPass()
+{
+    glDeleteBuffers(1, &m_EnergyPartials);
+    glDeleteBuffers(1, &m_EnergyDeltas);
+    m_EnergyReadback.destroy();
 
-RadianceData RadiancePropagationPass::addToGraph(FrameGraph&         fg,
-                                                 const RadianceData& radianceData,
-                                                 const Grid3D&       grid,
-                                                 uint32_t            iteration)
+    for (auto& volumes : m_Volumes)
+    {
+        for (auto& volume : volumes)
+            volume.destroy(m_RenderContext);
+    }
+    m_Completed.destroy(m_RenderContext);
+}
+
+RadianceData RadiancePropagationPass::addToGraph(FrameGraph&               fg,
+                                                 const RadianceData&       radianceData,
+                                                 const Grid3D&             grid,
+                                                 uint32_t                  numIterations,
+                                                 PropagationMode           mode,
+                                                 const PropagationOptions& options,
+                                                 uint32_t                  cascadeIdx)
 {
     VGFW_PROFILE_FUNCTION
 
+    if (numIterations == 0)
+        return radianceData;
+
+    assert(mode != PropagationMode::eAmortized);
+
+    if (mode == PropagationMode::eCompute)
+        return addComputePass(fg, radianceData, grid, numIterations, options, cascadeIdx);
+
+    // Rasterized volumes can only be RGBA16F
+    assert(radianceData.encoding == SHEncoding::eRGBA16F);
+
+    // Shared by the iterations, the setters set the grid size of every one
+    const auto injectionUniform = m_UniformRing.push(RadianceInjectionUniform::make(grid), numIterations);
+
+    auto propagatedRadiance = radianceData;
+    for (uint32_t i = 0; i < numIterations; ++i)
+        propagatedRadiance = addGeometryShaderPass(fg, propagatedRadiance, grid, injectionUniform, i);
+
+    return propagatedRadiance;
+}
+
+RadianceData RadiancePropagationPass::addGeometryShaderPass(FrameGraph&              fg,
+                                                            const RadianceData&      radianceData,
+                                                            const Grid3D&            grid,
+                                                            const UniformAllocation& injectionUniform,
+                                                            uint32_t                 iteration)
+{
     const auto name   = fmt::format("RadiancePropagation #{0}", iteration);
     const auto extent = vgfw::renderer::Extent2D {.width = grid.size.x, .height = grid.size.y};
 
@@ -99,20 +185,301 @@ RadianceData RadiancePropagationPass::addToGraph(FrameGraph&         fg,
             auto&      rc          = *static_cast<vgfw::renderer::RenderContext*>(ctx);
             const auto framebuffer = rc.beginRendering(renderingInfo);
 
+            m_UniformRing.bind(0, injectionUniform);
             rc.bindGraphicsPipeline(m_Pipeline)
                 .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, radianceData.r))
                 .bindTexture(1, vgfw::renderer::framegraph::getTexture(resources, radianceData.g))
                 .bindTexture(2, vgfw::renderer::framegraph::getTexture(resources, radianceData.b))
-                .setUniformVec3("uInjection.gridSize", grid.size)
                 .draw(std::nullopt,
                       std::nullopt,
                       vgfw::renderer::GeometryInfo {
                           .topology    = vgfw::renderer::PrimitiveTopology::ePointList,
-                          .numVertices = kNumVPL,
+                          .numVertices = grid.size.x * grid.size.y * grid.size.z,
                       });
 
             rc.endRendering(framebuffer);
         });
 
     return data;
+}
+
+RadianceData RadiancePropagationPass::addComputePass(FrameGraph&               fg,
+                                                     const RadianceData&       radianceData,
+                                                     const Grid3D&             grid,
+                                                     uint32_t                  numIterations,
+                                                     const PropagationOptions& options,
+                                                     uint32_t                  cascadeIdx)
+{
+    assert(cascadeIdx < kMaxLPVCascades);
+
+    auto& cascadeVolumes = m_Volumes[cascadeIdx];
+    for (auto& volume : cascadeVolumes)
+        volume.resize(m_RenderContext, grid.size, radianceData.encoding);
+
+    // The first set of ping-pong volumes is shared with the time-sliced mode, whose cycle is lost now
+    if (cascadeIdx == 0)
+        m_CycleProgress = 0;
+
+    const std::array<RadianceData, 2> volumes {
+        cascadeVolumes[0].import(fg, fmt::format("LPV Ping #{0}", cascadeIdx)),
+        cascadeVolumes[1].import(fg, fmt::format("LPV Pong #{0}", cascadeIdx)),
+    };
+
+    // Radiance crosses a brick every kLPVBrickSize iterations, the first dilation adds the ring around the occupied
+    // bricks
+    const auto brickCount   = (grid.size + kLPVBrickSize - 1u) / kLPVBrickSize;
+    const auto numDilations = 1 + (numIterations - 1) / kLPVBrickSize;
+
+    // Measurements are dropped while every readback slot is in flight
+    const bool measureEnergy = options.measureEnergy && numIterations <= kMaxLPVIterations &&
+                               m_EnergyReadback.canEnqueue();
+    const auto numGroups     = brickCount.x * brickCount.y * brickCount.z;
+    if (measureEnergy)
+    {
+        const auto partialsSize = static_cast<GLsizeiptr>(numIterations * numGroups * sizeof(glm::vec2));
+        if (partialsSize > m_EnergyPartialsSize)
+        {
+            glDeleteBuffers(1, &m_EnergyPartials);
+            glCreateBuffers(1, &m_EnergyPartials);
+            glNamedBufferStorage(m_EnergyPartials, partialsSize, nullptr, 0);
+            m_EnergyPartialsSize = partialsSize;
+        }
+    }
+
+    // The energy is measured per iteration, fused dispatches come first and single iterations cover the remainder
+    auto fusedIterations = measureEnergy ? 1u : std::clamp(options.fusedIterations, 1u, m_MaxFusedIterations);
+    if (fusedIterations > 1 && !m_FusedPrograms[fusedIterations - 2].isReady())
+        fusedIterations = 1;
+    const auto numFusedDispatches = fusedIterations > 1 ? numIterations / fusedIterations : 0u;
+    const auto numDispatches      = numFusedDispatches + (numIterations - numFusedDispatches * fusedIterations);
+
+    // Variants specialized for the grid size, compiled the first time a grid of the size is propagated
+    const auto computePrograms = m_ComputePrograms.get(grid.size);
+    const auto fusedPrograms =
+        fusedIterations > 1 ? m_FusedPrograms[fusedIterations - 2].get(grid.size) : computePrograms;
+
+    struct Data
+    {
+        std::array<RadianceData, 2>       volumes;
+        std::array<FrameGraphResource, 2> brickMasks {-1, -1};
+    };
+    const auto& pass = fg.addCallbackPass<Data>(
+        fmt::format("RadiancePropagation (Compute) #{0}", cascadeIdx),
+        [&](FrameGraph::Builder& builder, Data& data) {
+            readRadianceData(builder, radianceData);
+
+            for (uint32_t i = 0; i < volumes.size(); ++i)
+                data.volumes[i] = writeRadianceData(builder, volumes[i]);
+
+            if (options.useBrickMask)
+            {
+                for (auto& brickMask : data.brickMasks)
+                {
+                    brickMask = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
+                        "LPV Brick Mask",
+                        {
+                            .extent   = {.width = brickCount.x, .height = brickCount.y},
+                            .depth    = brickCount.z,
+                            .format   = vgfw::renderer::PixelFormat::eR8_UNorm,
+                            .wrapMode = vgfw::renderer::WrapMode::eClampToEdge,
+                            .filter   = vgfw::renderer::TexelFilter::eNearest,
+                        });
+                    brickMask = builder.write(brickMask);
+                }
+            }
+        },
+        [=, this](const Data& data, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("RadiancePropagation Compute Pass");
+            VGFW_PROFILE_GL("RadiancePropagation Compute Pass");
+            VGFW_PROFILE_NAMED_SCOPE("RadiancePropagation Compute Pass");
+
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+
+            if (options.useBrickMask)
+            {
+                // Inactive bricks are skipped, they must not keep the radiance of a previous frame
+                for (const auto& volume : data.volumes)
+                    clearRadianceData(resources, volume);
+
+                // Bricks holding injected radiance
+                const auto& occupancy = vgfw::renderer::framegraph::getTexture(resources, data.brickMasks[0]);
+                const auto  injected  = radianceData.getVolumes();
+                for (uint32_t i = 0; i < injected.size(); ++i)
+                    rc.bindTexture(i, vgfw::renderer::framegraph::getTexture(resources, injected[i]));
+                rc.bindImage(0, occupancy, 0, GL_WRITE_ONLY)
+                    .dispatch(m_BrickOccupancyPrograms[radianceData.encoding], brickCount);
+                glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+                // First iteration of every brick
+                for (uint32_t i = 0; i < numDilations; ++i)
+                {
+                    const auto& src = vgfw::renderer::framegraph::getTexture(resources, data.brickMasks[i % 2]);
+                    const auto& dst = vgfw::renderer::framegraph::getTexture(resources, data.brickMasks[(i + 1) % 2]);
+
+                    glProgramUniform1ui(m_BrickDilationProgram, 0, i == 0 ? 0u : kLPVBrickSize);
+                    rc.bindTexture(0, src)
+                        .bindImage(0, dst, 0, GL_WRITE_ONLY)
+                        .dispatch(m_BrickDilationProgram, (brickCount + kLPVBrickSize - 1u) / kLPVBrickSize);
+                    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+                }
+                rc.bindTexture(3, vgfw::renderer::framegraph::getTexture(resources, data.brickMasks[numDilations % 2]));
+            }
+
+            if (measureEnergy)
+            {
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_EnergyPartials);
+            }
+
+            uint32_t iteration = 0;
+            for (uint32_t i = 0; i < numDispatches; ++i)
+            {
+                const bool  isFused  = i < numFusedDispatches;
+                const auto& programs = isFused ? fusedPrograms : computePrograms;
+                const auto  program  = programs[radianceData.encoding];
+
+                glProgramUniform1i(program, 0, options.useBrickMask ? static_cast<GLint>(iteration) : -1);
+                if (!isFused)
+                    glProgramUniform1i(program, 1, measureEnergy ? static_cast<GLint>(iteration) : -1);
+
+                const auto& src = i == 0 ? radianceData : data.volumes[(i - 1) % 2];
+                dispatchRadianceKernel(rc, resources, programs, src, data.volumes[i % 2], grid.size);
+                iteration += isFused ? fusedIterations : 1;
+            }
+
+            if (measureEnergy)
+            {
+                // Sum the partials of every iteration and read them back a few frames later
+                glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_EnergyDeltas);
+                glProgramUniform1ui(m_EnergyReduceProgram, 0, numGroups);
+                rc.dispatch(m_EnergyReduceProgram, {numIterations, 1, 1});
+
+                glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+                m_EnergyReadback.enqueue(m_EnergyDeltas, numIterations * sizeof(glm::vec2));
+            }
+        });
+
+    return pass.volumes[(numDispatches - 1) % 2];
+}
+
+bool RadiancePropagationPass::isStartingCycle(const Grid3D& grid, uint32_t numIterations, SHEncoding encoding) const
+{
+    return numIterations == 0 || m_CycleProgress == 0 || m_CycleIterations != numIterations ||
+           m_Completed.size != grid.size || m_Completed.encoding != encoding;
+}
+
+RadianceData RadiancePropagationPass::addAmortizedToGraph(FrameGraph&                        fg,
+                                                          const std::optional<RadianceData>& radianceData,
+                                                          const Grid3D&                      grid,
+                                                          uint32_t                           numIterations,
+                                                          uint32_t                           iterationBudget)
+{
+    VGFW_PROFILE_FUNCTION
+
+    // Every frame of a cycle keeps the encoding of its injected radiance
+    const auto encoding = radianceData ? radianceData->encoding : m_Completed.encoding;
+    assert(radianceData.has_value() == isStartingCycle(grid, numIterations, encoding));
+
+    if (numIterations == 0)
+        return *radianceData;
+
+    if (radianceData)
+    {
+        m_CycleIterations = numIterations;
+        m_CycleProgress   = 0;
+    }
+
+    for (auto& volume : m_Volumes[0])
+        volume.resize(m_RenderContext, grid.size, encoding);
+    if (m_Completed.resize(m_RenderContext, grid.size, encoding))
+        m_HasCompleted = false;
+
+    // Until the first cycle has completed there is nothing to show, so the first one is not sliced
+    const auto firstIteration = m_CycleProgress;
+    const auto lastIteration =
+        m_HasCompleted ? std::min(firstIteration + std::max(iterationBudget, 1u), numIterations) : numIterations;
+    const bool completesCycle = lastIteration == numIterations;
+
+    const std::array<RadianceData, 2> volumes {
+        m_Volumes[0][0].import(fg, "LPV Ping"),
+        m_Volumes[0][1].import(fg, "LPV Pong"),
+    };
+    const auto completed = m_Completed.import(fg, "LPV Completed");
+
+    const auto computePrograms = m_ComputePrograms.get(grid.size);
+
+    struct Data
+    {
+        std::array<RadianceData, 2> volumes;
+        RadianceData                completed;
+    };
+    const auto& pass = fg.addCallbackPass<Data>(
+        fmt::format("RadiancePropagation (Amortized) #{0}-#{1}", firstIteration, lastIteration - 1),
+        [&](FrameGraph::Builder& builder, Data& data) {
+            if (radianceData)
+                readRadianceData(builder, *radianceData);
+
+            for (uint32_t i = 0; i < volumes.size(); ++i)
+                data.volumes[i] = writeRadianceData(builder, volumes[i]);
+
+            // Lighting keeps sampling the last completed volume while the next one converges
+            data.completed = completed;
+            if (completesCycle)
+                data.completed = writeRadianceData(builder, completed);
+            else
+                readRadianceData(builder, completed);
+        },
+        [=, this](const Data& data, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("RadiancePropagation Amortized Pass");
+            VGFW_PROFILE_GL("RadiancePropagation Amortized Pass");
+            VGFW_PROFILE_NAMED_SCOPE("RadiancePropagation Amortized Pass");
+
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+
+            glProgramUniform1i(computePrograms[encoding], 0, -1);
+            glProgramUniform1i(computePrograms[encoding], 1, -1);
+            for (auto i = firstIteration; i < lastIteration; ++i)
+            {
+                const auto& src = i == 0 ? *radianceData : data.volumes[(i - 1) % 2];
+                dispatchRadianceKernel(rc, resources, computePrograms, src, data.volumes[i % 2], grid.size);
+            }
+
+            if (completesCycle)
+            {
+                dispatchRadianceKernel(
+                    rc, resources, m_CopyPrograms, data.volumes[(numIterations - 1) % 2], data.completed, grid.size);
+            }
+        });
+
+    if (completesCycle)
+    {
+        m_HasCompleted  = true;
+        m_CycleProgress = 0;
+    }
+    else
+    {
+        m_CycleProgress = lastIteration;
+    }
+
+    return pass.completed;
+}
+
+bool RadiancePropagationPass::fetchEnergyDeltas(std::vector<float>& energyDeltas)
+{
+    std::vector<std::byte> readback;
+    if (!m_EnergyReadback.poll(readback))
+        return false;
+
+    const auto* energies = reinterpret_cast<const glm::vec2*>(readback.data());
+    const auto  count    = readback.size() / sizeof(glm::vec2);
+
+    energyDeltas.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        // x: squared norm of the change, y: squared norm of the volume
+        const auto& energy = energies[i];
+        energyDeltas[i]    = energy.y > 0.0f ? glm::sqrt(energy.x / energy.y) : 0.0f;
+    }
+
+    return true;
 }
\ No newline at end of file
@@ -2,17 +2,92 @@
 
 #include "base_pass.hpp"
 
+#include "gpu_readback.hpp"
 #include "grid3d.hpp"
+#include "lpv_config.hpp"
 #include "pass_resource/radiance_data.hpp"
+#include "propagation_mode.hpp"
+#include "radiance_volume.hpp"
+#include "uniform_ring.hpp"
+
+// Options of the compute path
+struct PropagationOptions
+{
+    bool     useBrickMask {false};  // Only propagate the bricks the injected radiance can have reached
+    bool     measureEnergy {false}; // Measure the energy delta of every iteration, see fetchEnergyDeltas()
+    uint32_t fusedIterations {1};   // Iterations per dispatch, see radiance_propagation_fused.comp
+};
 
 class RadiancePropagationPass : public BasePass
 {
 public:
-    explicit RadiancePropagationPass(vgfw::renderer::RenderContext& rc);
+    RadiancePropagationPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
     ~RadiancePropagationPass();
 
-    RadianceData addToGraph(FrameGraph& fg, const RadianceData& radianceData, const Grid3D& grid, uint32_t iteration);
+    RadianceData addToGraph(FrameGraph&               fg,
+                            const RadianceData&       radianceData,
+                            const Grid3D&             grid,
+                            uint32_t                  numIterations,
+                            PropagationMode           mode,
+                            const PropagationOptions& options,
+                            uint32_t                  cascadeIdx = 0);
+
+    // Time-sliced propagation: a new cycle needs freshly injected radiance, the frames in between pass std::nullopt
+    bool isStartingCycle(const Grid3D& grid, uint32_t numIterations, SHEncoding encoding) const;
+    RadianceData addAmortizedToGraph(FrameGraph&                        fg,
+                                     const std::optional<RadianceData>& radianceData,
+                                     const Grid3D&                      grid,
+                                     uint32_t                           numIterations,
+                                     uint32_t                           iterationBudget);
+
+    uint32_t getCycleProgress() const { return m_CycleProgress; }
+
+    // Fused iterations the shared memory of the device allows, at most kMaxFusedLPVIterations
+    uint32_t getMaxFusedIterations() const { return m_MaxFusedIterations; }
+
+    // Relative energy delta ||V(i) - V(i-1)|| / ||V(i)|| of every iteration of a previous frame, once its readback
+    // has completed
+    bool fetchEnergyDeltas(std::vector<float>& energyDeltas);
 
 private:
+    RadianceData addGeometryShaderPass(FrameGraph&              fg,
+                                       const RadianceData&      radianceData,
+                                       const Grid3D&            grid,
+                                       const UniformAllocation& injectionUniform,
+                                       uint32_t                 iteration);
+    RadianceData addComputePass(FrameGraph&               fg,
+                                const RadianceData&       radianceData,
+                                const Grid3D&             grid,
+                                uint32_t                  numIterations,
+                                const PropagationOptions& options,
+                                uint32_t                  cascadeIdx);
+
+private:
+    UniformRing& m_UniformRing;
+
     vgfw::renderer::GraphicsPipeline m_Pipeline;
+    GridSizePrograms                 m_ComputePrograms;
+    SHEncodingPrograms               m_CopyPrograms;
+    SHEncodingPrograms               m_BrickOccupancyPrograms;
+    uint32_t                         m_MaxFusedIterations {1};
+    GLuint                           m_BrickDilationProgram;
+    GLuint                           m_EnergyReduceProgram;
+
+    // Variants of radiance_propagation_fused.comp fusing 2 to kMaxFusedLPVIterations iterations
+    std::array<GridSizePrograms, kMaxFusedLPVIterations - 1> m_FusedPrograms;
+
+    // Ping-pong volumes of the compute path for every cascade, the amortized path uses the first set
+    std::array<std::array<RadianceVolume, 2>, kMaxLPVCascades> m_Volumes;
+
+    // Last completed volume of the amortized path and the progress of the cycle in flight
+    RadianceVolume m_Completed;
+    bool           m_HasCompleted {false};
+    uint32_t       m_CycleIterations {0};
+    uint32_t       m_CycleProgress {0};
+
+    // Energy measurement: per workgroup partial sums, their reduction per iteration and its readback
+    GLuint      m_EnergyPartials {0};
+    GLsizeiptr  m_EnergyPartialsSize {0};
+    GLuint      m_EnergyDeltas {0};
+    GpuReadback m_EnergyReadback;
 };
\ No newline at end of file
@@ -3,30 +3,37 @@
 #include "pass_resource/light_data.hpp"
 #include "pass_resource/reflective_shadow_map_data.hpp"
 
-#include "lpv_config.hpp"
+ReflectiveShadowMapPass::ReflectiveShadowMapPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) :
+    BaseGeometryPass(rc, uniformRing)
+{
+    const auto fragmentSource = vgfw::utils::readFileAllText("shaders/reflective_shadow_map.frag");
 
-ReflectiveShadowMapPass::ReflectiveShadowMapPass(vgfw::renderer::RenderContext& rc) : BaseGeometryPass(rc) {}
+    m_Program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/geometry.vert"),
+                                                     addShaderDefines(fragmentSource, getMaterialShaderDefines()));
+    addProgram(m_Program);
+}
 
-void ReflectiveShadowMapPass::addToGraph(FrameGraph&                                       fg,
-                                         FrameGraphBlackboard&                             blackboard,
-                                         const glm::mat4&                                  lightViewProjection,
-                                         const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives)
+void ReflectiveShadowMapPass::addToGraph(FrameGraph&            fg,
+                                         FrameGraphBlackboard&  blackboard,
+                                         const glm::mat4&       lightViewProjection,
+                                         const SceneDrawStream& drawStream,
+                                         uint32_t               resolution)
 {
     VGFW_PROFILE_FUNCTION
 
     const auto [lightUniform] = blackboard.get<LightData>();
 
-    constexpr auto kExtent = vgfw::renderer::Extent2D {kRSMResolution, kRSMResolution};
+    const auto extent = vgfw::renderer::Extent2D {resolution, resolution};
 
     blackboard.add<ReflectiveShadowMapData>() = fg.addCallbackPass<ReflectiveShadowMapData>(
         "ReflectiveShadowMap Pass",
         [&](FrameGraph::Builder& builder, ReflectiveShadowMapData& data) {
-            builder.read(lightUniform);
+            data.resolution = resolution;
 
             data.position = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
                 "RSM-Position",
                 {
-                    .extent   = kExtent,
+                    .extent   = extent,
                     .format   = vgfw::renderer::PixelFormat::eRGB16F,
                     .wrapMode = vgfw::renderer::WrapMode::eClampToOpaqueBlack,
                     .filter   = vgfw::renderer::TexelFilter::eNearest,
@@ -34,7 +41,7 @@ void ReflectiveShadowMapPass::addToGraph(FrameGraph&
             data.normal = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
                 "RSM-Normal",
                 {
-                    .extent   = kExtent,
+                    .extent   = extent,
                     .format   = vgfw::renderer::PixelFormat::eRGB16F,
                     .wrapMode = vgfw::renderer::WrapMode::eClampToOpaqueBlack,
                     .filter   = vgfw::renderer::TexelFilter::eNearest,
@@ -42,7 +49,7 @@ void ReflectiveShadowMapPass::addToGraph(FrameGraph&
             data.flux = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
                 "RSM-Flux",
                 {
-                    .extent   = kExtent,
+                    .extent   = extent,
                     .format   = vgfw::renderer::PixelFormat::eRGB16F,
                     .wrapMode = vgfw::renderer::WrapMode::eClampToOpaqueBlack,
                     .filter   = vgfw::renderer::TexelFilter::eNearest,
@@ -51,7 +58,7 @@ void ReflectiveShadowMapPass::addToGraph(FrameGraph&
             data.depth = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
                 "RSM-Depth",
                 {
-                    .extent = kExtent,
+                    .extent = extent,
                     .format = vgfw::renderer::PixelFormat::eDepth24,
                 });
 
@@ -60,7 +67,7 @@ void ReflectiveShadowMapPass::addToGraph(FrameGraph&
             data.flux     = builder.write(data.flux);
             data.depth    = builder.write(data.depth);
         },
-        [=, &meshPrimitives, this](const ReflectiveShadowMapData& data, FrameGraphPassResources& resources, void* ctx) {
+        [=, &drawStream, this](const ReflectiveShadowMapData& data, FrameGraphPassResources& resources, void* ctx) {
             NAMED_DEBUG_MARKER("ReflectiveShadowMap Pass");
             VGFW_PROFILE_GL("ReflectiveShadowMap Pass");
             VGFW_PROFILE_NAMED_SCOPE("ReflectiveShadowMap Pass");
@@ -69,7 +76,7 @@ void ReflectiveShadowMapPass::addToGraph(FrameGraph&
             constexpr glm::vec4 kBlackColor {0.0f};
 
             const vgfw::renderer::RenderingInfo renderingInfo {
-                .area = {.extent = kExtent},
+                .area = {.extent = extent},
                 .colorAttachments =
                     {
                         {
@@ -97,16 +104,8 @@ void ReflectiveShadowMapPass::addToGraph(FrameGraph&
 
             const auto framebuffer = rc.beginRendering(renderingInfo);
 
-            for (const auto& meshPrimitive : meshPrimitives)
-            {
-                rc.bindGraphicsPipeline(getPipeline(*meshPrimitive.vertexFormat))
-                    .setUniformMat4("uTransform.model", meshPrimitive.modelMatrix)
-                    .setUniformMat4("uTransform.viewProjection", lightViewProjection)
-                    .bindUniformBuffer(1, vgfw::renderer::framegraph::getBuffer(resources, lightUniform))
-                    .bindMeshPrimitiveMaterialBuffer(2, meshPrimitive)
-                    .bindMeshPrimitiveTextures(0, meshPrimitive)
-                    .drawMeshPrimitive(meshPrimitive);
-            }
+            m_UniformRing.bind(1, lightUniform);
+            drawScene(rc, drawStream, 0, lightViewProjection, 2);
 
             rc.endRendering(framebuffer);
         });
@@ -117,10 +116,6 @@ ReflectiveShadowMapPass::createPipeline(const vgfw::renderer::VertexFormat& vert
 {
     auto vertexArrayObject = m_RenderContext.getVertexArray(vertexFormat.getAttributes());
 
-    auto program =
-        m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/geometry.vert"),
-                                              vgfw::utils::readFileAllText("shaders/reflective_shadow_map.frag"));
-
     return vgfw::renderer::GraphicsPipeline::Builder {}
         .setDepthStencil({
             .depthTest      = true,
@@ -133,6 +128,6 @@ ReflectiveShadowMapPass::createPipeline(const vgfw::renderer::VertexFormat& vert
             .scissorTest = false,
         })
         .setVAO(vertexArrayObject)
-        .setShaderProgram(program)
+        .setShaderProgram(m_Program)
         .build();
 }
\ No newline at end of file
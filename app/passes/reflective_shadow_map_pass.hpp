@@ -5,13 +5,14 @@
 class ReflectiveShadowMapPass : public BaseGeometryPass
 {
 public:
-    explicit ReflectiveShadowMapPass(vgfw::renderer::RenderContext& rc);
+    ReflectiveShadowMapPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
     ~ReflectiveShadowMapPass() = default;
 
-    void addToGraph(FrameGraph&                                       fg,
-                    FrameGraphBlackboard&                             blackboard,
-                    const glm::mat4&                                  lightViewProjection,
-                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives);
+    void addToGraph(FrameGraph&            fg,
+                    FrameGraphBlackboard&  blackboard,
+                    const glm::mat4&       lightViewProjection,
+                    const SceneDrawStream& drawStream,
+                    uint32_t               resolution);
 
 private:
     virtual vgfw::renderer::GraphicsPipeline createPipeline(const vgfw::renderer::VertexFormat&) override final;
@@ -3,11 +3,13 @@
 #include "pass_resource/gbuffer_data.hpp"
 #include "pass_resource/scene_color_data.hpp"
 #include "pass_resource/ssr_data.hpp"
+#include "uniforms/pass_uniforms.hpp"
 
-SsrPass::SsrPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+SsrPass::SsrPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing) : BasePass(rc), m_UniformRing(uniformRing)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/ssr.frag"));
+    auto program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                        vgfw::utils::readFileAllText("shaders/ssr.frag"));
+    addProgram(program);
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -23,11 +25,10 @@ SsrPass::SsrPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
                      .build();
 }
 
-SsrPass::~SsrPass() { m_RenderContext.destroy(m_Pipeline); }
-
 FrameGraphResource SsrPass::addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderSettings& settings)
 {
     const auto [cameraUniform] = blackboard.get<CameraData>();
+    const auto ssrUniform      = m_UniformRing.push(SSRUniform {.reflectionFactor = settings.reflectionFactor}, 1);
 
     const auto& gBuffer    = blackboard.get<GBufferData>();
     const auto  extent     = fg.getDescriptor<vgfw::renderer::framegraph::FrameGraphTexture>(gBuffer.depth).extent;
@@ -36,8 +37,6 @@ FrameGraphResource SsrPass::addToGraph(FrameGraph& fg, FrameGraphBlackboard& bla
     const auto& pass = fg.addCallbackPass<SSRData>(
         "SSR Pass",
         [&](FrameGraph::Builder& builder, SSRData& data) {
-            builder.read(cameraUniform);
-
             builder.read(gBuffer.depth);
             builder.read(gBuffer.normal);
             builder.read(gBuffer.metallicRoughnessAO);
@@ -62,9 +61,9 @@ FrameGraphResource SsrPass::addToGraph(FrameGraph& fg, FrameGraphBlackboard& bla
 
             auto&      rc          = *static_cast<vgfw::renderer::RenderContext*>(ctx);
             const auto framebuffer = rc.beginRendering(renderingInfo);
+            m_UniformRing.bind(0, cameraUniform);
+            m_UniformRing.bind(1, ssrUniform);
             rc.bindGraphicsPipeline(m_Pipeline)
-                .bindUniformBuffer(0, vgfw::renderer::framegraph::getBuffer(resources, cameraUniform))
-                .setUniform1f("reflectionFactor", settings.reflectionFactor)
                 .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, gBuffer.depth))
                 .bindTexture(1, vgfw::renderer::framegraph::getTexture(resources, gBuffer.normal))
                 .bindTexture(2, vgfw::renderer::framegraph::getTexture(resources, gBuffer.metallicRoughnessAO))
@@ -2,15 +2,18 @@
 
 #include "base_pass.hpp"
 #include "render_settings.hpp"
+#include "uniform_ring.hpp"
 
 class SsrPass : public BasePass
 {
 public:
-    explicit SsrPass(vgfw::renderer::RenderContext& rc);
-    ~SsrPass();
+    SsrPass(vgfw::renderer::RenderContext& rc, UniformRing& uniformRing);
+    ~SsrPass() = default;
 
     FrameGraphResource addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderSettings& settings);
 
 private:
+    UniformRing& m_UniformRing;
+
     vgfw::renderer::GraphicsPipeline m_Pipeline;
 };
\ No newline at end of file
@@ -2,8 +2,9 @@
 
 TonemappingPass::TonemappingPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/tonemapping.frag"));
+    auto program = getProgramCache().getGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                        vgfw::utils::readFileAllText("shaders/tonemapping.frag"));
+    addProgram(program);
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -19,8 +20,6 @@ TonemappingPass::TonemappingPass(vgfw::renderer::RenderContext& rc) : BasePass(r
                      .build();
 }
 
-TonemappingPass::~TonemappingPass() { m_RenderContext.destroy(m_Pipeline); }
-
 FrameGraphResource TonemappingPass::addToGraph(FrameGraph& fg, FrameGraphResource input)
 {
     VGFW_PROFILE_FUNCTION
@@ -6,7 +6,7 @@ class TonemappingPass : public BasePass
 {
 public:
     explicit TonemappingPass(vgfw::renderer::RenderContext& rc);
-    ~TonemappingPass();
+    ~TonemappingPass() = default;
 
     FrameGraphResource addToGraph(FrameGraph& fg, FrameGraphResource input);
 
@@ -0,0 +1,467 @@
+#include "program_cache.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    // Header of the binary files, a file of another magic or version is ignored
+    constexpr uint32_t kBinaryMagic   = 0x5050564c; // "LVPP"
+    constexpr uint32_t kBinaryVersion = 1;
+
+    struct BinaryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t driverHash;
+        uint64_t sourceHash;
+        uint32_t format; // Of glGetProgramBinary
+        uint32_t size;
+    };
+
+    // 64-bit FNV-1a, stable across runs unlike std::hash
+    constexpr uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        return hash;
+    }
+
+    // The size is hashed too, so that the concatenation of strings is not ambiguous
+    uint64_t hashString(uint64_t hash, std::string_view string)
+    {
+        const auto size = static_cast<uint64_t>(string.size());
+        return hashBytes(hashBytes(hash, &size, sizeof(size)), string.data(), string.size());
+    }
+
+    bool isLinked(GLuint program)
+    {
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        return status == GL_TRUE;
+    }
+
+    // GL_KHR_parallel_shader_compile (or its ARB twin), loaded by hand as the GL loader may not be generated with it
+    constexpr GLenum kCompletionStatus = 0x91B1; // GL_COMPLETION_STATUS_KHR
+
+    using MaxShaderCompilerThreadsProc = void(APIENTRY*)(GLuint count);
+
+    std::filesystem::path getBinaryPath(const std::filesystem::path& directory, uint64_t sourceHash)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(sourceHash));
+        return directory / name;
+    }
+} // namespace
+
+void ProgramCache::init(const std::filesystem::path& directory, CompileMode compileMode)
+{
+    m_DriverHash = kHashSeed;
+    for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION})
+    {
+        const auto* string = reinterpret_cast<const char*>(glGetString(name));
+        m_DriverHash       = hashString(m_DriverHash, string ? string : "");
+    }
+
+    // Some drivers support no binary format at all
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    m_Directory   = directory;
+    m_HasBinaries = numFormats > 0 && std::filesystem::is_directory(directory, error);
+
+    if (compileMode == CompileMode::eBlocking)
+        return;
+
+    // The driver compiles on as many threads as it likes, and the completion of a link can be polled
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile") ||
+        glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+    {
+        auto maxShaderCompilerThreads =
+            reinterpret_cast<MaxShaderCompilerThreadsProc>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        if (!maxShaderCompilerThreads)
+            maxShaderCompilerThreads =
+                reinterpret_cast<MaxShaderCompilerThreadsProc>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+
+        if (maxShaderCompilerThreads)
+        {
+            maxShaderCompilerThreads(0xFFFFFFFF); // As many as the implementation wants
+            m_Backend = Backend::eParallelShaderCompile;
+            return;
+        }
+    }
+
+    // Otherwise a worker links in a context of its own, created like the current one and sharing its objects
+    GLint majorVersion = 0, minorVersion = 0, profileMask = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+    glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &profileMask);
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, majorVersion);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minorVersion);
+    if (profileMask & GL_CONTEXT_CORE_PROFILE_BIT)
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    m_WorkerWindow = glfwCreateWindow(1, 1, "Program Cache Worker", nullptr, glfwGetCurrentContext());
+    glfwDefaultWindowHints();
+
+    if (!m_WorkerWindow)
+    {
+        std::cerr << "Failed to create the context of the program cache worker, compiling blocking" << std::endl;
+        return;
+    }
+
+    m_Backend    = Backend::eWorkerThread;
+    m_IsStopping = false;
+    m_Worker     = std::thread {&ProgramCache::runWorker, this};
+}
+
+void ProgramCache::destroy()
+{
+    if (m_Worker.joinable())
+    {
+        {
+            std::lock_guard lock {m_Mutex};
+            m_IsStopping = true;
+        }
+        m_Condition.notify_all();
+        m_Worker.join();
+    }
+    if (m_WorkerWindow)
+    {
+        glfwDestroyWindow(m_WorkerWindow);
+        m_WorkerWindow = nullptr;
+    }
+    m_Jobs.clear();
+    m_FinishedJobs.clear();
+    m_Backend = Backend::eBlocking;
+
+    for (const auto& [program, pending] : m_Pending)
+    {
+        for (const auto shader : pending.shaders)
+            glDeleteShader(shader);
+    }
+    m_Pending.clear();
+    m_Stats.numPending = 0;
+
+    for (const auto& [_, program] : m_Programs)
+        glDeleteProgram(program);
+    m_Programs.clear();
+}
+
+GLuint ProgramCache::getGraphicsProgram(const std::string&                vertexSource,
+                                        const std::string&                fragmentSource,
+                                        const std::optional<std::string>& geometrySource)
+{
+    std::vector<Stage> stages {{GL_VERTEX_SHADER, vertexSource}};
+    if (geometrySource)
+        stages.push_back({GL_GEOMETRY_SHADER, *geometrySource});
+    stages.push_back({GL_FRAGMENT_SHADER, fragmentSource});
+    return getProgram(std::move(stages));
+}
+
+GLuint ProgramCache::getComputeProgram(const std::string& computeSource)
+{
+    return getProgram({{GL_COMPUTE_SHADER, computeSource}});
+}
+
+bool ProgramCache::isReady(GLuint program)
+{
+    const auto it = m_Pending.find(program);
+    if (it == m_Pending.end())
+        return true;
+
+    if (m_Backend == Backend::eWorkerThread)
+    {
+        pollWorker();
+        return !m_Pending.contains(program);
+    }
+
+    GLint isCompleted = GL_FALSE;
+    glGetProgramiv(program, kCompletionStatus, &isCompleted);
+    if (isCompleted != GL_TRUE)
+        return false;
+
+    VGFW_PROFILE_NAMED_SCOPE("Finish Program");
+    const auto pending = std::move(it->second);
+    m_Pending.erase(it);
+    --m_Stats.numPending;
+
+    endCompile(program, pending.shaders);
+    saveBinary(pending.sourceHash, program);
+    ++m_Stats.numCompiled;
+    return true;
+}
+
+bool ProgramCache::isReady(std::span<const GLuint> programs)
+{
+    // Every program is polled, so that the ones done are finished even when an earlier one is not
+    bool isEveryReady = true;
+    for (const auto program : programs)
+        isEveryReady = isReady(program) && isEveryReady;
+    return isEveryReady;
+}
+
+bool ProgramCache::isEveryProgramReady()
+{
+    std::vector<GLuint> programs;
+    for (const auto& [program, _] : m_Pending)
+        programs.push_back(program);
+    return isReady(programs);
+}
+
+const char* ProgramCache::getCompileModeName() const
+{
+    switch (m_Backend)
+    {
+        case Backend::eParallelShaderCompile:
+            return "KHR_parallel_shader_compile";
+        case Backend::eWorkerThread:
+            return "worker thread";
+        default:
+            return "blocking";
+    }
+}
+
+GLuint ProgramCache::getProgram(std::vector<Stage> stages)
+{
+    auto sourceHash = kHashSeed;
+    for (const auto& stage : stages)
+    {
+        sourceHash = hashBytes(sourceHash, &stage.type, sizeof(stage.type));
+        sourceHash = hashString(sourceHash, stage.source);
+    }
+
+    if (const auto it = m_Programs.find(sourceHash); it != m_Programs.end())
+    {
+        ++m_Stats.numShared;
+        return it->second;
+    }
+
+    VGFW_PROFILE_NAMED_SCOPE("Get Program");
+    const auto start = std::chrono::steady_clock::now();
+
+    auto program = loadBinary(sourceHash);
+    if (program)
+    {
+        ++m_Stats.numLoaded;
+    }
+    else
+    {
+        program = glCreateProgram();
+        switch (m_Backend)
+        {
+            case Backend::eBlocking:
+                endCompile(program, beginCompile(program, stages));
+                saveBinary(sourceHash, program);
+                ++m_Stats.numCompiled;
+                break;
+
+            case Backend::eParallelShaderCompile:
+                m_Pending.emplace(program, PendingProgram {sourceHash, beginCompile(program, stages)});
+                ++m_Stats.numPending;
+                break;
+
+            case Backend::eWorkerThread:
+                m_Pending.emplace(program, PendingProgram {sourceHash, {}});
+                ++m_Stats.numPending;
+                {
+                    std::lock_guard lock {m_Mutex};
+                    m_Jobs.push_back({program, sourceHash, std::move(stages)});
+                }
+                m_Condition.notify_all();
+                break;
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    m_Stats.milliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+
+    m_Programs.emplace(sourceHash, program);
+    return program;
+}
+
+std::vector<GLuint> ProgramCache::beginCompile(GLuint program, const std::vector<Stage>& stages) const
+{
+    std::vector<GLuint> shaders;
+    for (const auto& stage : stages)
+    {
+        const auto  shader = glCreateShader(stage.type);
+        const auto* source = stage.source.c_str();
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        glAttachShader(program, shader);
+        shaders.push_back(shader);
+    }
+
+    // The driver may not keep a binary it was not asked for
+    if (m_HasBinaries)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+
+    return shaders;
+}
+
+void ProgramCache::endCompile(GLuint program, const std::vector<GLuint>& shaders) const
+{
+    const auto isProgramLinked = isLinked(program);
+
+    std::string log;
+    for (const auto shader : shaders)
+    {
+        GLint status = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE)
+        {
+            GLint length = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+            std::string shaderLog(std::max(length, 1), '\0');
+            glGetShaderInfoLog(shader, length, nullptr, shaderLog.data());
+            log += shaderLog.c_str();
+        }
+
+        glDetachShader(program, shader);
+        glDeleteShader(shader);
+    }
+
+    if (!isProgramLinked)
+    {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::string programLog(std::max(length, 1), '\0');
+        glGetProgramInfoLog(program, length, nullptr, programLog.data());
+        log += programLog.c_str();
+
+        throw std::runtime_error("Failed to build a program:\n" + log);
+    }
+}
+
+GLuint ProgramCache::loadBinary(uint64_t sourceHash) const
+{
+    if (!m_HasBinaries)
+        return 0;
+
+    std::ifstream file {getBinaryPath(m_Directory, sourceHash), std::ios::binary};
+
+    BinaryHeader header {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kBinaryMagic ||
+        header.version != kBinaryVersion || header.driverHash != m_DriverHash || header.sourceHash != sourceHash)
+        return 0;
+
+    std::vector<char> binary(header.size);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+        return 0;
+
+    const auto program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Drivers may reject binaries for reasons of their own, even with the same version strings
+    if (!isLinked(program))
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void ProgramCache::saveBinary(uint64_t sourceHash, GLuint program) const
+{
+    if (!m_HasBinaries)
+        return;
+
+    GLint size = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0)
+        return;
+
+    std::vector<char> binary(size);
+    GLenum            format = 0;
+    glGetProgramBinary(program, size, nullptr, &format, binary.data());
+
+    const BinaryHeader header {
+        .magic      = kBinaryMagic,
+        .version    = kBinaryVersion,
+        .driverHash = m_DriverHash,
+        .sourceHash = sourceHash,
+        .format     = format,
+        .size       = static_cast<uint32_t>(size),
+    };
+
+    const auto    path = getBinaryPath(m_Directory, sourceHash);
+    std::ofstream file {path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), size);
+    if (!file)
+        std::cerr << "Failed to write the program binary: " << path << std::endl;
+}
+
+void ProgramCache::pollWorker()
+{
+    std::vector<FinishedJob> finishedJobs;
+    {
+        std::lock_guard lock {m_Mutex};
+        finishedJobs.swap(m_FinishedJobs);
+    }
+
+    for (const auto& job : finishedJobs)
+    {
+        m_Pending.erase(job.program);
+        --m_Stats.numPending;
+        if (!job.error.empty())
+            throw std::runtime_error(job.error);
+        ++m_Stats.numCompiled;
+    }
+}
+
+void ProgramCache::runWorker()
+{
+    glfwMakeContextCurrent(m_WorkerWindow);
+
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock {m_Mutex};
+            m_Condition.wait(lock, [this] { return m_IsStopping || !m_Jobs.empty(); });
+            if (m_IsStopping)
+                break;
+
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+        }
+
+        FinishedJob finishedJob {.program = job.program};
+        {
+            VGFW_PROFILE_NAMED_SCOPE("Link Program");
+            try
+            {
+                endCompile(job.program, beginCompile(job.program, job.stages));
+                saveBinary(job.sourceHash, job.program);
+            }
+            catch (const std::exception& e)
+            {
+                finishedJob.error = e.what();
+            }
+
+            // The link has to be complete before the context of the passes binds the program
+            glFinish();
+        }
+
+        std::lock_guard lock {m_Mutex};
+        m_FinishedJobs.push_back(std::move(finishedJob));
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+ProgramCache& getProgramCache()
+{
+    static ProgramCache cache;
+    return cache;
+}
\ No newline at end of file
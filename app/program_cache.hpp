@@ -0,0 +1,125 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <thread>
+
+// Process-wide cache of the linked programs, keyed by a hash of their sources as compiled (preprocessed at build time,
+// with the #defines of the variant). A program is compiled once however many passes and vertex formats use it, and
+// owned by the cache: pipelines built with it must not destroy it. Linked programs are also written to a directory
+// with glGetProgramBinary, a later launch links them from there. A binary of another driver, of another source or
+// that the driver rejects is compiled again from source.
+//
+// Programs compiled in parallel are returned before they are linked, they must not be used before isReady().
+class ProgramCache
+{
+public:
+    enum class CompileMode
+    {
+        eBlocking, // Compiled and linked before get*Program() returns
+        eParallel, // By the driver threads with GL_KHR_parallel_shader_compile, or by a worker with a shared context
+    };
+
+    // Without a directory, the programs are only shared in memory. Without init(), they are compiled blocking.
+    void init(const std::filesystem::path& directory, CompileMode compileMode = CompileMode::eParallel);
+    // Deletes every program
+    void destroy();
+
+    GLuint getGraphicsProgram(const std::string&                vertexSource,
+                              const std::string&                fragmentSource,
+                              const std::optional<std::string>& geometrySource = std::nullopt);
+    GLuint getComputeProgram(const std::string& computeSource);
+
+    // Never blocks on a link. Programs done linking are checked, throwing on a failure, and their binaries saved.
+    bool isReady(GLuint program);
+    bool isReady(std::span<const GLuint> programs);
+    // Of every program requested so far
+    bool isEveryProgramReady();
+
+    // Of the programs compiled in parallel: "KHR_parallel_shader_compile", "worker thread" or "blocking"
+    const char* getCompileModeName() const;
+
+    struct Stats
+    {
+        uint32_t numShared {0};      // Requests served by a program already linked or linking
+        uint32_t numLoaded {0};      // Linked from a binary of the directory
+        uint32_t numCompiled {0};    // Compiled from source
+        uint32_t numPending {0};     // Compiling in parallel
+        double   milliseconds {0.0}; // Spent loading, compiling or issuing the compiles on the calling thread
+    };
+
+    const Stats& getStats() const { return m_Stats; }
+
+private:
+    enum class Backend
+    {
+        eBlocking,
+        eParallelShaderCompile,
+        eWorkerThread,
+    };
+
+    struct Stage
+    {
+        GLenum      type;
+        std::string source;
+    };
+
+    // Shaders of a program linking, kept until it is done for the logs
+    struct PendingProgram
+    {
+        uint64_t            sourceHash;
+        std::vector<GLuint> shaders;
+    };
+
+    struct Job
+    {
+        GLuint             program;
+        uint64_t           sourceHash;
+        std::vector<Stage> stages;
+    };
+
+    struct FinishedJob
+    {
+        GLuint      program;
+        std::string error; // Empty when linked
+    };
+
+    GLuint getProgram(std::vector<Stage> stages);
+
+    // Issues the compiles and the link without waiting for them
+    std::vector<GLuint> beginCompile(GLuint program, const std::vector<Stage>& stages) const;
+    // Waits for the link, throws with the logs of the shaders and of the program when it failed
+    void endCompile(GLuint program, const std::vector<GLuint>& shaders) const;
+
+    GLuint loadBinary(uint64_t sourceHash) const;
+    void   saveBinary(uint64_t sourceHash, GLuint program) const;
+
+    void pollWorker();
+    void runWorker();
+
+    std::filesystem::path m_Directory;
+    uint64_t              m_DriverHash {0}; // Of the vendor, renderer and version strings
+    bool                  m_HasBinaries {false};
+    Backend               m_Backend {Backend::eBlocking};
+
+    std::unordered_map<uint64_t, GLuint>       m_Programs;
+    std::unordered_map<GLuint, PendingProgram> m_Pending;
+    Stats                                      m_Stats;
+
+    // Worker thread of the eWorkerThread backend, linking in the context of a hidden window sharing objects with the
+    // one of init(). It calls glFinish before a program is handed back, so that the link is visible to that context.
+    GLFWwindow*              m_WorkerWindow {nullptr};
+    std::thread              m_Worker;
+    std::mutex               m_Mutex;
+    std::condition_variable  m_Condition;
+    std::deque<Job>          m_Jobs;
+    std::vector<FinishedJob> m_FinishedJobs;
+    bool                     m_IsStopping {false};
+};
+
+ProgramCache& getProgramCache();
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+enum class PropagationMode
+{
+    eGeometryShader = 0, // One point per VPL, expanded to the cell layer by radiance_propagation.geom
+    eCompute,            // One invocation per cell, ping-pong between persistent volumes
+    eAmortized,          // Compute, with the iterations spread over several frames
+};
\ No newline at end of file
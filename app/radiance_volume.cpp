@@ -0,0 +1,212 @@
+#include "radiance_volume.hpp"
+
+#include "lpv_config.hpp"
+#include "program_cache.hpp"
+
+namespace
+{
+    vgfw::renderer::PixelFormat getSHVolumeFormat(SHEncoding encoding)
+    {
+        return encoding == SHEncoding::eRGBA16F ? vgfw::renderer::PixelFormat::eRGBA16F :
+                                                  vgfw::renderer::PixelFormat::eRGBA32UI;
+    }
+
+    // Packed cells are decoded before they get filtered, see SH_SampleVolume
+    vgfw::renderer::TexelFilter getSHVolumeFilter(SHEncoding encoding)
+    {
+        return encoding == SHEncoding::eRGBA16F ? vgfw::renderer::TexelFilter::eLinear :
+                                                  vgfw::renderer::TexelFilter::eNearest;
+    }
+} // namespace
+
+void RadianceVolume::create(vgfw::renderer::RenderContext& rc,
+                            const glm::uvec3&              volumeSize,
+                            SHEncoding                     volumeEncoding)
+{
+    size     = volumeSize;
+    encoding = volumeEncoding;
+
+    const auto extent = vgfw::renderer::Extent2D {.width = size.x, .height = size.y};
+    const auto filter = getSHVolumeFilter(encoding);
+    for (auto* texture : {&r, &g, &b})
+    {
+        if (texture != &r && getNumSHVolumes(encoding) == 1)
+            break;
+
+        *texture = rc.createTexture3D(extent, size.z, getSHVolumeFormat(encoding));
+        rc.setupSampler(*texture,
+                        {
+                            .minFilter    = filter,
+                            .mipmapMode   = vgfw::renderer::MipmapMode::eNone,
+                            .magFilter    = filter,
+                            .addressModeS = vgfw::renderer::SamplerAddressMode::eClampToBorder,
+                            .addressModeT = vgfw::renderer::SamplerAddressMode::eClampToBorder,
+                            .addressModeR = vgfw::renderer::SamplerAddressMode::eClampToBorder,
+                            .borderColor  = glm::vec4 {0.0f},
+                        });
+    }
+}
+
+void RadianceVolume::destroy(vgfw::renderer::RenderContext& rc)
+{
+    if (!isValid())
+        return;
+
+    rc.destroy(r);
+    if (getNumSHVolumes(encoding) == 3)
+        rc.destroy(g).destroy(b);
+    size = glm::uvec3 {0};
+}
+
+bool RadianceVolume::resize(vgfw::renderer::RenderContext& rc,
+                            const glm::uvec3&              volumeSize,
+                            SHEncoding                     volumeEncoding)
+{
+    if (size == volumeSize && encoding == volumeEncoding)
+        return false;
+
+    destroy(rc);
+    create(rc, volumeSize, volumeEncoding);
+    return true;
+}
+
+RadianceData RadianceVolume::import(FrameGraph& fg, const std::string& name)
+{
+    assert(isValid());
+
+    if (getNumSHVolumes(encoding) == 1)
+    {
+        return {
+            .r        = vgfw::renderer::framegraph::importTexture(fg, name + " SH", &r),
+            .encoding = encoding,
+        };
+    }
+
+    return {
+        .r        = vgfw::renderer::framegraph::importTexture(fg, name + " SH-R", &r),
+        .g        = vgfw::renderer::framegraph::importTexture(fg, name + " SH-G", &g),
+        .b        = vgfw::renderer::framegraph::importTexture(fg, name + " SH-B", &b),
+        .encoding = encoding,
+    };
+}
+
+void SHEncodingPrograms::create(const std::string& path, const ShaderDefines& defines)
+{
+    const auto source = vgfw::utils::readFileAllText(path);
+    for (uint32_t i = 0; i < kNumSHEncodings; ++i)
+    {
+        auto variantDefines = defines;
+        variantDefines.emplace_back("SH_ENCODING", std::to_string(i));
+        programs[i] = getProgramCache().getComputeProgram(addShaderDefines(source, variantDefines));
+    }
+}
+
+void GridSizePrograms::create(const std::string& path, const ShaderDefines& defines)
+{
+    m_Path    = path;
+    m_Defines = defines;
+    m_Generic.create(path, defines);
+}
+
+const SHEncodingPrograms& GridSizePrograms::get(const glm::uvec3& gridSize)
+{
+    const auto resolution = std::max({gridSize.x, gridSize.y, gridSize.z});
+    if (std::ranges::find(kLPVResolutions, resolution) == kLPVResolutions.end())
+        return m_Generic;
+
+    auto [it, isNew] = m_Specialized.try_emplace({gridSize.x, gridSize.y, gridSize.z});
+    if (isNew)
+    {
+        auto defines = m_Defines;
+        defines.emplace_back("LPV_GRID_SIZE", fmt::format("ivec3({0}, {1}, {2})", gridSize.x, gridSize.y, gridSize.z));
+        it->second.create(m_Path, defines);
+    }
+    return getProgramCache().isReady(it->second.programs) ? it->second : m_Generic;
+}
+
+bool GridSizePrograms::isReady() const { return getProgramCache().isReady(m_Generic.programs); }
+
+RadianceData createRadianceData(FrameGraph::Builder& builder,
+                                const std::string&   name,
+                                const glm::uvec3&    size,
+                                SHEncoding           encoding)
+{
+    const auto extent = vgfw::renderer::Extent2D {.width = size.x, .height = size.y};
+    const auto createVolume = [&](const std::string& channel) {
+        return builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
+            name + " " + channel,
+            {
+                .extent   = extent,
+                .depth    = size.z,
+                .format   = getSHVolumeFormat(encoding),
+                .wrapMode = vgfw::renderer::WrapMode::eClampToOpaqueBlack,
+                .filter   = getSHVolumeFilter(encoding),
+            });
+    };
+
+    if (getNumSHVolumes(encoding) == 1)
+        return {.r = createVolume("SH"), .encoding = encoding};
+
+    return {
+        .r        = createVolume("SH-R"),
+        .g        = createVolume("SH-G"),
+        .b        = createVolume("SH-B"),
+        .encoding = encoding,
+    };
+}
+
+void readRadianceData(FrameGraph::Builder& builder, const RadianceData& radianceData)
+{
+    for (const auto volume : radianceData.getVolumes())
+        builder.read(volume);
+}
+
+RadianceData writeRadianceData(FrameGraph::Builder& builder, const RadianceData& radianceData)
+{
+    auto data = radianceData;
+    data.r    = builder.write(data.r);
+    if (getNumSHVolumes(data.encoding) == 3)
+    {
+        data.g = builder.write(data.g);
+        data.b = builder.write(data.b);
+    }
+    return data;
+}
+
+void clearRadianceData(FrameGraphPassResources& resources, const RadianceData& radianceData)
+{
+    const bool isPacked = getNumSHVolumes(radianceData.encoding) == 1;
+    for (const auto volume : radianceData.getVolumes())
+    {
+        const auto& texture = vgfw::renderer::framegraph::getTexture(resources, volume);
+        glClearTexImage(static_cast<GLuint>(texture),
+                        0,
+                        isPacked ? GL_RGBA_INTEGER : GL_RGBA,
+                        isPacked ? GL_UNSIGNED_INT : GL_HALF_FLOAT,
+                        nullptr);
+    }
+}
+
+void dispatchRadianceKernel(vgfw::renderer::RenderContext& rc,
+                            FrameGraphPassResources&       resources,
+                            const SHEncodingPrograms&      programs,
+                            const RadianceData&            src,
+                            const RadianceData&            dst,
+                            const glm::uvec3&              gridSize)
+{
+    assert(src.encoding == dst.encoding);
+
+    constexpr auto kLocalSize = 4u;
+
+    const auto srcVolumes = src.getVolumes();
+    const auto dstVolumes = dst.getVolumes();
+    for (uint32_t i = 0; i < srcVolumes.size(); ++i)
+    {
+        rc.bindTexture(i, vgfw::renderer::framegraph::getTexture(resources, srcVolumes[i]))
+            .bindImage(i, vgfw::renderer::framegraph::getTexture(resources, dstVolumes[i]), 0, GL_WRITE_ONLY);
+    }
+    rc.dispatch(programs[dst.encoding], (gridSize + kLocalSize - 1u) / kLocalSize);
+
+    // Whatever comes next samples what has just been written
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
\ No newline at end of file
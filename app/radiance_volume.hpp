@@ -0,0 +1,83 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include "pass_resource/radiance_data.hpp"
+#include "shader_source.hpp"
+
+#include <map>
+
+// Persistent SH-R/G/B volumes that outlive a single FrameGraph, only r is used by a packed encoding
+struct RadianceVolume
+{
+    vgfw::renderer::Texture r;
+    vgfw::renderer::Texture g;
+    vgfw::renderer::Texture b;
+    glm::uvec3              size {0};
+    SHEncoding              encoding {SHEncoding::eRGBA16F};
+
+    void create(vgfw::renderer::RenderContext& rc, const glm::uvec3& volumeSize, SHEncoding volumeEncoding);
+    void destroy(vgfw::renderer::RenderContext& rc);
+
+    // (Re)creates the volumes when the grid size or the encoding changes, returns true if the content got lost
+    bool resize(vgfw::renderer::RenderContext& rc,
+                const glm::uvec3&              volumeSize,
+                SHEncoding                     volumeEncoding = SHEncoding::eRGBA16F);
+
+    bool isValid() const { return size != glm::uvec3 {0}; }
+
+    RadianceData import(FrameGraph& fg, const std::string& name);
+};
+
+// One variant of a compute program per SH encoding, compiled with SH_ENCODING defined (see lib/sh_volume.glsl) on top
+// of the given defines. The ProgramCache owns the programs.
+struct SHEncodingPrograms
+{
+    std::array<GLuint, kNumSHEncodings> programs {};
+
+    void create(const std::string& path, const ShaderDefines& defines = {});
+
+    GLuint operator[](SHEncoding encoding) const { return programs[static_cast<uint32_t>(encoding)]; }
+};
+
+// SHEncodingPrograms specialized for the grid sizes of the selectable LPV resolutions (LPV_GRID_SIZE, see
+// lib/sh_volume.glsl), compiled the first time a grid of the size is met. Other grids get the generic variants, and so
+// do the grids whose variants are still linking.
+class GridSizePrograms
+{
+public:
+    void create(const std::string& path, const ShaderDefines& defines = {});
+
+    const SHEncodingPrograms& get(const glm::uvec3& gridSize);
+    const SHEncodingPrograms& getGeneric() const { return m_Generic; }
+    // Whether the generic variants are linked
+    bool isReady() const;
+
+private:
+    std::string                                           m_Path;
+    ShaderDefines                                         m_Defines;
+    SHEncodingPrograms                                    m_Generic;
+    std::map<std::array<uint32_t, 3>, SHEncodingPrograms> m_Specialized;
+};
+
+// Creates transient volumes for a FrameGraph pass
+RadianceData createRadianceData(FrameGraph::Builder& builder,
+                                const std::string&   name,
+                                const glm::uvec3&    size,
+                                SHEncoding           encoding);
+
+// Declares every volume of a RadianceData as read, or written, by a FrameGraph pass
+void         readRadianceData(FrameGraph::Builder& builder, const RadianceData& radianceData);
+RadianceData writeRadianceData(FrameGraph::Builder& builder, const RadianceData& radianceData);
+
+// Zeroes every volume
+void clearRadianceData(FrameGraphPassResources& resources, const RadianceData& radianceData);
+
+// Runs a 4x4x4 compute kernel reading SH volumes from texture units 0-2 and writing them to image units 0-2, both
+// volumes share the encoding of the program variant
+void dispatchRadianceKernel(vgfw::renderer::RenderContext& rc,
+                            FrameGraphPassResources&       resources,
+                            const SHEncodingPrograms&      programs,
+                            const RadianceData&            src,
+                            const RadianceData&            dst,
+                            const glm::uvec3&              gridSize);
\ No newline at end of file
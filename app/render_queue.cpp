@@ -0,0 +1,43 @@
+#include "render_queue.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+uint64_t RenderQueue::makeKey(uint32_t batchIndex, uint32_t materialIndex, float depth)
+{
+    assert(batchIndex < (1u << kBatchBits) && materialIndex < (1u << kMaterialBits));
+
+    // Flips the bits of the negative floats and the sign bit of the positive ones, so the depths compare like
+    // unsigned integers
+    const auto bits     = std::bit_cast<uint32_t>(depth);
+    const auto depthKey = bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+
+    return static_cast<uint64_t>(batchIndex) << (kMaterialBits + kDepthBits) |
+           static_cast<uint64_t>(materialIndex) << kDepthBits | depthKey;
+}
+
+void RenderQueue::sort()
+{
+    m_Scratch.resize(m_Items.size());
+
+    for (uint32_t shift = 0; shift < 64; shift += 8)
+    {
+        std::array<uint32_t, 256> offsets {};
+        for (const auto& item : m_Items)
+            ++offsets[(item.key >> shift) & 0xFF];
+
+        // Every key has the same byte, the pass would not move anything
+        if (offsets[(m_Items.empty() ? 0 : m_Items.front().key >> shift) & 0xFF] == m_Items.size())
+            continue;
+
+        uint32_t offset = 0;
+        for (auto& count : offsets)
+            offset += std::exchange(count, offset);
+
+        for (const auto& item : m_Items)
+            m_Scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+        m_Items.swap(m_Scratch);
+    }
+}
\ No newline at end of file
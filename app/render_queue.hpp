@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Draws of a pass ordered by 64-bit keys: the batch (vertex format, so pipeline, and merged buffers) in the most
+// significant bits, then the material, then the clip space depth, so the draws sharing state are adjacent and drawn
+// front to back. The keys are sorted with a LSD radix sort over their bytes.
+class RenderQueue
+{
+public:
+    static constexpr uint32_t kBatchBits    = 12;
+    static constexpr uint32_t kMaterialBits = 20;
+    static constexpr uint32_t kDepthBits    = 32;
+    static_assert(kBatchBits + kMaterialBits + kDepthBits == 64);
+
+    struct Item
+    {
+        uint64_t key;
+        uint32_t drawIndex;
+    };
+
+    static uint64_t makeKey(uint32_t batchIndex, uint32_t materialIndex, float depth);
+
+    void clear() { m_Items.clear(); }
+    void push(uint64_t key, uint32_t drawIndex) { m_Items.push_back({key, drawIndex}); }
+
+    // Stable, the bytes every key has in common are skipped
+    void sort();
+
+    std::span<const Item> getItems() const { return m_Items; }
+
+private:
+    std::vector<Item> m_Items;
+    std::vector<Item> m_Scratch;
+};
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "lpv_config.hpp"
+#include "culling_mode.hpp"
+#include "injection_mode.hpp"
 #include "passes/hbao_pass.hpp"
+#include "propagation_mode.hpp"
 #include "render_target.hpp"
+#include "sh_encoding.hpp"
 #include "visual_mode.hpp"
 
 struct RenderSettings
@@ -18,8 +23,38 @@ struct RenderSettings
     bool enableFXAA  = true;
     bool enableBloom = true;
 
+    // Fullscreen passes use variants specialized for the settings rather than branching on them (ShaderPermutations)
+    bool enableShaderPermutations = true;
+
+    // Scene submission
+    bool        enableDrawSorting = true; // Views sort their draws by batch, material and depth (RenderQueue)
+    CullingMode cullingMode       = CullingMode::eFrustum;
+
+    // RSM settings
+    uint32_t      rsmResolution    = kRSMResolution;
+    InjectionMode lpvInjectionMode = InjectionMode::eRaster;
+
     // LPV settings
-    int lpvIteration = 12;
+    uint32_t        lpvResolution         = kLPVResolution; // Cells along the longest axis of the grid (cascades)
+    int             lpvIteration          = 12;
+    int             lpvIterationsPerFrame = 4; // Budget of the amortized propagation mode
+    PropagationMode lpvPropagationMode    = PropagationMode::eCompute;
+    bool            enableLPVBrickMask    = false; // Compute propagation of the bricks radiance has reached only
+    int             lpvFusedIterations    = 1;     // Compute propagation iterations per dispatch
+    bool            enableLPVCache        = true;
+    bool            enableBakedLPV        = false; // Static lighting from a baked volume, no RSM/injection/propagation
+    SHEncoding      lpvSHEncoding         = SHEncoding::eRGBA16F; // Storage of the volumes written by compute
+
+    // Adaptive LPV iterations, stop propagating once an iteration changes the volume by less than the threshold
+    bool  enableAdaptiveLPVIterations = false;
+    float lpvConvergenceThreshold     = 0.01f; // Relative energy delta
+    int   lpvMinIterations            = 4;
+    int   lpvMaxIterations            = 64;
+
+    // LPV cascades, a single cascade uses the static scene grid
+    int                              lpvNumCascades       = 1;
+    float                            lpvCascadeCellSize   = 1.0f; // Cell size of the finest cascade
+    std::array<int, kMaxLPVCascades> lpvCascadeIterations = {12, 8, 6, 4};
 
     // HBAO properties
     HBAOProperties hbaoProperties {};
@@ -0,0 +1,472 @@
+#include "scene_draw_stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <numeric>
+
+namespace
+{
+    // A material as vgfw binds it: its PrimitiveMaterial uniform block and the textures the block indexes
+    struct MaterialBindings
+    {
+        GLuint                                   buffer {0};
+        std::array<GLuint, kNumMaterialTextures> textures {};
+        std::array<GLuint, kNumMaterialTextures> samplers {};
+        std::array<GLint, kNumMaterialTextures>  units {};
+
+        auto operator<=>(const MaterialBindings&) const = default;
+    };
+
+    // vgfw keeps the material of a primitive behind bindMeshPrimitiveMaterialBuffer/Textures, it is read back from the
+    // bindings those make
+    MaterialBindings captureMaterial(vgfw::renderer::RenderContext& rc, const vgfw::resource::MeshPrimitive& primitive)
+    {
+        constexpr uint32_t kCaptureBinding = 0;
+        rc.bindMeshPrimitiveMaterialBuffer(kCaptureBinding, primitive).bindMeshPrimitiveTextures(0, primitive);
+
+        MaterialBindings material;
+        GLint            buffer = 0;
+        glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, kCaptureBinding, &buffer);
+        material.buffer = static_cast<GLuint>(buffer);
+
+        // Texture indices of the std140 block, one int per slot
+        std::array<GLint, kNumMaterialTextures> textureIndices;
+        glGetNamedBufferSubData(material.buffer, 0, sizeof(textureIndices), textureIndices.data());
+        for (uint32_t slot = 0; slot < kNumMaterialTextures; ++slot)
+        {
+            const auto unit = textureIndices[slot];
+            if (unit < 0 || unit >= static_cast<GLint>(kNumMaterialTextures))
+                continue;
+
+            GLint texture = 0, sampler = 0;
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+            glGetIntegerv(GL_SAMPLER_BINDING, &sampler);
+            material.textures[slot] = static_cast<GLuint>(texture);
+            material.samplers[slot] = static_cast<GLuint>(sampler);
+            material.units[slot]    = unit;
+        }
+        glActiveTexture(GL_TEXTURE0);
+
+        return material;
+    }
+
+    GLenum getIndexType(GLsizei indexStride)
+    {
+        switch (indexStride)
+        {
+            case 1:
+                return GL_UNSIGNED_BYTE;
+            case 2:
+                return GL_UNSIGNED_SHORT;
+            default:
+                return GL_UNSIGNED_INT;
+        }
+    }
+
+    GLuint createBuffer(GLsizeiptr size, const void* data, GLbitfield flags = 0)
+    {
+        GLuint buffer = 0;
+        glCreateBuffers(1, &buffer);
+        glNamedBufferStorage(buffer, size, data, flags);
+        return buffer;
+    }
+
+    // Bounds of the 8 corners of the model space AABB of a primitive
+    void addWorldBounds(lpv_cpu::AABBSet& bounds, const vgfw::resource::MeshPrimitive& primitive)
+    {
+        glm::vec3 min {std::numeric_limits<float>::max()};
+        glm::vec3 max {std::numeric_limits<float>::lowest()};
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            const glm::vec3 corner {
+                i & 1 ? primitive.aabb.max.x : primitive.aabb.min.x,
+                i & 2 ? primitive.aabb.max.y : primitive.aabb.min.y,
+                i & 4 ? primitive.aabb.max.z : primitive.aabb.min.z,
+            };
+            const auto world = glm::vec3 {primitive.modelMatrix * glm::vec4 {corner, 1.0f}};
+            min              = glm::min(min, world);
+            max              = glm::max(max, world);
+        }
+        bounds.add({min.x, min.y, min.z}, {max.x, max.y, max.z});
+    }
+
+    // Copies every distinct buffer once into a merged buffer, returns the offset of each in elements of `stride`
+    template<typename GetBuffer>
+    std::map<GLuint, GLuint> mergeBuffers(const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
+                                          const std::vector<uint32_t>&                      primitiveIndices,
+                                          GLsizei                                           stride,
+                                          GetBuffer                                         getBuffer,
+                                          GLuint&                                           mergedBuffer)
+    {
+        std::map<GLuint, GLuint>                   offsets;
+        std::vector<std::pair<GLuint, GLsizeiptr>> sources;
+        GLsizeiptr                                 mergedSize = 0;
+        for (const auto index : primitiveIndices)
+        {
+            const auto& buffer = getBuffer(meshPrimitives[index]);
+            const auto  id     = static_cast<GLuint>(buffer);
+            if (offsets.try_emplace(id, static_cast<GLuint>(mergedSize / stride)).second)
+            {
+                sources.emplace_back(id, buffer.getSize());
+                mergedSize += buffer.getSize();
+            }
+        }
+
+        mergedBuffer = createBuffer(mergedSize, nullptr);
+        for (const auto& [id, size] : sources)
+            glCopyNamedBufferSubData(id, mergedBuffer, 0, offsets.at(id) * stride, size);
+        return offsets;
+    }
+} // namespace
+
+bool hasBindlessMaterials()
+{
+#ifdef GL_ARB_bindless_texture
+    return GLAD_GL_ARB_bindless_texture != 0;
+#else
+    return false;
+#endif
+}
+
+ShaderDefines getMaterialShaderDefines()
+{
+    if (hasBindlessMaterials())
+        return {{"BINDLESS_MATERIALS", "1"}};
+    return {};
+}
+
+SceneDrawStream::SceneDrawStream(vgfw::renderer::RenderContext&                    rc,
+                                 const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives) :
+    m_MeshPrimitives(meshPrimitives), m_IsBindless(hasBindlessMaterials())
+{
+    // Primitives sharing a vertex format and an index type can share buffers
+    std::map<std::pair<size_t, GLsizei>, std::vector<uint32_t>> batchPrimitives;
+    for (uint32_t i = 0; i < meshPrimitives.size(); ++i)
+    {
+        const auto& primitive = meshPrimitives[i];
+        batchPrimitives[{primitive.vertexFormat->getHash(), primitive.indexBuffer.getStride()}].push_back(i);
+    }
+
+    std::map<MaterialBindings, uint32_t> materialIndices;
+    std::vector<MaterialBindings>        materials;
+    std::vector<uint32_t>                primitiveMaterials(meshPrimitives.size());
+    for (uint32_t i = 0; i < meshPrimitives.size(); ++i)
+    {
+        const auto material = captureMaterial(rc, meshPrimitives[i]);
+        const auto [it, isNew] =
+            materialIndices.try_emplace(material, static_cast<uint32_t>(materialIndices.size()));
+        if (isNew)
+            materials.push_back(material);
+        primitiveMaterials[i] = it->second;
+    }
+
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<DrawData>                    draws;
+    for (auto& [key, primitiveIndices] : batchPrimitives)
+    {
+        // Draws of a material are contiguous, a material run is a multi-draw without bindless textures
+        std::ranges::stable_sort(primitiveIndices, {}, [&](uint32_t i) { return primitiveMaterials[i]; });
+
+        const auto& front = meshPrimitives[primitiveIndices.front()];
+
+        Batch batch {
+            .vertexFormat = front.vertexFormat,
+            .vertexStride = front.vertexBuffer.getStride(),
+            .indexType    = getIndexType(key.second),
+            .firstCommand = static_cast<uint32_t>(commands.size()),
+            .numCommands  = static_cast<uint32_t>(primitiveIndices.size()),
+        };
+
+        const auto vertexOffsets = mergeBuffers(
+            meshPrimitives,
+            primitiveIndices,
+            batch.vertexStride,
+            [](const vgfw::resource::MeshPrimitive& primitive) -> const auto& { return primitive.vertexBuffer; },
+            batch.vertexBuffer);
+        const auto indexOffsets = mergeBuffers(
+            meshPrimitives,
+            primitiveIndices,
+            key.second,
+            [](const vgfw::resource::MeshPrimitive& primitive) -> const auto& { return primitive.indexBuffer; },
+            batch.indexBuffer);
+
+        for (const auto i : primitiveIndices)
+        {
+            const auto& primitive    = meshPrimitives[i];
+            const auto& geometryInfo = primitive.geometryInfo;
+            const auto  drawIndex    = static_cast<uint32_t>(commands.size());
+
+            commands.push_back({
+                .count         = geometryInfo.numIndices,
+                .instanceCount = 1,
+                .firstIndex    = indexOffsets.at(static_cast<GLuint>(primitive.indexBuffer)) + geometryInfo.indexOffset,
+                .baseVertex    = static_cast<GLint>(vertexOffsets.at(static_cast<GLuint>(primitive.vertexBuffer)) +
+                                                 geometryInfo.vertexOffset),
+                .baseInstance  = drawIndex, // gl_BaseInstance indexes the DrawData
+            });
+            draws.push_back({.modelMatrix = primitive.modelMatrix, .materialIndex = primitiveMaterials[i]});
+            m_DrawInfos.push_back({
+                .batchIndex     = static_cast<uint32_t>(m_Batches.size()),
+                .materialIndex  = primitiveMaterials[i],
+                .primitiveIndex = i,
+            });
+            addWorldBounds(m_Bounds, primitive);
+
+            if (batch.materialRuns.empty() ||
+                primitiveMaterials[batch.materialRuns.back().primitiveIndex] != primitiveMaterials[i])
+                batch.materialRuns.push_back({.primitiveIndex = i, .firstCommand = drawIndex, .numCommands = 0});
+            ++batch.materialRuns.back().numCommands;
+        }
+
+        m_Batches.push_back(std::move(batch));
+    }
+
+    m_NumDraws   = static_cast<uint32_t>(commands.size());
+    m_DrawBuffer = createBuffer(draws.size() * sizeof(DrawData), draws.data());
+    m_Commands   = std::move(commands);
+
+    m_MaterialTextures.resize(materials.size());
+    for (uint32_t i = 0; i < materials.size(); ++i)
+    {
+        for (uint32_t slot = 0; slot < kNumMaterialTextures; ++slot)
+        {
+            m_MaterialTextures[i][slot] = {
+                .texture        = materials[i].textures[slot],
+                .sampler        = materials[i].samplers[slot],
+                .unit           = materials[i].units[slot],
+                .sampledTexture = materials[i].textures[slot],
+            };
+        }
+    }
+
+    if (m_IsBindless)
+    {
+        std::vector<MaterialData> materialData(materials.size());
+        for (uint32_t i = 0; i < materials.size(); ++i)
+        {
+            for (uint32_t slot = 0; slot < kNumMaterialTextures; ++slot)
+            {
+                const auto& materialTexture = m_MaterialTextures[i][slot];
+                if (materialTexture.texture)
+                    materialData[i].textures[slot] =
+                        makeTextureResident(materialTexture.texture, materialTexture.sampler);
+            }
+        }
+        // Updated when the textures are remapped
+        m_MaterialBuffer = createBuffer(
+            materialData.size() * sizeof(MaterialData), materialData.data(), GL_DYNAMIC_STORAGE_BIT);
+    }
+}
+
+SceneDrawStream::~SceneDrawStream()
+{
+#ifdef GL_ARB_bindless_texture
+    for (const auto handle : m_ResidentHandles)
+        glMakeTextureHandleNonResidentARB(handle);
+#endif
+
+    for (const auto& batch : m_Batches)
+    {
+        glDeleteBuffers(1, &batch.vertexBuffer);
+        glDeleteBuffers(1, &batch.indexBuffer);
+    }
+    glDeleteBuffers(1, &m_DrawBuffer);
+    glDeleteBuffers(1, &m_MaterialBuffer);
+}
+
+void SceneDrawStream::remapTextures(const std::function<GLuint(GLuint texture, uint32_t slot)>& remap)
+{
+    for (uint32_t i = 0; i < m_MaterialTextures.size(); ++i)
+    {
+        for (uint32_t slot = 0; slot < kNumMaterialTextures; ++slot)
+        {
+            auto& materialTexture = m_MaterialTextures[i][slot];
+            if (!materialTexture.texture)
+                continue;
+
+            const auto texture = remap(materialTexture.texture, slot);
+            const auto sampled = texture ? texture : materialTexture.texture;
+            if (sampled == materialTexture.sampledTexture)
+                continue;
+
+            materialTexture.sampledTexture = sampled;
+            if (m_IsBindless)
+            {
+                const auto handle = makeTextureResident(sampled, materialTexture.sampler);
+                glNamedBufferSubData(m_MaterialBuffer,
+                                     i * sizeof(MaterialData) + slot * sizeof(GLuint64),
+                                     sizeof(handle),
+                                     &handle);
+            }
+        }
+    }
+}
+
+GLuint64 SceneDrawStream::makeTextureResident(GLuint texture, GLuint sampler)
+{
+#ifdef GL_ARB_bindless_texture
+    const auto handle = sampler ? glGetTextureSamplerHandleARB(texture, sampler) : glGetTextureHandleARB(texture);
+    if (std::ranges::find(m_ResidentHandles, handle) == m_ResidentHandles.end())
+    {
+        glMakeTextureHandleResidentARB(handle);
+        m_ResidentHandles.push_back(handle);
+    }
+    return handle;
+#else
+    return 0;
+#endif
+}
+
+SceneDrawStream::View::~View() { glDeleteBuffers(1, &m_CommandBuffer); }
+
+void SceneDrawStream::cull(View& view, const glm::mat4& viewProjection, bool bindsMaterials) const
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    if (m_IsFrustumCullingEnabled)
+    {
+        std::array<float, 16> matrix;
+        std::copy_n(glm::value_ptr(viewProjection), matrix.size(), matrix.begin());
+        lpv_cpu::cullFrustum(m_Bounds, lpv_cpu::Frustum::fromViewProjection(matrix), view.m_Visible, m_CullingIsa);
+    }
+    else
+    {
+        view.m_Visible.resize(m_NumDraws);
+        std::iota(view.m_Visible.begin(), view.m_Visible.end(), 0u);
+    }
+
+    // The materials only split the multi-draws of the passes binding them
+    const bool splitsMaterials = bindsMaterials && !m_IsBindless;
+
+    view.m_Queue.clear();
+    for (const auto drawIndex : view.m_Visible)
+    {
+        const auto& info = m_DrawInfos[drawIndex];
+
+        // Clip space z of the center of the bounds, it grows away from the camera with both perspective and
+        // orthographic projections
+        float depth = viewProjection[3][2];
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            const auto center = 0.5f * (m_Bounds.getMin(axis)[drawIndex] + m_Bounds.getMax(axis)[drawIndex]);
+            depth += viewProjection[axis][2] * center;
+        }
+
+        view.m_Queue.push(RenderQueue::makeKey(info.batchIndex, splitsMaterials ? info.materialIndex : 0, depth),
+                          drawIndex);
+    }
+    // The visible draws are already in the order of the stream
+    if (m_IsSortingEnabled)
+        view.m_Queue.sort();
+
+    view.m_Commands.clear();
+    view.m_MultiDraws.clear();
+    for (const auto& item : view.m_Queue.getItems())
+    {
+        const auto& info = m_DrawInfos[item.drawIndex];
+        if (view.m_MultiDraws.empty() || view.m_MultiDraws.back().batchIndex != info.batchIndex ||
+            (splitsMaterials && view.m_MultiDraws.back().materialIndex != info.materialIndex))
+        {
+            view.m_MultiDraws.push_back({
+                .batchIndex     = info.batchIndex,
+                .materialIndex  = info.materialIndex,
+                .primitiveIndex = info.primitiveIndex,
+                .firstCommand   = static_cast<uint32_t>(view.m_Commands.size()),
+                .numCommands    = 0,
+            });
+        }
+
+        view.m_Commands.push_back(m_Commands[item.drawIndex]);
+        ++view.m_MultiDraws.back().numCommands;
+    }
+
+    if (!view.m_CommandBuffer)
+        view.m_CommandBuffer =
+            createBuffer(m_Commands.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    if (!view.m_Commands.empty())
+        glNamedBufferSubData(view.m_CommandBuffer,
+                             0,
+                             view.m_Commands.size() * sizeof(DrawElementsIndirectCommand),
+                             view.m_Commands.data());
+
+    const auto end             = std::chrono::steady_clock::now();
+    view.m_CullingMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void SceneDrawStream::bind(const View& view, const std::optional<IndirectCount>& indirectCount) const
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kDrawBinding, m_DrawBuffer);
+    if (m_MaterialBuffer)
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMaterialBinding, m_MaterialBuffer);
+
+    if (indirectCount)
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectCount->commandBuffer);
+        glBindBuffer(GL_PARAMETER_BUFFER, indirectCount->countBuffer);
+    }
+    else
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, view.m_CommandBuffer);
+    }
+}
+
+void SceneDrawStream::draw(vgfw::renderer::RenderContext& rc,
+                           const View::MultiDraw&         multiDraw,
+                           std::optional<uint32_t>        materialBinding,
+                           StateTracker&                  stateTracker,
+                           std::optional<uint32_t>        countIndex) const
+{
+    const auto& batch = m_Batches[multiDraw.batchIndex];
+
+    // The pipelines of a vertex format share its vertex array, see RenderContext::getVertexArray
+    GLint vertexArray = 0;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+    if (stateTracker.setVertexBuffers(static_cast<GLuint>(vertexArray), batch.vertexBuffer, batch.indexBuffer))
+    {
+        glVertexArrayVertexBuffer(vertexArray, 0, batch.vertexBuffer, 0, batch.vertexStride);
+        glVertexArrayElementBuffer(vertexArray, batch.indexBuffer);
+    }
+
+    if (!m_IsBindless && materialBinding && stateTracker.setMaterial(multiDraw.materialIndex))
+    {
+        const auto& primitive = m_MeshPrimitives[multiDraw.primitiveIndex];
+        rc.bindMeshPrimitiveMaterialBuffer(*materialBinding, primitive).bindMeshPrimitiveTextures(0, primitive);
+
+        // The textures remapped by remapTextures() over the ones vgfw bound
+        for (const auto& materialTexture : m_MaterialTextures[multiDraw.materialIndex])
+        {
+            if (materialTexture.sampledTexture != materialTexture.texture)
+                glBindTextureUnit(materialTexture.unit, materialTexture.sampledTexture);
+        }
+    }
+
+    const auto offset = static_cast<uintptr_t>(multiDraw.firstCommand * sizeof(DrawElementsIndirectCommand));
+    if (countIndex)
+    {
+        // Up to the commands the view has for the multi-draw, the GPU kept some of them
+        glMultiDrawElementsIndirectCount(GL_TRIANGLES,
+                                         batch.indexType,
+                                         reinterpret_cast<const void*>(offset),
+                                         static_cast<GLintptr>(*countIndex * sizeof(GLuint)),
+                                         static_cast<GLsizei>(multiDraw.numCommands),
+                                         0);
+        return;
+    }
+
+    glMultiDrawElementsIndirect(GL_TRIANGLES,
+                                batch.indexType,
+                                reinterpret_cast<const void*>(offset),
+                                static_cast<GLsizei>(multiDraw.numCommands),
+                                0);
+}
+
+uint32_t SceneDrawStream::getNumMultiDraws(bool withMaterials) const
+{
+    uint32_t numMultiDraws = 0;
+    for (const auto& batch : m_Batches)
+        numMultiDraws += m_IsBindless || !withMaterials ? 1 : static_cast<uint32_t>(batch.materialRuns.size());
+    return numMultiDraws;
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include "render_queue.hpp"
+#include "shader_source.hpp"
+#include "state_tracker.hpp"
+
+#include <lpv_cpu/culling.hpp>
+
+#include <functional>
+
+// Texture slots of the PrimitiveMaterial uniform block of vgfw, see lib/material.glsl
+constexpr uint32_t kNumMaterialTextures = 5;
+
+// Materials sample their textures through bindless handles when GL_ARB_bindless_texture is supported, a multi-draw
+// then covers every material
+bool hasBindlessMaterials();
+
+// #defines of the fragment shaders that include lib/material.glsl
+ShaderDefines getMaterialShaderDefines();
+
+// Layout of the commands of glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint  baseVertex;
+    GLuint baseInstance;
+};
+
+// The scene submitted with glMultiDrawElementsIndirect: the mesh primitives of a vertex format share a merged
+// vertex/index buffer, and every draw reads its model matrix and material index from a storage buffer through
+// gl_BaseInstance (geometry.vert). A geometry pass then issues one multi-draw per vertex format, or one per run
+// of draws with the same material without bindless textures. The draws are frustum culled for every view against the
+// world bounds of the primitives and ordered by a RenderQueue, see View.
+class SceneDrawStream
+{
+public:
+    static constexpr uint32_t kDrawBinding     = 0; // Storage buffer of DrawData
+    static constexpr uint32_t kMaterialBinding = 1; // Storage buffer of MaterialData, bindless only
+
+    // Draws of a merged vertex/index buffer, sorted by material
+    struct Batch
+    {
+        struct MaterialRun
+        {
+            uint32_t primitiveIndex; // A primitive of the material, to bind it without bindless textures
+            uint32_t firstCommand;
+            uint32_t numCommands;
+        };
+
+        std::shared_ptr<vgfw::renderer::VertexFormat> vertexFormat;
+
+        GLuint   vertexBuffer {0};
+        GLuint   indexBuffer {0};
+        GLsizei  vertexStride {0};
+        GLenum   indexType {GL_UNSIGNED_INT};
+        uint32_t firstCommand {0};
+        uint32_t numCommands {0};
+
+        std::vector<MaterialRun> materialRuns;
+    };
+
+    // Draws of the stream inside of a frustum, sorted and their commands compacted into a buffer of the view. The
+    // passes cull into views of their own, a view is read when its pass executes.
+    class View
+    {
+    public:
+        // Adjacent visible draws of a batch (and of a material when the pass binds them)
+        struct MultiDraw
+        {
+            uint32_t batchIndex;
+            uint32_t materialIndex;
+            uint32_t primitiveIndex; // A primitive of the material, to bind it without bindless textures
+            uint32_t firstCommand;
+            uint32_t numCommands;
+        };
+
+        View() = default;
+        ~View();
+
+        View(const View&)            = delete;
+        View& operator=(const View&) = delete;
+
+        uint32_t                      getNumVisible() const { return static_cast<uint32_t>(m_Visible.size()); }
+        const std::vector<MultiDraw>& getMultiDraws() const { return m_MultiDraws; }
+        // getNumVisible() commands, in the order of the multi-draws
+        GLuint getCommandBuffer() const { return m_CommandBuffer; }
+        // CPU time the last cull took, including the sort and the upload of the commands
+        double getCullingMilliseconds() const { return m_CullingMilliseconds; }
+
+    private:
+        friend class SceneDrawStream;
+
+        GLuint                                   m_CommandBuffer {0};
+        std::vector<uint32_t>                    m_Visible; // Draw indices, ascending
+        RenderQueue                              m_Queue;
+        std::vector<DrawElementsIndirectCommand> m_Commands;
+        std::vector<MultiDraw>                   m_MultiDraws;
+        double                                   m_CullingMilliseconds {0.0};
+    };
+
+    // Commands of a view compacted on the GPU (OcclusionCuller). A multi-draw reads them from its firstCommand in
+    // commandBuffer, and their number from a GLuint of countBuffer, firstCount being the one of the first multi-draw.
+    struct IndirectCount
+    {
+        GLuint   commandBuffer;
+        GLuint   countBuffer;
+        uint32_t firstCount;
+    };
+
+    SceneDrawStream(vgfw::renderer::RenderContext&                    rc,
+                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives);
+    ~SceneDrawStream();
+
+    SceneDrawStream(const SceneDrawStream&)            = delete;
+    SceneDrawStream& operator=(const SceneDrawStream&) = delete;
+
+    const std::vector<Batch>& getBatches() const { return m_Batches; }
+    // World bounds of every draw
+    const lpv_cpu::AABBSet& getBounds() const { return m_Bounds; }
+
+    // Fills the view with the draws inside of the frustum of viewProjection, sorted by batch, material (when the pass
+    // binds them) and depth, and uploads their commands
+    void cull(View& view, const glm::mat4& viewProjection, bool bindsMaterials) const;
+
+    // Binds the storage buffers and the indirect draw buffer of the view, or the buffers of its compacted commands,
+    // once per pass
+    void bind(const View& view, const std::optional<IndirectCount>& indirectCount = std::nullopt) const;
+
+    // Issues a multi-draw of a view, the pipeline of its batch's vertex format has to be bound. Passes that sample the
+    // materials bind the PrimitiveMaterial uniform block at materialBinding without bindless textures. The vertex
+    // buffers and the material are only bound when the tracker does not have them. With compacted commands, countIndex
+    // is the GLuint of the bound count buffer holding the number of commands of the multi-draw.
+    void draw(vgfw::renderer::RenderContext& rc,
+              const View::MultiDraw&         multiDraw,
+              std::optional<uint32_t>        materialBinding,
+              StateTracker&                  stateTracker,
+              std::optional<uint32_t>        countIndex = std::nullopt) const;
+
+    // Replaces the textures of the materials: remap(texture, slot) gives the texture a slot samples instead of the one
+    // vgfw bound, 0 to keep it. Every call remaps the textures vgfw bound.
+    void remapTextures(const std::function<GLuint(GLuint texture, uint32_t slot)>& remap);
+
+    uint32_t     getNumDraws() const { return m_NumDraws; }
+    uint32_t     getNumMultiDraws(bool withMaterials) const;
+    lpv_cpu::Isa getCullingIsa() const { return m_CullingIsa; }
+
+    // Without sorting, the views keep the order of the stream (batch, then material) like the draws were submitted
+    // before the RenderQueue
+    void setSortingEnabled(bool isSortingEnabled) { m_IsSortingEnabled = isSortingEnabled; }
+    // Without frustum culling, every draw of the stream is visible in every view
+    void setFrustumCullingEnabled(bool isEnabled) { m_IsFrustumCullingEnabled = isEnabled; }
+
+private:
+    struct DrawData
+    {
+        glm::mat4 modelMatrix;
+        uint32_t  materialIndex;
+        uint32_t  padding[3];
+    };
+
+    // Bindless handles of the material textures, 0 when the material has no texture in a slot
+    struct MaterialData
+    {
+        std::array<GLuint64, kNumMaterialTextures> textures;
+    };
+
+    // Texture vgfw bound to a slot of a material (to a unit without bindless textures), and the one the slot samples
+    struct MaterialTexture
+    {
+        GLuint texture {0};
+        GLuint sampler {0};
+        GLint  unit {0};
+        GLuint sampledTexture {0};
+    };
+
+    // Handle of a texture with the sampler of its slot (0 for its own parameters), made resident once
+    GLuint64 makeTextureResident(GLuint texture, GLuint sampler);
+
+    std::vector<Batch> m_Batches;
+
+    std::vector<std::array<MaterialTexture, kNumMaterialTextures>> m_MaterialTextures;
+
+    GLuint m_DrawBuffer {0};
+    GLuint m_MaterialBuffer {0};
+
+    struct DrawInfo
+    {
+        uint32_t batchIndex;
+        uint32_t materialIndex;
+        uint32_t primitiveIndex;
+    };
+
+    // Every draw of the stream, and its world bounds
+    std::vector<DrawElementsIndirectCommand> m_Commands;
+    std::vector<DrawInfo>                    m_DrawInfos;
+    lpv_cpu::AABBSet                         m_Bounds;
+    lpv_cpu::Isa                             m_CullingIsa {lpv_cpu::detectIsa()};
+    bool                                     m_IsSortingEnabled {true};
+    bool                                     m_IsFrustumCullingEnabled {true};
+
+    std::vector<GLuint64> m_ResidentHandles;
+
+    const std::vector<vgfw::resource::MeshPrimitive>& m_MeshPrimitives;
+    uint32_t                                          m_NumDraws {0};
+    bool                                              m_IsBindless {false};
+};
\ No newline at end of file
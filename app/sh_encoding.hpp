@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// How the SH coefficients of a LPV cell are stored, matches SH_ENCODING in lib/sh_volume.glsl
+enum class SHEncoding
+{
+    eRGBA16F = 0,    // SH-R, SH-G and SH-B RGBA16F volumes, 24 bytes per cell and 3 fetches
+    eSharedExponent, // A single RGBA32UI volume, 12 10-bit mantissas sharing an exponent, 16 bytes per cell
+};
+
+constexpr uint32_t kNumSHEncodings = 2;
+
+// Textures holding the coefficients of a cell
+constexpr uint32_t getNumSHVolumes(SHEncoding encoding) { return encoding == SHEncoding::eRGBA16F ? 3 : 1; }
\ No newline at end of file
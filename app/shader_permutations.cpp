@@ -0,0 +1,26 @@
+#include "shader_permutations.hpp"
+#include "program_cache.hpp"
+
+void ShaderPermutations::create(const std::string&   vertexPath,
+                                const std::string&   fragmentPath,
+                                const ShaderDefines& defines)
+{
+    m_VertexSource   = vgfw::utils::readFileAllText(vertexPath);
+    m_FragmentSource = vgfw::utils::readFileAllText(fragmentPath);
+    m_Defines        = defines;
+
+    m_Generic = getProgramCache().getGraphicsProgram(m_VertexSource, addShaderDefines(m_FragmentSource, defines));
+    m_Variants.clear();
+}
+
+GLuint ShaderPermutations::get(const ShaderDefines& features)
+{
+    auto [it, isNew] = m_Variants.try_emplace(features, 0);
+    if (isNew)
+    {
+        auto defines = m_Defines;
+        defines.insert(defines.end(), features.begin(), features.end());
+        it->second = getProgramCache().getGraphicsProgram(m_VertexSource, addShaderDefines(m_FragmentSource, defines));
+    }
+    return getProgramCache().isReady(it->second) ? it->second : m_Generic;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include "shader_source.hpp"
+
+#include <map>
+
+// Variants of a fullscreen program specialized for the values of the settings its pass reads, one #define each that
+// the shader otherwise maps to a member of its uniform block (see deferred_lighting.frag). A variant is compiled the
+// first time its values are met and cached by them. The generic variant, branching on the uniform block, stands in
+// until it is linked. The ProgramCache owns the programs.
+class ShaderPermutations
+{
+public:
+    void create(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines = {});
+
+    // The features are the #defines of the fragment shader on top of the ones of create()
+    GLuint get(const ShaderDefines& features);
+    GLuint getGeneric() const { return m_Generic; }
+
+    uint32_t getNumVariants() const { return static_cast<uint32_t>(m_Variants.size()); }
+
+private:
+    std::string                     m_VertexSource;
+    std::string                     m_FragmentSource;
+    ShaderDefines                   m_Defines;
+    GLuint                          m_Generic {0};
+    std::map<ShaderDefines, GLuint> m_Variants;
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+#include "shader_source.hpp"
+
+std::string addShaderDefines(const std::string& source, const ShaderDefines& defines)
+{
+    std::string header;
+    for (const auto& [name, value] : defines)
+        header += "#define " + name + " " + value + "\n";
+
+    // #version has to stay the first directive
+    const auto versionEnd = source.starts_with("#version") ? source.find('\n') : std::string::npos;
+    if (versionEnd == std::string::npos)
+        return header + source;
+
+    auto result = source;
+    result.insert(versionEnd + 1, header);
+    return result;
+}
\ No newline at end of file
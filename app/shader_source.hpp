@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// (name, value) pairs of the #defines a shader variant is compiled with
+using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+// Inserts the #defines right after the #version directive, the shaders only get their #include expanded at build
+// time so their preprocessor conditionals are still there
+std::string addShaderDefines(const std::string& source, const ShaderDefines& defines);
\ No newline at end of file
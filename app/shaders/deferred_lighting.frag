@@ -1,7 +1,7 @@
 #version 460 core
 
 #include "lib/pbr.glsl"
-#include "lib/lpv.glsl"
+#include "lib/sh_volume.glsl"
 #include "lib/csm.glsl"
 #include "lib/depth.glsl"
 
@@ -35,16 +35,41 @@ layout(binding = 2) uniform sampler2D gEmissive;              // Emissive textur
 layout(binding = 3) uniform sampler2D gMetallicRoughnessAO;   // Metallic, Roughness, and AO (ambient occlusion) texture
 layout(binding = 4) uniform sampler2D SceneDepth;             // Depth texture from G-buffer
 layout(binding = 5) uniform sampler2DArrayShadow CascadedShadowMaps;  // Cascaded shadow maps
+layout(binding = 9) uniform sampler2D HBAO;                   // Ambient occlusion map
+
+// SH coefficients of every LPV cascade, the first unit of a cascade doesn't depend on the encoding
+#if SH_ENCODING == SH_ENCODING_RGBA16F
 layout(binding = 6) uniform sampler3D Propagated_SH_R;        // Red SH (Spherical Harmonics) coefficients for LPV
 layout(binding = 7) uniform sampler3D Propagated_SH_G;        // Green SH coefficients
 layout(binding = 8) uniform sampler3D Propagated_SH_B;        // Blue SH coefficients
-layout(binding = 9) uniform sampler2D HBAO;                   // Ambient occlusion map
-
-// Light view-projection matrix for shadow calculation
-uniform mat4 uLightVP;
-
-// Radiance injection parameters (used for LPV grid)
-uniform RadianceInjection uInjection;
+layout(binding = 10) uniform sampler3D Cascade1_SH_R;
+layout(binding = 11) uniform sampler3D Cascade1_SH_G;
+layout(binding = 12) uniform sampler3D Cascade1_SH_B;
+layout(binding = 13) uniform sampler3D Cascade2_SH_R;
+layout(binding = 14) uniform sampler3D Cascade2_SH_G;
+layout(binding = 15) uniform sampler3D Cascade2_SH_B;
+layout(binding = 16) uniform sampler3D Cascade3_SH_R;
+layout(binding = 17) uniform sampler3D Cascade3_SH_G;
+layout(binding = 18) uniform sampler3D Cascade3_SH_B;
+#define CASCADE0_SH_VOLUME Propagated_SH_R, Propagated_SH_G, Propagated_SH_B
+#define CASCADE1_SH_VOLUME Cascade1_SH_R, Cascade1_SH_G, Cascade1_SH_B
+#define CASCADE2_SH_VOLUME Cascade2_SH_R, Cascade2_SH_G, Cascade2_SH_B
+#define CASCADE3_SH_VOLUME Cascade3_SH_R, Cascade3_SH_G, Cascade3_SH_B
+#else
+layout(binding = 6) uniform usampler3D Propagated_SH_Packed;  // Packed SH coefficients for LPV
+layout(binding = 10) uniform usampler3D Cascade1_SH_Packed;
+layout(binding = 13) uniform usampler3D Cascade2_SH_Packed;
+layout(binding = 16) uniform usampler3D Cascade3_SH_Packed;
+#define CASCADE0_SH_VOLUME Propagated_SH_Packed
+#define CASCADE1_SH_VOLUME Cascade1_SH_Packed
+#define CASCADE2_SH_VOLUME Cascade2_SH_Packed
+#define CASCADE3_SH_VOLUME Cascade3_SH_Packed
+#endif
+
+#define MAX_LPV_CASCADES 4
+
+// Width (in cells) of the band along a cascade's border where it fades into the next one
+#define LPV_CASCADE_BLEND_CELLS 2.0
 
 // Settings for rendering features (e.g., HBAO, SSR, TAA, Bloom, visual mode)
 struct Settings {
@@ -54,7 +79,83 @@ struct Settings {
     int enableBloom;       // Enable bloom effect
     uint visualMode;       // Visual debugging modes
 };
-uniform Settings uSettings;
+
+// DeferredLightingUniform of uniforms/pass_uniforms.hpp
+layout(binding = 3, std140) uniform DeferredLighting {
+    mat4 uLightVP;                                  // Light view-projection matrix for shadow calculation
+    RadianceInjection uCascades[MAX_LPV_CASCADES];  // Grid parameters of every LPV cascade, finest to coarsest
+    uint uNumCascades;
+    Settings uSettings;
+};
+
+// Settings of the variant (see ShaderPermutations), the generic variant reads them from the block
+#ifndef ENABLE_HBAO
+#define ENABLE_HBAO (uSettings.enableHBAO == 1)
+#endif
+#ifndef ENABLE_BLOOM
+#define ENABLE_BLOOM (uSettings.enableBloom == 1)
+#endif
+#ifndef VISUAL_MODE
+#define VISUAL_MODE uSettings.visualMode
+#endif
+#ifndef NUM_LPV_CASCADES
+#define NUM_LPV_CASCADES uNumCascades
+#endif
+
+// Sample the SH coefficients of a cascade, the sampler index has to be a constant expression
+SH_Coefficients sampleCascade(uint cascadeIndex, vec3 cellCoords) {
+    switch (cascadeIndex) {
+        case 1:
+            return SH_SampleVolume(CASCADE1_SH_VOLUME, cellCoords);
+        case 2:
+            return SH_SampleVolume(CASCADE2_SH_VOLUME, cellCoords);
+        case 3:
+            return SH_SampleVolume(CASCADE3_SH_VOLUME, cellCoords);
+        default:
+            return SH_SampleVolume(CASCADE0_SH_VOLUME, cellCoords);
+    }
+}
+
+// Indirect radiance of a cascade for the given surface
+vec3 getCascadeRadiance(uint cascadeIndex, vec3 cellCoords, vec3 normal) {
+    const SH_Coefficients coeffs = sampleCascade(cascadeIndex, cellCoords);
+
+    // Evaluate SH lighting for the normal direction
+    const vec4 SH_Intensity = SH_Evaluate(-normal);
+    const vec3 LPV_Intensity = vec3(dot(SH_Intensity, coeffs.red), dot(SH_Intensity, coeffs.green), dot(SH_Intensity, coeffs.blue));
+
+    // Scale the LPV intensity based on grid cell size
+    const float cellSize = uCascades[cascadeIndex].gridCellSize;
+    return max(LPV_Intensity * 4 / cellSize / cellSize, 0.0);
+}
+
+// Indirect lighting from the finest cascade containing the fragment, blended into the next one near its border
+vec3 getLPVRadiance(vec3 fragPos, vec3 normal) {
+    for (uint i = 0; i < NUM_LPV_CASCADES; ++i) {
+        const RadianceInjection cascade = uCascades[i];
+        const vec3 cells = (fragPos - cascade.gridAABBMin) / cascade.gridCellSize;
+        if (any(lessThan(cells, vec3(0.0))) || any(greaterThan(cells, cascade.gridSize))) {
+            continue;
+        }
+
+        const vec3 radiance = getCascadeRadiance(i, cells / cascade.gridSize, normal);
+        if (i + 1 == NUM_LPV_CASCADES) {
+            return radiance;
+        }
+
+        // Distance (in cells) to the nearest border of the cascade
+        const vec3 border = min(cells, cascade.gridSize - cells);
+        const float weight = clamp(min(border.x, min(border.y, border.z)) / LPV_CASCADE_BLEND_CELLS, 0.0, 1.0);
+        if (weight >= 1.0) {
+            return radiance;
+        }
+
+        const RadianceInjection next = uCascades[i + 1];
+        const vec3 nextCellCoords = (fragPos - next.gridAABBMin) / next.gridCellSize / next.gridSize;
+        return mix(getCascadeRadiance(i + 1, nextCellCoords, normal), radiance, weight);
+    }
+    return vec3(0.0);
+}
 
 void main() {
     // Retrieve depth from the scene's depth texture at the current fragment
@@ -77,7 +178,7 @@ void main() {
     float ao = metallicRoughnessAO.b;
 
     // If HBAO (ambient occlusion) is enabled, multiply AO with the HBAO map value
-    if (uSettings.enableHBAO == 1) {
+    if (ENABLE_HBAO) {
         ao *= texture(HBAO, vTexCoords).r;
     }
 
@@ -128,24 +229,10 @@ void main() {
     vec3 Lo_Specular = specular * lightRadiance * NdotL * lightVisibility;
 
     // Indirect lighting via LPV (Light Propagation Volumes) for global illumination
-    const vec3 cellCoords = (fragPos - uInjection.gridAABBMin) / uInjection.gridCellSize / uInjection.gridSize;
-
-    // Retrieve propagated SH coefficients for each color channel from the 3D texture
-    const SH_Coefficients coeffs = {
-        texture(Propagated_SH_R, cellCoords, 0),
-        texture(Propagated_SH_G, cellCoords, 0),
-        texture(Propagated_SH_B, cellCoords, 0)
-    };
-
-    // Evaluate SH lighting for the normal direction
-    const vec4 SH_Intensity = SH_Evaluate(-normal);
-    const vec3 LPV_Intensity = vec3(dot(SH_Intensity, coeffs.red), dot(SH_Intensity, coeffs.green), dot(SH_Intensity, coeffs.blue));
-
-    // Scale the LPV intensity based on grid cell size
-    const vec3 radiance = max(LPV_Intensity * 4 / uInjection.gridCellSize / uInjection.gridCellSize, 0.0);
+    const vec3 radiance = getLPVRadiance(fragPos, normal);
 
     // Add indirect lighting based on LPV if not in debug visual mode
-    if(uSettings.visualMode != 1) {
+    if(VISUAL_MODE != 1) {
         Lo_Diffuse += baseColor * radiance;
     }
 
@@ -153,14 +240,14 @@ void main() {
     Lo_Diffuse *= ao;
 
     // Final scene color, depending on visual mode (0 = full rendering, 2 = radiance visualization)
-    if(uSettings.visualMode != 2) {
+    if(VISUAL_MODE != 2) {
         SceneColor = Lo_Diffuse + Lo_Specular + emissive;  // Regular rendering (diffuse + specular + emissive)
     } else {
         SceneColor = radiance;  // Show only indirect lighting (radiance)
     }
 
     // If the scene color exceeds 1.0, mark it as bright for bloom processing
-    if (SceneColor.r > 1.0 || SceneColor.g > 1.0 || SceneColor.b > 1.0) {
+    if (ENABLE_BLOOM && (SceneColor.r > 1.0 || SceneColor.g > 1.0 || SceneColor.b > 1.0)) {
         SceneColorBright = SceneColor;
     } else {
         SceneColorBright = vec3(0);
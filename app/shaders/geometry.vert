@@ -8,18 +8,29 @@ layout(location = 3) in vec4 aTangent;
 layout(location = 0) out vec2 vTexCoords;
 layout(location = 1) out vec3 vFragPos;
 layout(location = 2) out mat3 vTBN;
+layout(location = 5) flat out uint vMaterialIndex;
 
-struct Transform {
-    mat4 model;
+layout(binding = 3, std140) uniform Transform {
     mat4 viewProjection;
+} uTransform;
+
+// Per draw data of the scene multi-draws, gl_BaseInstance is the index of the draw (SceneDrawStream)
+struct DrawData {
+    mat4 model;
+    uint materialIndex;
 };
 
-uniform Transform uTransform;
+layout(std430, binding = 0) readonly buffer Draws {
+    DrawData uDraws[];
+};
 
 void main() {
-    vec4 fragPos = uTransform.model * vec4(aPos, 1.0);
+    const DrawData draw = uDraws[gl_BaseInstance];
+
+    vec4 fragPos = draw.model * vec4(aPos, 1.0);
     vFragPos = fragPos.xyz;
     vTexCoords = aTexCoords;
     vTBN = mat3(aTangent.xyz, cross(aTangent.xyz, aNormal) * aTangent.w, aNormal);
+    vMaterialIndex = draw.materialIndex;
     gl_Position = uTransform.viewProjection * fragPos;
 }
\ No newline at end of file
@@ -23,14 +23,24 @@ layout(binding = 0) uniform Camera {
 layout(binding = 0) uniform sampler2D gDepth;
 layout(binding = 1) uniform sampler2D NoiseMap;
 
-// HBAO parameters
-uniform float uHBAO_radius;
-uniform float uHBAO_bias;
-uniform float uHBAO_intensity;
-uniform float uHBAO_negInvRadius2;
-uniform int uHBAO_maxRadiusPixels;
-uniform int uHBAO_stepCount;
-uniform int uHBAO_directionCount;
+// HBAO parameters, HBAOUniform of uniforms/pass_uniforms.hpp
+layout(binding = 1, std140) uniform HBAO {
+    float uHBAO_radius;
+    float uHBAO_bias;
+    float uHBAO_intensity;
+    float uHBAO_negInvRadius2;
+    int uHBAO_maxRadiusPixels;
+    int uHBAO_stepCount;
+    int uHBAO_directionCount;
+};
+
+// Loop counts of the variant (see ShaderPermutations), the generic variant reads them from the block
+#ifndef HBAO_STEP_COUNT
+#define HBAO_STEP_COUNT uHBAO_stepCount
+#endif
+#ifndef HBAO_DIRECTION_COUNT
+#define HBAO_DIRECTION_COUNT uHBAO_directionCount
+#endif
 
 // Compute falloff based on distance
 float falloff(float distanceSquare) {
@@ -71,13 +81,13 @@ void main() {
     vec3 N = normalize(cross(dpdx, dpdy));
 
     // HBAO parameters for sampling
-    float stepSize = min(uHBAO_radius / fragPosViewSpace.z, float(uHBAO_maxRadiusPixels)) / float(uHBAO_stepCount + 1);
-    float stepAngle = TWO_PI / float(uHBAO_directionCount);
+    float stepSize = min(uHBAO_radius / fragPosViewSpace.z, float(uHBAO_maxRadiusPixels)) / float(HBAO_STEP_COUNT + 1);
+    float stepAngle = TWO_PI / float(HBAO_DIRECTION_COUNT);
 
     float ao = 0.0;
 
     // Sample in multiple directions
-    for (int d = 0; d < uHBAO_directionCount; ++d) {
+    for (int d = 0; d < HBAO_DIRECTION_COUNT; ++d) {
         float angle = stepAngle * (float(d) + rand.x);
         float cosAngle = cos(angle);
         float sinAngle = sin(angle);
@@ -87,7 +97,7 @@ void main() {
         float top = 0;
 
         // Accumulate AO from multiple steps
-        for (int s = 0; s < uHBAO_stepCount; ++s) {
+        for (int s = 0; s < HBAO_STEP_COUNT; ++s) {
             const vec2 sampleUV = vTexCoords + direction * rayPixels * screenSize.zw;
             const float tempDepth = texture(gDepth, sampleUV).r;
             const vec3 tempFragPosViewSpace = viewPositionFromDepth(tempDepth, sampleUV, uCamera.inverseProjection);
@@ -98,5 +108,5 @@ void main() {
     }
 
     // Output the final AO value
-    FragColor = 1.0 - ao * uHBAO_intensity / float(uHBAO_directionCount * uHBAO_stepCount);
+    FragColor = 1.0 - ao * uHBAO_intensity / float(HBAO_DIRECTION_COUNT * HBAO_STEP_COUNT);
 }
@@ -7,11 +7,17 @@ struct RadianceInjection {
     vec3 gridSize;    // Size of the LPV grid (in cells)
     float gridCellSize; // Size of each cell in the grid
     int rsmResolution;  // Resolution of the Reflective Shadow Map (RSM)
+    float vplFluxScale; // Flux scale of a VPL, keeps the injected flux independent of the RSM resolution
 };
 
-// Spherical Harmonics (SH) constants for evaluation
-#define SH_C0 0.282094791 // SH constant for the zeroth coefficient (1 / 2sqrt(pi))
-#define SH_C1 0.488602512 // SH constant for the first-order coefficients (sqrt(3/pi) / 2)
+// Cell a VPL gets injected into, shifted by half a cell along its normal to avoid self-illumination
+ivec3 getVPLCellIndex(vec3 position, vec3 normal, vec3 gridAABBMin, float gridCellSize) {
+    return ivec3((position - gridAABBMin) / gridCellSize + 0.5 * normal);
+}
+
+// Spherical Harmonics (SH) constants for evaluation (SH_C0, SH_C1, SH_cosLobe_C0 and SH_cosLobe_C1), generated from
+// lpv_cpu/sh.hpp by lpv-sh-tables
+#include "lib/sh_tables.glsl"
 
 // Evaluate the first 4 Spherical Harmonics basis functions given a direction
 vec4 SH_Evaluate(vec3 direction) {
@@ -20,10 +26,6 @@ vec4 SH_Evaluate(vec3 direction) {
     return vec4(SH_C0, -SH_C1 * direction.y, SH_C1 * direction.z, -SH_C1 * direction.x);
 }
 
-// SH constants for a cosine-weighted lobe function
-#define SH_cosLobe_C0 0.886226925 // SH constant for the zeroth cosine lobe coefficient (sqrt(pi)/2)
-#define SH_cosLobe_C1 1.02332671  // SH constant for the first-order cosine lobe coefficients (sqrt(pi/3))
-
 // Evaluate the SH coefficients for a cosine-weighted lobe (used for diffuse lighting)
 vec4 SH_EvaluateCosineLobe(vec3 direction) {
     direction = normalize(direction); // Ensure the direction vector is normalized
@@ -0,0 +1,17 @@
+#ifndef LPV_BRICK_GLSL
+#define LPV_BRICK_GLSL
+
+// LPV bricks are 4^3 cells, the size of the propagation workgroups. A brick mask stores the first propagation
+// iteration a brick can receive radiance at in a R8 texel, kInactiveBrick standing for never.
+#define kBrickSize 4
+#define kInactiveBrick 255u
+
+uint fetchFirstIteration(sampler3D brickMask, ivec3 brickIndex) {
+    return uint(round(texelFetch(brickMask, brickIndex, 0).r * 255.0));
+}
+
+void storeFirstIteration(writeonly image3D brickMask, ivec3 brickIndex, uint firstIteration) {
+    imageStore(brickMask, brickIndex, vec4(float(firstIteration) / 255.0));
+}
+
+#endif
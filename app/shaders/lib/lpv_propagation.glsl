@@ -0,0 +1,29 @@
+#ifndef LPV_PROPAGATION_GLSL
+#define LPV_PROPAGATION_GLSL
+
+#include "lpv.glsl"
+#include "sh_volume.glsl"
+// Generated from lpv_cpu/sh.hpp by lpv-sh-tables
+#include "lib/sh_tables.glsl"
+
+// Adds what a neighbour propagates to the cell, the main and side faces of every neighbour are folded into
+// kPropagationMatrices (see lpv_cpu/sh.hpp)
+void addNeighbourContribution(inout SH_Coefficients contribution, int neighbour, SH_Coefficients neighbourCoeffs) {
+    const mat4 propagation = kPropagationMatrices[neighbour];
+    contribution.red += propagation * neighbourCoeffs.red;
+    contribution.green += propagation * neighbourCoeffs.green;
+    contribution.blue += propagation * neighbourCoeffs.blue;
+}
+
+// Compute SH contributions from neighboring cells
+SH_Coefficients getContributions(SH_VOLUME_PARAMS, ivec3 cellIndex) {
+    SH_Coefficients contribution = {vec4(0.0), vec4(0.0), vec4(0.0)};
+    for (int neighbour = 0; neighbour < 6; ++neighbour) {
+        addNeighbourContribution(
+            contribution, neighbour, SH_FetchCell(SH_VOLUME_ARGS, cellIndex + kNeighbourOffsets[neighbour]));
+    }
+
+    return contribution;
+}
+
+#endif
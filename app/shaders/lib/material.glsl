@@ -0,0 +1,78 @@
+#ifndef MATERIAL_GLSL
+#define MATERIAL_GLSL
+
+// Material of a scene draw, see SceneDrawStream. With BINDLESS_MATERIALS the material index of the draw selects the
+// texture handles of its material in a storage buffer, otherwise the PrimitiveMaterial uniform block of vgfw
+// (MATERIAL_BINDING) and its textures are bound between the draws of different materials.
+#ifdef BINDLESS_MATERIALS
+#extension GL_ARB_bindless_texture : require
+#endif
+
+#define kBaseColorTexture 0
+#define kMetallicRoughnessTexture 1
+#define kNormalTexture 2
+#define kOcclusionTexture 3
+#define kEmissiveTexture 4
+#define kNumMaterialTextures 5
+
+layout(location = 5) flat in uint vMaterialIndex;
+
+#ifdef BINDLESS_MATERIALS
+struct Material {
+    uvec2 textures[kNumMaterialTextures]; // 0 without a texture
+};
+
+layout(std430, binding = 1) readonly buffer Materials {
+    Material uMaterials[];
+};
+
+bool hasMaterialTexture(int slot) {
+    return any(notEqual(uMaterials[vMaterialIndex].textures[slot], uvec2(0)));
+}
+
+vec4 sampleMaterialTexture(int slot, vec2 texCoords) {
+    return texture(sampler2D(uMaterials[vMaterialIndex].textures[slot]), texCoords);
+}
+#else
+layout(binding = MATERIAL_BINDING) uniform PrimitiveMaterial {
+    int baseColorTextureIndex;
+    int metallicRoughnessTextureIndex;
+    int normalTextureIndex;
+    int occlusionTextureIndex;
+    int emissiveTextureIndex;
+} uMaterial;
+
+layout(binding = 0) uniform sampler2D uTextures[kNumMaterialTextures];
+
+int getMaterialTextureIndex(int slot) {
+    switch (slot) {
+        case kBaseColorTexture:
+            return uMaterial.baseColorTextureIndex;
+        case kMetallicRoughnessTexture:
+            return uMaterial.metallicRoughnessTextureIndex;
+        case kNormalTexture:
+            return uMaterial.normalTextureIndex;
+        case kOcclusionTexture:
+            return uMaterial.occlusionTextureIndex;
+        default:
+            return uMaterial.emissiveTextureIndex;
+    }
+}
+
+bool hasMaterialTexture(int slot) {
+    return getMaterialTextureIndex(slot) != -1;
+}
+
+vec4 sampleMaterialTexture(int slot, vec2 texCoords) {
+    return texture(uTextures[getMaterialTextureIndex(slot)], texCoords);
+}
+#endif
+
+// Tangent space normal of the normal texture, its Z rebuilt from X and Y: the block compressed normal textures (BC5)
+// only store those two
+vec3 sampleMaterialNormal(vec2 texCoords) {
+    vec2 xy = sampleMaterialTexture(kNormalTexture, texCoords).rg * 2.0 - 1.0;
+    return vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+}
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef SH_VOLUME_GLSL
+#define SH_VOLUME_GLSL
+
+#include "lpv.glsl"
+
+// How the SH coefficients of a cell are stored, injected at runtime by the application (see sh_encoding.hpp)
+#define SH_ENCODING_RGBA16F 0         // SH-R, SH-G and SH-B RGBA16F volumes
+#define SH_ENCODING_SHARED_EXPONENT 1 // A single RGBA32UI volume, see SH_EncodeSharedExponent
+
+#ifndef SH_ENCODING
+#define SH_ENCODING SH_ENCODING_RGBA16F
+#endif
+
+// 12 signed 10-bit mantissas relative to the largest magnitude of the cell, whose 8-bit exponent is spread over the
+// top 2 bits of every word. The layout matches lpv_cpu/sh_encoding.hpp: coefficient i (color * 4 + band) is stored
+// in word i / 3 at bit (i % 3) * 10.
+uvec4 SH_EncodeSharedExponent(SH_Coefficients c) {
+    const vec4 magnitudes = max(max(abs(c.red), abs(c.green)), abs(c.blue));
+    const float maxMagnitude = max(max(magnitudes.x, magnitudes.y), max(magnitudes.z, magnitudes.w));
+    if (maxMagnitude == 0.0) {
+        return uvec4(0);
+    }
+
+    int exponent;
+    frexp(maxMagnitude, exponent);
+    exponent = clamp(exponent, -127, 128);
+    const float scale = 511.0 / ldexp(1.0, exponent);
+
+    const ivec4 red = ivec4(round(clamp(c.red * scale, -511.0, 511.0)));
+    const ivec4 green = ivec4(round(clamp(c.green * scale, -511.0, 511.0)));
+    const ivec4 blue = ivec4(round(clamp(c.blue * scale, -511.0, 511.0)));
+
+    const uvec4 m0 = uvec4(ivec4(red.x, red.w, green.z, blue.y)) & 0x3FFu;
+    const uvec4 m1 = uvec4(ivec4(red.y, green.x, green.w, blue.z)) & 0x3FFu;
+    const uvec4 m2 = uvec4(ivec4(red.z, green.y, blue.x, blue.w)) & 0x3FFu;
+    const uvec4 exponentBits = (uvec4(exponent + 127) >> uvec4(0, 2, 4, 6)) & 0x3u;
+    return m0 | (m1 << 10) | (m2 << 20) | (exponentBits << 30);
+}
+
+SH_Coefficients SH_DecodeSharedExponent(uvec4 packed) {
+    const uvec4 exponentBits = packed >> 30;
+    const int exponent = int(exponentBits.x | (exponentBits.y << 2) | (exponentBits.z << 4) | (exponentBits.w << 6));
+    const float scale = ldexp(1.0, exponent - 127) / 511.0;
+
+    // bitfieldExtract sign-extends the mantissas of an ivec4
+    const vec4 m0 = vec4(bitfieldExtract(ivec4(packed), 0, 10)) * scale;
+    const vec4 m1 = vec4(bitfieldExtract(ivec4(packed), 10, 10)) * scale;
+    const vec4 m2 = vec4(bitfieldExtract(ivec4(packed), 20, 10)) * scale;
+    return SH_Coefficients(vec4(m0.x, m1.x, m2.x, m0.y), vec4(m1.y, m2.y, m0.z, m1.z), vec4(m2.z, m0.w, m1.w, m2.w));
+}
+
+// Programs specialized for a grid (LPV_GRID_SIZE, e.g. ivec3(32, 14, 20), see GridSizePrograms) only access volumes of
+// its size, their bounds checks compare against constants instead of queried sizes
+#ifdef LPV_GRID_SIZE
+#define SH_VOLUME_SIZE(query) LPV_GRID_SIZE
+#else
+#define SH_VOLUME_SIZE(query) query
+#endif
+
+// Parameters of the functions reading a SH volume, either the 3 RGBA16F volumes or the packed one. SH_VOLUME_ARGS
+// forwards them to another of these functions.
+#if SH_ENCODING == SH_ENCODING_RGBA16F
+#define SH_VOLUME_PARAMS sampler3D shR, sampler3D shG, sampler3D shB
+#define SH_VOLUME_ARGS shR, shG, shB
+
+ivec3 SH_GetVolumeSize(SH_VOLUME_PARAMS) {
+    return SH_VOLUME_SIZE(textureSize(shR, 0));
+}
+
+SH_Coefficients SH_FetchTexel(SH_VOLUME_PARAMS, ivec3 cellIndex) {
+    return SH_Coefficients(texelFetch(shR, cellIndex, 0), texelFetch(shG, cellIndex, 0), texelFetch(shB, cellIndex, 0));
+}
+
+// Trilinearly filtered coefficients, the volumes are clamped to a black border
+SH_Coefficients SH_SampleVolume(SH_VOLUME_PARAMS, vec3 uvw) {
+    return SH_Coefficients(textureLod(shR, uvw, 0.0), textureLod(shG, uvw, 0.0), textureLod(shB, uvw, 0.0));
+}
+#else
+#define SH_VOLUME_PARAMS usampler3D shPacked
+#define SH_VOLUME_ARGS shPacked
+
+ivec3 SH_GetVolumeSize(SH_VOLUME_PARAMS) {
+    return SH_VOLUME_SIZE(textureSize(shPacked, 0));
+}
+
+SH_Coefficients SH_FetchTexel(SH_VOLUME_PARAMS, ivec3 cellIndex) {
+    return SH_DecodeSharedExponent(texelFetch(shPacked, cellIndex, 0));
+}
+#endif
+
+// Fetch the SH coefficients of a cell, cells outside of the grid hold no radiance
+SH_Coefficients SH_FetchCell(SH_VOLUME_PARAMS, ivec3 cellIndex) {
+    if (any(lessThan(cellIndex, ivec3(0))) || any(greaterThanEqual(cellIndex, SH_GetVolumeSize(SH_VOLUME_ARGS)))) {
+        return SH_Coefficients(vec4(0.0), vec4(0.0), vec4(0.0));
+    }
+    return SH_FetchTexel(SH_VOLUME_ARGS, cellIndex);
+}
+
+#if SH_ENCODING != SH_ENCODING_RGBA16F
+// Packed cells can't be filtered by the sampler, they get decoded first
+SH_Coefficients SH_SampleVolume(SH_VOLUME_PARAMS, vec3 uvw) {
+    const vec3 texel = uvw * vec3(SH_GetVolumeSize(SH_VOLUME_ARGS)) - 0.5;
+    const ivec3 baseIndex = ivec3(floor(texel));
+    const vec3 t = texel - vec3(baseIndex);
+
+    SH_Coefficients result = SH_Coefficients(vec4(0.0), vec4(0.0), vec4(0.0));
+    for (int corner = 0; corner < 8; ++corner) {
+        const ivec3 offset = ivec3(corner & 1, (corner >> 1) & 1, corner >> 2);
+        const vec3 weights = mix(1.0 - t, t, vec3(offset));
+        const float weight = weights.x * weights.y * weights.z;
+
+        const SH_Coefficients c = SH_FetchCell(SH_VOLUME_ARGS, baseIndex + offset);
+        result.red += weight * c.red;
+        result.green += weight * c.green;
+        result.blue += weight * c.blue;
+    }
+    return result;
+}
+#endif
+
+// The volume a compute kernel reads from texture units SH_INPUT_BINDING and up, pass SH_INPUT_VOLUME as the
+// SH_VOLUME_PARAMS arguments
+#ifdef SH_INPUT_BINDING
+#if SH_ENCODING == SH_ENCODING_RGBA16F
+layout(binding = SH_INPUT_BINDING) uniform sampler3D SH_R;
+layout(binding = SH_INPUT_BINDING + 1) uniform sampler3D SH_G;
+layout(binding = SH_INPUT_BINDING + 2) uniform sampler3D SH_B;
+#define SH_INPUT_VOLUME SH_R, SH_G, SH_B
+#else
+layout(binding = SH_INPUT_BINDING) uniform usampler3D SH_Packed;
+#define SH_INPUT_VOLUME SH_Packed
+#endif
+#endif
+
+// The volume a compute kernel writes to image units SH_OUTPUT_BINDING and up
+#ifdef SH_OUTPUT_BINDING
+#if SH_ENCODING == SH_ENCODING_RGBA16F
+layout(binding = SH_OUTPUT_BINDING, rgba16f) uniform writeonly image3D Out_SH_R;
+layout(binding = SH_OUTPUT_BINDING + 1, rgba16f) uniform writeonly image3D Out_SH_G;
+layout(binding = SH_OUTPUT_BINDING + 2, rgba16f) uniform writeonly image3D Out_SH_B;
+
+ivec3 SH_GetOutputSize() {
+    return SH_VOLUME_SIZE(imageSize(Out_SH_R));
+}
+
+void SH_StoreCell(ivec3 cellIndex, SH_Coefficients c) {
+    imageStore(Out_SH_R, cellIndex, c.red);
+    imageStore(Out_SH_G, cellIndex, c.green);
+    imageStore(Out_SH_B, cellIndex, c.blue);
+}
+#else
+layout(binding = SH_OUTPUT_BINDING, rgba32ui) uniform writeonly uimage3D Out_SH_Packed;
+
+ivec3 SH_GetOutputSize() {
+    return SH_VOLUME_SIZE(imageSize(Out_SH_Packed));
+}
+
+void SH_StoreCell(ivec3 cellIndex, SH_Coefficients c) {
+    imageStore(Out_SH_Packed, cellIndex, SH_EncodeSharedExponent(c));
+}
+#endif
+#endif
+
+#endif
@@ -8,7 +8,9 @@ layout(binding = 1) uniform sampler2D RSMNormal;
 layout(binding = 2) uniform sampler2D RSMFlux;
 
 // Uniform for grid parameters
-layout(location = 0) uniform RadianceInjection uInjection;
+layout(binding = 0, std140) uniform RadianceInjectionBlock {
+    RadianceInjection uInjection;
+};
 
 // Output data
 layout(location = 0) out VertexData {
@@ -28,10 +30,10 @@ void main() {
 
     // Set output variables
     vs_out.normal = normal;
-    vs_out.flux = flux;
+    vs_out.flux = flux * uInjection.vplFluxScale;
 
     // Calculate the cell index for the grid
-    const ivec3 cellIndex = ivec3((position - uInjection.gridAABBMin) / uInjection.gridCellSize + 0.5 * normal);
+    const ivec3 cellIndex = getVPLCellIndex(position, normal, uInjection.gridAABBMin, uInjection.gridCellSize);
     vs_out.cellIndex = cellIndex;
 
     // Convert cell index to NDC space for rendering
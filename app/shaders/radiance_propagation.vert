@@ -3,7 +3,9 @@
 #include "lib/lpv.glsl"
 
 // Input uniform data for radiance injection
-layout(location = 0) uniform RadianceInjection uInjection;
+layout(binding = 0, std140) uniform RadianceInjectionBlock {
+    RadianceInjection uInjection;
+};
 
 // Output vertex data
 layout(location = 0) out VertexData {
@@ -1,5 +1,9 @@
 #version 460 core
 
+#define MATERIAL_BINDING 2
+
+// Before any declaration, it may enable GL_ARB_bindless_texture
+#include "lib/material.glsl"
 #include "lib/pbr.glsl"
 
 // Input attributes
@@ -19,22 +23,12 @@ layout(binding = 1) uniform DirectionalLight {
     vec3 color;
 } uLight;
 
-layout(binding = 2) uniform PrimitiveMaterial {
-    int baseColorTextureIndex;
-    int metallicRoughnessTextureIndex;
-    int normalTextureIndex;
-    int occlusionTextureIndex;
-    int emissiveTextureIndex;
-} uMaterial;
-
-layout(binding = 0) uniform sampler2D uTextures[5]; // Array of texture samplers
-
 void main() {
     // Base color and alpha
     vec3 baseColor = vec3(0);
     float alpha = 1.0;
-    if (uMaterial.baseColorTextureIndex != -1) {
-        vec4 color = texture(uTextures[uMaterial.baseColorTextureIndex], vTexCoords);
+    if (hasMaterialTexture(kBaseColorTexture)) {
+        vec4 color = sampleMaterialTexture(kBaseColorTexture, vTexCoords);
         baseColor = color.rgb;
         alpha = color.a;
     }
@@ -47,30 +41,28 @@ void main() {
     // Metallic and roughness
     float metallic = 0.0;
     float roughness = 0.5;
-    if (uMaterial.metallicRoughnessTextureIndex != -1) {
-        vec4 metallicRoughness = texture(uTextures[uMaterial.metallicRoughnessTextureIndex], vTexCoords);
+    if (hasMaterialTexture(kMetallicRoughnessTexture)) {
+        vec4 metallicRoughness = sampleMaterialTexture(kMetallicRoughnessTexture, vTexCoords);
         metallic = metallicRoughness.b;
         roughness = metallicRoughness.g;
     }
 
     // Normal calculation
     vec3 normal = normalize(vTBN[2]);
-    if (uMaterial.normalTextureIndex != -1) {
-        vec3 normalColor = texture(uTextures[uMaterial.normalTextureIndex], vTexCoords).rgb;
-        vec3 tangentNormal = normalColor * 2.0 - 1.0;
-        normal = tangentNormal * transpose(vTBN);
+    if (hasMaterialTexture(kNormalTexture)) {
+        normal = sampleMaterialNormal(vTexCoords) * transpose(vTBN);
     }
 
     // Ambient occlusion
     float ao = 1.0;
-    if (uMaterial.occlusionTextureIndex != -1) {
-        ao = texture(uTextures[uMaterial.occlusionTextureIndex], vTexCoords).r;
+    if (hasMaterialTexture(kOcclusionTexture)) {
+        ao = sampleMaterialTexture(kOcclusionTexture, vTexCoords).r;
     }
 
     // Emissive color
     vec3 emissive = vec3(0);
-    if (uMaterial.emissiveTextureIndex != -1) {
-        emissive = texture(uTextures[uMaterial.emissiveTextureIndex], vTexCoords).rgb;
+    if (hasMaterialTexture(kEmissiveTexture)) {
+        emissive = sampleMaterialTexture(kEmissiveTexture, vTexCoords).rgb;
     }
 
     // RSM outputs (position, normal and flux)
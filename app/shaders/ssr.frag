@@ -22,7 +22,9 @@ layout(binding = 1) uniform sampler2D gNormal;
 layout(binding = 2) uniform sampler2D gMetallicRoughnessAO;
 layout(binding = 3) uniform sampler2D sceneColor;
 
-uniform float reflectionFactor;
+layout(binding = 1, std140) uniform SSR {
+    float reflectionFactor;
+};
 
 vec3 F_Schlick(vec3 F0, vec3 albedo, float NdotV, float roughness) {
     float roughnessFactor = pow(1.0 - roughness, 5.0);
@@ -0,0 +1,29 @@
+#include "startup_timeline.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
+
+StartupTimeline::StartupTimeline() : m_Start(std::chrono::steady_clock::now()) {}
+
+void StartupTimeline::mark(const char* name)
+{
+    if (hasMark(name))
+        return;
+
+    const auto elapsed = std::chrono::steady_clock::now() - m_Start;
+    m_Milestones.push_back({name, std::chrono::duration<double, std::milli>(elapsed).count()});
+}
+
+bool StartupTimeline::hasMark(const char* name) const
+{
+    return std::ranges::any_of(m_Milestones,
+                               [name](const Milestone& milestone) { return std::string_view {milestone.name} == name; });
+}
+
+void StartupTimeline::print() const
+{
+    std::printf("Startup timeline:\n");
+    for (const auto& [name, milliseconds] : m_Milestones)
+        std::printf("  %-20s %9.1f ms\n", name, milliseconds);
+}
\ No newline at end of file
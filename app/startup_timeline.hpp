@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+// Milestones of the startup in milliseconds since the timeline was created, at the entry of main. Only the first mark
+// of a milestone counts, so a frame can mark one every time it reaches it.
+class StartupTimeline
+{
+public:
+    StartupTimeline();
+
+    void mark(const char* name);
+    bool hasMark(const char* name) const;
+
+    // One line per milestone, in the order they were reached
+    void print() const;
+
+private:
+    struct Milestone
+    {
+        const char* name;
+        double      milliseconds;
+    };
+
+    std::chrono::steady_clock::time_point m_Start;
+    std::vector<Milestone>                m_Milestones;
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "state_tracker.hpp"
+
+StateTracker::Stats& StateTracker::Stats::operator+=(const Stats& other)
+{
+    for (uint32_t i = 0; i < numBinds.size(); ++i)
+    {
+        numBinds[i] += other.numBinds[i];
+        numSkipped[i] += other.numSkipped[i];
+    }
+    return *this;
+}
+
+void StateTracker::reset()
+{
+    m_Pipeline.reset();
+    m_VertexBuffers.reset();
+    m_Material.reset();
+    m_Stats = {};
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include <array>
+#include <optional>
+
+// The state a geometry pass last bound while drawing a view, drops the binds that would not change it. GL state is
+// not tracked across passes, every view starts from a reset tracker.
+class StateTracker
+{
+public:
+    enum class State
+    {
+        ePipeline = 0,
+        eVertexBuffers, // Merged vertex and index buffer of a vertex array
+        eMaterial,      // PrimitiveMaterial uniform block and its textures
+        eCount
+    };
+
+    struct Stats
+    {
+        std::array<uint32_t, static_cast<uint32_t>(State::eCount)> numBinds {};
+        std::array<uint32_t, static_cast<uint32_t>(State::eCount)> numSkipped {};
+
+        Stats& operator+=(const Stats&);
+    };
+
+    void reset();
+
+    // Whether the state has to be bound, records it as bound then
+    bool setPipeline(size_t pipelineHash) { return set(State::ePipeline, m_Pipeline, pipelineHash); }
+    bool setVertexBuffers(GLuint vertexArray, GLuint vertexBuffer, GLuint indexBuffer)
+    {
+        return set(State::eVertexBuffers, m_VertexBuffers, {vertexArray, vertexBuffer, indexBuffer});
+    }
+    bool setMaterial(uint32_t materialIndex) { return set(State::eMaterial, m_Material, materialIndex); }
+
+    const Stats& getStats() const { return m_Stats; }
+
+private:
+    template<typename T>
+    bool set(State state, std::optional<T>& bound, const T& value)
+    {
+        const auto index = static_cast<uint32_t>(state);
+        if (bound == value)
+        {
+            ++m_Stats.numSkipped[index];
+            return false;
+        }
+
+        bound = value;
+        ++m_Stats.numBinds[index];
+        return true;
+    }
+
+private:
+    std::optional<size_t>                m_Pipeline;
+    std::optional<std::array<GLuint, 3>> m_VertexBuffers;
+    std::optional<uint32_t>              m_Material;
+
+    Stats m_Stats;
+};
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "texture_cache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+    constexpr std::array<uint8_t, 12> kIdentifier {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    // Key/value pair holding the source hash, in hexadecimal
+    constexpr std::string_view kSourceHashKey = "LPVsourceHash";
+
+    struct Header
+    {
+        std::array<uint8_t, 12> identifier;
+        uint32_t                vkFormat;
+        uint32_t                typeSize;
+        uint32_t                pixelWidth;
+        uint32_t                pixelHeight;
+        uint32_t                pixelDepth;
+        uint32_t                layerCount;
+        uint32_t                faceCount;
+        uint32_t                levelCount;
+        uint32_t                supercompressionScheme;
+        uint32_t                dfdByteOffset;
+        uint32_t                dfdByteLength;
+        uint32_t                kvdByteOffset;
+        uint32_t                kvdByteLength;
+        uint64_t                sgdByteOffset;
+        uint64_t                sgdByteLength;
+    };
+    static_assert(sizeof(Header) == 80);
+
+    struct LevelIndex
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    // Basic descriptor block of the Khronos Data Format, one sample per 64-bit half of the block
+    struct DescriptorBlock
+    {
+        uint32_t               totalSize;
+        uint32_t               vendorIdAndType; // Khronos, basic
+        uint16_t               versionNumber;
+        uint16_t               descriptorBlockSize;
+        uint8_t                colorModel;
+        uint8_t                colorPrimaries;
+        uint8_t                transferFunction;
+        uint8_t                flags;
+        std::array<uint8_t, 4> texelBlockDimension; // Minus one
+        std::array<uint8_t, 8> bytesPlane;
+    };
+    static_assert(sizeof(DescriptorBlock) == 28);
+
+    struct DescriptorSample
+    {
+        uint16_t               bitOffset;
+        uint8_t                bitLength; // Minus one
+        uint8_t                channelType;
+        std::array<uint8_t, 4> samplePosition;
+        uint32_t               sampleLower;
+        uint32_t               sampleUpper;
+    };
+    static_assert(sizeof(DescriptorSample) == 16);
+
+    // VK_FORMAT_BC1_RGB_*, VK_FORMAT_BC3_*, VK_FORMAT_BC4_UNORM and VK_FORMAT_BC5_UNORM
+    uint32_t getVkFormat(BlockFormat format, bool isSRGB)
+    {
+        switch (format)
+        {
+            case BlockFormat::eBC1:
+                return isSRGB ? 132 : 131;
+            case BlockFormat::eBC3:
+                return isSRGB ? 138 : 137;
+            case BlockFormat::eBC4:
+                return 139;
+            default:
+                return 141;
+        }
+    }
+
+    std::optional<std::pair<BlockFormat, bool>> getBlockFormat(uint32_t vkFormat)
+    {
+        switch (vkFormat)
+        {
+            case 131:
+            case 132:
+                return std::pair {BlockFormat::eBC1, vkFormat == 132};
+            case 137:
+            case 138:
+                return std::pair {BlockFormat::eBC3, vkFormat == 138};
+            case 139:
+                return std::pair {BlockFormat::eBC4, false};
+            case 141:
+                return std::pair {BlockFormat::eBC5, false};
+            default:
+                return std::nullopt;
+        }
+    }
+
+    std::vector<uint8_t> makeDataFormatDescriptor(BlockFormat format, bool isSRGB)
+    {
+        // Color model (KHR_DF_MODEL_BC*) and the channel of each half: color, alpha (15), red or green
+        std::vector<uint8_t> channels;
+        uint8_t              colorModel = 0;
+        switch (format)
+        {
+            case BlockFormat::eBC1:
+                colorModel = 128;
+                channels   = {0};
+                break;
+            case BlockFormat::eBC3:
+                colorModel = 130;
+                channels   = {15, 0};
+                break;
+            case BlockFormat::eBC4:
+                colorModel = 131;
+                channels   = {0};
+                break;
+            case BlockFormat::eBC5:
+                colorModel = 132;
+                channels   = {0, 1};
+                break;
+        }
+
+        const auto blockSize =
+            static_cast<uint32_t>(sizeof(DescriptorBlock) + sizeof(DescriptorSample) * channels.size());
+
+        const DescriptorBlock block {
+            .totalSize           = blockSize,
+            .vendorIdAndType     = 0,
+            .versionNumber       = 2,
+            .descriptorBlockSize = static_cast<uint16_t>(blockSize - sizeof(uint32_t)),
+            .colorModel          = colorModel,
+            .colorPrimaries      = 1, // BT.709
+            .transferFunction    = static_cast<uint8_t>(isSRGB ? 2 : 1),
+            .flags               = 0,
+            .texelBlockDimension = {3, 3, 0, 0},
+            .bytesPlane          = {static_cast<uint8_t>(getBlockSize(format)), 0, 0, 0, 0, 0, 0, 0},
+        };
+
+        std::vector<uint8_t> descriptor(blockSize);
+        std::memcpy(descriptor.data(), &block, sizeof(block));
+        for (size_t i = 0; i < channels.size(); ++i)
+        {
+            const DescriptorSample sample {
+                .bitOffset      = static_cast<uint16_t>(i * 64),
+                .bitLength      = 63,
+                .channelType    = channels[i],
+                .samplePosition = {0, 0, 0, 0},
+                .sampleLower    = 0,
+                .sampleUpper    = 0xFFFFFFFF,
+            };
+            std::memcpy(descriptor.data() + sizeof(block) + i * sizeof(sample), &sample, sizeof(sample));
+        }
+        return descriptor;
+    }
+
+    std::string toHex(uint64_t hash)
+    {
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+        return hex;
+    }
+
+    std::filesystem::path getTexturePath(const std::filesystem::path& directory, uint64_t sourceHash)
+    {
+        return directory / (toHex(sourceHash) + ".ktx2");
+    }
+
+    size_t alignUp(size_t offset, size_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+} // namespace
+
+TextureCache::TextureCache(const std::filesystem::path& directory) : m_Directory(directory)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    m_IsWritable = std::filesystem::is_directory(directory, error);
+}
+
+std::optional<TextureCache::Texture> TextureCache::load(uint64_t sourceHash) const
+{
+    std::ifstream file {getTexturePath(m_Directory, sourceHash), std::ios::binary};
+    if (!file)
+        return std::nullopt;
+    const std::vector<uint8_t> bytes {std::istreambuf_iterator<char>(file), {}};
+
+    Header header {};
+    if (bytes.size() < sizeof(header))
+        return std::nullopt;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    const auto blockFormat = getBlockFormat(header.vkFormat);
+    if (header.identifier != kIdentifier || !blockFormat || header.typeSize != 1 || header.pixelWidth == 0 ||
+        header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount != 0 || header.faceCount != 1 ||
+        header.supercompressionScheme != 0 ||
+        header.levelCount != std::bit_width(std::max(header.pixelWidth, header.pixelHeight)) ||
+        sizeof(header) + sizeof(LevelIndex) * header.levelCount > bytes.size() ||
+        static_cast<size_t>(header.kvdByteOffset) + header.kvdByteLength > bytes.size())
+        return std::nullopt;
+
+    // The key/value pairs are a length, then the key and the value both null terminated, padded to 4 bytes
+    const auto sourceHashPair = std::string(kSourceHashKey) + '\0' + toHex(sourceHash) + '\0';
+    const auto kvdEnd         = static_cast<size_t>(header.kvdByteOffset) + header.kvdByteLength;
+    bool       isSourceHash   = false;
+    for (size_t offset = header.kvdByteOffset; offset + sizeof(uint32_t) <= kvdEnd;)
+    {
+        uint32_t length = 0;
+        std::memcpy(&length, &bytes[offset], sizeof(length));
+        offset += sizeof(length);
+        if (length > kvdEnd - offset)
+            return std::nullopt;
+
+        const std::string_view pair {reinterpret_cast<const char*>(&bytes[offset]), length};
+        isSourceHash = isSourceHash || pair == sourceHashPair;
+        offset       = alignUp(offset + length, 4);
+    }
+    if (!isSourceHash)
+        return std::nullopt;
+
+    Texture texture {
+        .format = blockFormat->first,
+        .isSRGB = blockFormat->second,
+        .width  = header.pixelWidth,
+        .height = header.pixelHeight,
+        .levels = std::vector<std::vector<uint8_t>>(header.levelCount),
+    };
+    for (uint32_t level = 0; level < header.levelCount; ++level)
+    {
+        LevelIndex index {};
+        std::memcpy(&index, &bytes[sizeof(header) + sizeof(index) * level], sizeof(index));
+
+        const auto size = getCompressedSize(
+            texture.format, std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u));
+        if (index.byteLength != size || index.byteOffset > bytes.size() || bytes.size() - index.byteOffset < size)
+            return std::nullopt;
+
+        const auto* data = &bytes[index.byteOffset];
+        texture.levels[level].assign(data, data + size);
+    }
+    return texture;
+}
+
+void TextureCache::save(uint64_t sourceHash, const Texture& texture) const
+{
+    if (!m_IsWritable)
+        return;
+
+    const auto levelCount = static_cast<uint32_t>(texture.levels.size());
+    const auto descriptor = makeDataFormatDescriptor(texture.format, texture.isSRGB);
+
+    std::vector<uint8_t> keyValue(sizeof(uint32_t));
+    const auto           pair   = std::string(kSourceHashKey) + '\0' + toHex(sourceHash) + '\0';
+    const auto           length = static_cast<uint32_t>(pair.size());
+    std::memcpy(keyValue.data(), &length, sizeof(length));
+    keyValue.insert(keyValue.end(), pair.begin(), pair.end());
+    keyValue.resize(alignUp(keyValue.size(), 4));
+
+    const auto dfdOffset = sizeof(Header) + sizeof(LevelIndex) * levelCount;
+    const auto kvdOffset = dfdOffset + descriptor.size();
+
+    std::vector<uint8_t> bytes(kvdOffset);
+    bytes.insert(bytes.end(), keyValue.begin(), keyValue.end());
+
+    // The smallest level first, each aligned to a block
+    std::vector<LevelIndex> levelIndices(levelCount);
+    for (auto level = levelCount; level-- > 0;)
+    {
+        bytes.resize(alignUp(bytes.size(), getBlockSize(texture.format)));
+        levelIndices[level] = {
+            .byteOffset             = bytes.size(),
+            .byteLength             = texture.levels[level].size(),
+            .uncompressedByteLength = texture.levels[level].size(),
+        };
+        bytes.insert(bytes.end(), texture.levels[level].begin(), texture.levels[level].end());
+    }
+
+    const Header header {
+        .identifier             = kIdentifier,
+        .vkFormat               = getVkFormat(texture.format, texture.isSRGB),
+        .typeSize               = 1,
+        .pixelWidth             = texture.width,
+        .pixelHeight            = texture.height,
+        .pixelDepth             = 0,
+        .layerCount             = 0,
+        .faceCount              = 1,
+        .levelCount             = levelCount,
+        .supercompressionScheme = 0,
+        .dfdByteOffset          = static_cast<uint32_t>(dfdOffset),
+        .dfdByteLength          = static_cast<uint32_t>(descriptor.size()),
+        .kvdByteOffset          = static_cast<uint32_t>(kvdOffset),
+        .kvdByteLength          = static_cast<uint32_t>(keyValue.size()),
+        .sgdByteOffset          = 0,
+        .sgdByteLength          = 0,
+    };
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), levelIndices.data(), sizeof(LevelIndex) * levelCount);
+    std::memcpy(bytes.data() + dfdOffset, descriptor.data(), descriptor.size());
+
+    // Written aside and renamed, so that a texture compressed by another thread (duplicate source images) or launch at
+    // the same time is never torn. Every writer has a file of its own, the last rename wins.
+    const auto path          = getTexturePath(m_Directory, sourceHash);
+    const auto writerId      = std::hash<std::thread::id> {}(std::this_thread::get_id()) ^ std::random_device {}();
+    auto       temporaryPath = path;
+    temporaryPath += "." + std::to_string(writerId) + ".tmp";
+
+    std::error_code error;
+    {
+        std::ofstream file {temporaryPath, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file)
+        {
+            std::cerr << "Failed to write the texture: " << path << std::endl;
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+        std::filesystem::remove(temporaryPath, error);
+}
\ No newline at end of file
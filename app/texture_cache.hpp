@@ -0,0 +1,35 @@
+#pragma once
+
+#include "texture_compression.hpp"
+
+#include <filesystem>
+#include <optional>
+
+// Directory of block compressed textures, one KTX2 file per texture named after a hash of its source image and of how
+// it was compressed. The files are plain KTX2 (a data format descriptor, no supercompression, the levels smallest
+// first) that the usual tools open, the hash is also stored in their key/value data. A file of another hash, format
+// or layout is ignored, its texture compressed again.
+//
+// load() and save() only touch the file of their key, several threads may call them, for the same key too.
+class TextureCache
+{
+public:
+    struct Texture
+    {
+        BlockFormat                       format;
+        bool                              isSRGB;
+        uint32_t                          width;
+        uint32_t                          height;
+        std::vector<std::vector<uint8_t>> levels; // From the largest, down to 1x1
+    };
+
+    // Created if missing, the textures are only compressed when it cannot be
+    explicit TextureCache(const std::filesystem::path& directory);
+
+    std::optional<Texture> load(uint64_t sourceHash) const;
+    void                   save(uint64_t sourceHash, const Texture& texture) const;
+
+private:
+    std::filesystem::path m_Directory;
+    bool                  m_IsWritable {false};
+};
\ No newline at end of file
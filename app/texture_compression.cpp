@@ -0,0 +1,324 @@
+#include "texture_compression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    using Block = std::array<std::array<uint8_t, 4>, 16>;
+
+    // Texels of a 4x4 block, the blocks past the edges repeat its last row and column
+    Block loadBlock(const MipLevel& level, uint32_t blockX, uint32_t blockY)
+    {
+        Block block;
+        for (uint32_t y = 0; y < 4; ++y)
+        {
+            for (uint32_t x = 0; x < 4; ++x)
+            {
+                const auto sourceX = std::min(blockX * 4 + x, level.width - 1);
+                const auto sourceY = std::min(blockY * 4 + y, level.height - 1);
+                std::memcpy(block[y * 4 + x].data(), &level.rgba[(sourceY * level.width + sourceX) * 4], 4);
+            }
+        }
+        return block;
+    }
+
+    void storeLittleEndian(uint8_t* bytes, uint64_t value, uint32_t numBytes)
+    {
+        for (uint32_t i = 0; i < numBytes; ++i)
+            bytes[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+
+    uint16_t packRGB565(const std::array<float, 3>& color)
+    {
+        const auto quantize = [](float value, float maxValue) {
+            return static_cast<uint16_t>(std::clamp(std::round(value * maxValue / 255.0f), 0.0f, maxValue));
+        };
+        return static_cast<uint16_t>(quantize(color[0], 31.0f) << 11 | quantize(color[1], 63.0f) << 5 |
+                                     quantize(color[2], 31.0f));
+    }
+
+    // Bit replication of the decoders
+    std::array<float, 3> unpackRGB565(uint16_t color)
+    {
+        const auto r = color >> 11 & 31, g = color >> 5 & 63, b = color & 31;
+        return {static_cast<float>(r << 3 | r >> 2),
+                static_cast<float>(g << 2 | g >> 4),
+                static_cast<float>(b << 3 | b >> 2)};
+    }
+
+    // 4-color block (color0 > color1) whose endpoints are the extremes of the texels along their principal axis
+    void compressBC1Block(const Block& block, uint8_t* output)
+    {
+        std::array<float, 3> mean {};
+        for (const auto& texel : block)
+        {
+            for (uint32_t c = 0; c < 3; ++c)
+                mean[c] += texel[c] / 16.0f;
+        }
+
+        std::array<std::array<float, 3>, 3> covariance {};
+        for (const auto& texel : block)
+        {
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                for (uint32_t j = 0; j < 3; ++j)
+                    covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+            }
+        }
+
+        // Power iteration, a flat block keeps the luminance axis
+        std::array<float, 3> axis {1.0f, 1.0f, 1.0f};
+        for (uint32_t iteration = 0; iteration < 8; ++iteration)
+        {
+            std::array<float, 3> next {};
+            for (uint32_t i = 0; i < 3; ++i)
+                next[i] = covariance[i][0] * axis[0] + covariance[i][1] * axis[1] + covariance[i][2] * axis[2];
+
+            const auto length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+            if (length < 1e-6f)
+                break;
+            axis = {next[0] / length, next[1] / length, next[2] / length};
+        }
+
+        float minProjection = 0.0f, maxProjection = 0.0f;
+        for (const auto& texel : block)
+        {
+            const auto projection = (texel[0] - mean[0]) * axis[0] + (texel[1] - mean[1]) * axis[1] +
+                                    (texel[2] - mean[2]) * axis[2];
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        auto color0 = packRGB565({mean[0] + axis[0] * maxProjection,
+                                  mean[1] + axis[1] * maxProjection,
+                                  mean[2] + axis[2] * maxProjection});
+        auto color1 = packRGB565({mean[0] + axis[0] * minProjection,
+                                  mean[1] + axis[1] * minProjection,
+                                  mean[2] + axis[2] * minProjection});
+        if (color0 < color1)
+            std::swap(color0, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1)
+        {
+            const auto endpoint0 = unpackRGB565(color0);
+            const auto endpoint1 = unpackRGB565(color1);
+
+            std::array<std::array<float, 3>, 4> palette;
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                palette[0][c] = endpoint0[c];
+                palette[1][c] = endpoint1[c];
+                palette[2][c] = (2.0f * endpoint0[c] + endpoint1[c]) / 3.0f;
+                palette[3][c] = (endpoint0[c] + 2.0f * endpoint1[c]) / 3.0f;
+            }
+
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t bestIndex    = 0;
+                float    bestDistance = std::numeric_limits<float>::max();
+                for (uint32_t index = 0; index < 4; ++index)
+                {
+                    float distance = 0.0f;
+                    for (uint32_t c = 0; c < 3; ++c)
+                        distance += (block[i][c] - palette[index][c]) * (block[i][c] - palette[index][c]);
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex    = index;
+                    }
+                }
+                indices |= bestIndex << (i * 2);
+            }
+        }
+
+        storeLittleEndian(output, color0, 2);
+        storeLittleEndian(output + 2, color1, 2);
+        storeLittleEndian(output + 4, indices, 4);
+    }
+
+    // 8-value block (value0 > value1) between the extremes of a channel
+    void compressBC4Block(const Block& block, uint32_t channel, uint8_t* output)
+    {
+        uint8_t minValue = 255, maxValue = 0;
+        for (const auto& texel : block)
+        {
+            minValue = std::min(minValue, texel[channel]);
+            maxValue = std::max(maxValue, texel[channel]);
+        }
+
+        uint64_t indices = 0;
+        if (maxValue != minValue)
+        {
+            std::array<float, 8> palette {static_cast<float>(maxValue), static_cast<float>(minValue)};
+            for (uint32_t index = 2; index < 8; ++index)
+                palette[index] = ((8.0f - index) * maxValue + (index - 1.0f) * minValue) / 7.0f;
+
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint64_t bestIndex    = 0;
+                float    bestDistance = std::numeric_limits<float>::max();
+                for (uint32_t index = 0; index < 8; ++index)
+                {
+                    const auto distance = std::abs(block[i][channel] - palette[index]);
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex    = index;
+                    }
+                }
+                indices |= bestIndex << (i * 3);
+            }
+        }
+
+        output[0] = maxValue;
+        output[1] = minValue;
+        storeLittleEndian(output + 2, indices, 6);
+    }
+
+    float toLinear(uint8_t value)
+    {
+        const auto color = value / 255.0f;
+        return color <= 0.04045f ? color / 12.92f : std::pow((color + 0.055f) / 1.055f, 2.4f);
+    }
+
+    uint8_t toSRGB(float value)
+    {
+        const auto color = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::clamp(std::round(color * 255.0f), 0.0f, 255.0f));
+    }
+
+    uint8_t toUnorm(float value) { return static_cast<uint8_t>(std::clamp(std::round(value), 0.0f, 255.0f)); }
+
+    MipLevel downsample(const MipLevel& source, MipFilter filter)
+    {
+        static const auto kLinear = [] {
+            std::array<float, 256> linear;
+            for (uint32_t i = 0; i < 256; ++i)
+                linear[i] = toLinear(static_cast<uint8_t>(i));
+            return linear;
+        }();
+
+        MipLevel level {.width = std::max(source.width / 2, 1u), .height = std::max(source.height / 2, 1u), .rgba = {}};
+        level.rgba.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+        for (uint32_t y = 0; y < level.height; ++y)
+        {
+            for (uint32_t x = 0; x < level.width; ++x)
+            {
+                // The 2x2 texels of the source, an odd edge reuses its last row or column
+                std::array<const uint8_t*, 4> texels;
+                for (uint32_t i = 0; i < 4; ++i)
+                {
+                    const auto sourceX = std::min(x * 2 + (i & 1), source.width - 1);
+                    const auto sourceY = std::min(y * 2 + (i >> 1), source.height - 1);
+                    texels[i]          = &source.rgba[(sourceY * source.width + sourceX) * 4];
+                }
+
+                std::array<float, 4> sum {};
+                for (const auto* texel : texels)
+                {
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        if (c < 3 && filter == MipFilter::eSRGB)
+                            sum[c] += kLinear[texel[c]];
+                        else if (c < 3 && filter == MipFilter::eNormal)
+                            sum[c] += texel[c] / 127.5f - 1.0f;
+                        else
+                            sum[c] += texel[c];
+                    }
+                }
+
+                auto* output = &level.rgba[(static_cast<size_t>(y) * level.width + x) * 4];
+                if (filter == MipFilter::eSRGB)
+                {
+                    for (uint32_t c = 0; c < 3; ++c)
+                        output[c] = toSRGB(sum[c] / 4.0f);
+                }
+                else if (filter == MipFilter::eNormal)
+                {
+                    const auto length = std::max(std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]), 1e-6f);
+                    for (uint32_t c = 0; c < 3; ++c)
+                        output[c] = toUnorm((sum[c] / length + 1.0f) * 127.5f);
+                }
+                else
+                {
+                    for (uint32_t c = 0; c < 3; ++c)
+                        output[c] = toUnorm(sum[c] / 4.0f);
+                }
+                output[3] = toUnorm(sum[3] / 4.0f);
+            }
+        }
+        return level;
+    }
+} // namespace
+
+uint32_t getBlockSize(BlockFormat format)
+{
+    return format == BlockFormat::eBC1 || format == BlockFormat::eBC4 ? 8 : 16;
+}
+
+size_t getCompressedSize(BlockFormat format, uint32_t width, uint32_t height)
+{
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+}
+
+std::vector<MipLevel> generateMipChain(std::vector<uint8_t> rgba, uint32_t width, uint32_t height, MipFilter filter)
+{
+    std::vector<MipLevel> levels;
+    levels.push_back({.width = width, .height = height, .rgba = std::move(rgba)});
+    while (levels.back().width > 1 || levels.back().height > 1)
+    {
+        auto level = downsample(levels.back(), filter);
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
+
+bool hasTranslucentTexels(const MipLevel& level)
+{
+    for (size_t i = 3; i < level.rgba.size(); i += 4)
+    {
+        if (level.rgba[i] != 255)
+            return true;
+    }
+    return false;
+}
+
+std::vector<uint8_t> compressLevel(const MipLevel& level, BlockFormat format, std::array<uint32_t, 2> channels)
+{
+    std::vector<uint8_t> blocks(getCompressedSize(format, level.width, level.height));
+
+    const auto numBlocksX = (level.width + 3) / 4;
+    const auto numBlocksY = (level.height + 3) / 4;
+    for (uint32_t blockY = 0; blockY < numBlocksY; ++blockY)
+    {
+        for (uint32_t blockX = 0; blockX < numBlocksX; ++blockX)
+        {
+            const auto block  = loadBlock(level, blockX, blockY);
+            auto*      output = &blocks[(static_cast<size_t>(blockY) * numBlocksX + blockX) * getBlockSize(format)];
+            switch (format)
+            {
+                case BlockFormat::eBC1:
+                    compressBC1Block(block, output);
+                    break;
+                case BlockFormat::eBC3:
+                    // Alpha block first, then the color block (always 4-color)
+                    compressBC4Block(block, 3, output);
+                    compressBC1Block(block, output + 8);
+                    break;
+                case BlockFormat::eBC4:
+                    compressBC4Block(block, channels[0], output);
+                    break;
+                case BlockFormat::eBC5:
+                    compressBC4Block(block, channels[0], output);
+                    compressBC4Block(block, channels[1], output + 8);
+                    break;
+            }
+        }
+    }
+    return blocks;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Block compression of RGBA8 images on the CPU, for the textures the GPU samples compressed: BC1 (RGB, 4 bits per
+// texel), BC3 (BC1 color and BC4 alpha, 8 bits), BC4 (one channel, 4 bits) and BC5 (two BC4 channels, 8 bits). The
+// endpoints of a block are the extremes of its texels along their principal axis, a single pass favoring the speed
+// of a first launch over the last bits of quality.
+enum class BlockFormat
+{
+    eBC1,
+    eBC3,
+    eBC4,
+    eBC5,
+};
+
+// Bytes of a 4x4 block
+uint32_t getBlockSize(BlockFormat format);
+// Of a level, partial blocks included
+size_t getCompressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+// How the texels of a level are averaged into the next one
+enum class MipFilter
+{
+    eLinear,
+    eSRGB,   // RGB averaged in linear space
+    eNormal, // RGB is a tangent space normal, renormalized
+};
+
+struct MipLevel
+{
+    uint32_t             width;
+    uint32_t             height;
+    std::vector<uint8_t> rgba;
+};
+
+// The image and its box filtered levels down to 1x1
+std::vector<MipLevel> generateMipChain(std::vector<uint8_t> rgba, uint32_t width, uint32_t height, MipFilter filter);
+
+bool hasTranslucentTexels(const MipLevel& level);
+
+// BC1 and BC3 compress RGB(A), BC4 the first of the channels (0 to 3 for RGBA) and BC5 both
+std::vector<uint8_t> compressLevel(const MipLevel&         level,
+                                   BlockFormat             format,
+                                   std::array<uint32_t, 2> channels = {0, 1});
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "uniform_ring.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+void UniformRing::create(GLsizeiptr frameSize)
+{
+    destroy();
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &m_Alignment);
+    allocate(frameSize);
+}
+
+void UniformRing::destroy()
+{
+    for (auto& region : m_Regions)
+    {
+        if (region.fence)
+            glDeleteSync(region.fence);
+        deleteRetiredBuffers(region);
+        region = {};
+    }
+    if (m_Buffer)
+    {
+        glUnmapNamedBuffer(m_Buffer);
+        glDeleteBuffers(1, &m_Buffer);
+    }
+    m_Buffer    = 0;
+    m_Mapped    = nullptr;
+    m_FrameSize = 0;
+    m_Frame     = 0;
+    m_Offset    = 0;
+}
+
+void UniformRing::beginFrame()
+{
+    m_Frame      = (m_Frame + 1) % kNumFrames;
+    m_Offset     = 0;
+    m_FrameStats = {};
+
+    // Only waits when the CPU runs kNumFrames ahead of the GPU
+    auto& region = m_Regions[m_Frame];
+    if (region.fence)
+    {
+        while (glClientWaitSync(region.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(region.fence);
+        region.fence = nullptr;
+        m_FrameStats.numGLCalls += 2;
+    }
+    deleteRetiredBuffers(region);
+}
+
+void UniformRing::endFrame()
+{
+    m_Regions[m_Frame].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_FrameStats.numGLCalls += 1;
+
+    m_LastFrameStats = m_FrameStats;
+}
+
+UniformAllocation UniformRing::push(const void* data, GLsizeiptr size, uint32_t numSetterCalls)
+{
+    assert(m_Buffer);
+
+    if (m_Offset + size > m_FrameSize)
+        grow(m_Offset + size);
+
+    const auto allocation = UniformAllocation {.offset = m_Offset, .size = size};
+    std::memcpy(m_Mapped + m_Frame * m_FrameSize + allocation.offset, data, size);
+
+    m_Offset = (m_Offset + size + m_Alignment - 1) / m_Alignment * m_Alignment;
+    m_FrameStats.numBlocks += 1;
+    m_FrameStats.numBytes += size;
+    m_FrameStats.numSetterCalls += numSetterCalls;
+
+    return allocation;
+}
+
+void UniformRing::bind(uint32_t binding, const UniformAllocation& allocation)
+{
+    glBindBufferRange(
+        GL_UNIFORM_BUFFER, binding, m_Buffer, m_Frame * m_FrameSize + allocation.offset, allocation.size);
+    m_FrameStats.numGLCalls += 1;
+}
+
+void UniformRing::deleteRetiredBuffers(Region& region)
+{
+    if (region.retiredBuffers.empty())
+        return;
+
+    glDeleteBuffers(static_cast<GLsizei>(region.retiredBuffers.size()), region.retiredBuffers.data());
+    region.retiredBuffers.clear();
+}
+
+void UniformRing::allocate(GLsizeiptr frameSize)
+{
+    constexpr GLbitfield kFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // Every region starts aligned like the allocations within it
+    m_FrameSize = (frameSize + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+    glCreateBuffers(1, &m_Buffer);
+    glNamedBufferStorage(m_Buffer, m_FrameSize * kNumFrames, nullptr, kFlags);
+    m_Mapped = static_cast<std::byte*>(glMapNamedBufferRange(m_Buffer, 0, m_FrameSize * kNumFrames, kFlags));
+}
+
+void UniformRing::grow(GLsizeiptr minFrameSize)
+{
+    VGFW_PROFILE_FUNCTION
+
+    auto frameSize = m_FrameSize;
+    while (frameSize < minFrameSize)
+        frameSize *= 2;
+
+    // What the frame pushed so far is copied, for the allocations bound after the grow
+    const auto oldBuffer = m_Buffer;
+    const auto oldFrame  = m_Mapped + m_Frame * m_FrameSize;
+    allocate(frameSize);
+    std::memcpy(m_Mapped + m_Frame * m_FrameSize, oldFrame, m_Offset);
+    glUnmapNamedBuffer(oldBuffer);
+
+    // Deleting the old buffer would reset the bindings the frame already made from it, it is kept until the fence of
+    // the frame signals. That fence comes after the frames in flight, whose fences no longer guard anything and whose
+    // retired buffers wait for it too.
+    auto& retiredBuffers = m_Regions[m_Frame].retiredBuffers;
+    for (auto& region : m_Regions)
+    {
+        if (region.fence)
+            glDeleteSync(region.fence);
+        region.fence = nullptr;
+        if (&region.retiredBuffers != &retiredBuffers)
+        {
+            std::ranges::move(region.retiredBuffers, std::back_inserter(retiredBuffers));
+            region.retiredBuffers.clear();
+        }
+    }
+    retiredBuffers.push_back(oldBuffer);
+
+    std::cerr << "UniformRing: grown to " << m_FrameSize << " bytes per frame" << std::endl;
+}
\ No newline at end of file
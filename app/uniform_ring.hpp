@@ -0,0 +1,81 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include <array>
+#include <vector>
+
+// Range of a UniformRing holding one uniform block, within the region of the frame it was pushed in
+struct UniformAllocation
+{
+    GLintptr   offset {0};
+    GLsizeiptr size {0};
+};
+
+// Per frame uniform blocks, written into a persistently mapped buffer split into kNumFrames regions. The passes push
+// their std140 structs while the FrameGraph is built and bind them by offset when it executes. A region is only
+// written again once the fence of the frame that used it has signaled, so the GPU is never stalled by an upload.
+// A frame that pushes more than its region holds grows the buffer, see grow().
+class UniformRing
+{
+public:
+    static constexpr uint32_t kNumFrames = 3;
+
+    void create(GLsizeiptr frameSize);
+    void destroy();
+
+    // Waits for the GPU to be done with the region of the frame kNumFrames ago, then allocates from it
+    void beginFrame();
+    // Fences the region of the frame
+    void endFrame();
+
+    // numSetterCalls is the count of glUniform* (or glBufferSubData) calls the block took before the ring, for the
+    // stats
+    template<typename T>
+    UniformAllocation push(const T& data, uint32_t numSetterCalls)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return push(&data, sizeof(T), numSetterCalls);
+    }
+    UniformAllocation push(const void* data, GLsizeiptr size, uint32_t numSetterCalls);
+
+    // glBindBufferRange of an allocation of the current frame to a uniform block binding
+    void bind(uint32_t binding, const UniformAllocation& allocation);
+
+    struct FrameStats
+    {
+        uint32_t   numBlocks {0};
+        GLsizeiptr numBytes {0};
+        uint32_t   numGLCalls {0};     // Fence wait and insertion, and the binds
+        uint32_t   numSetterCalls {0}; // What the same blocks took with the glUniform* setters
+    };
+
+    // Of the last frame ended
+    const FrameStats& getLastFrameStats() const { return m_LastFrameStats; }
+
+private:
+    // (Re)creates the mapped buffer with regions of at least frameSize bytes
+    void allocate(GLsizeiptr frameSize);
+    // Doubles the regions until the current one holds minFrameSize bytes, and moves what the frame already pushed
+    void grow(GLsizeiptr minFrameSize);
+
+private:
+    struct Region
+    {
+        GLsync              fence {nullptr};
+        std::vector<GLuint> retiredBuffers; // Replaced by a grow during the frame, deleted once the fence signals
+    };
+
+    void deleteRetiredBuffers(Region& region);
+
+    GLuint                         m_Buffer {0};
+    std::byte*                     m_Mapped {nullptr};
+    GLsizeiptr                     m_FrameSize {0};
+    GLint                          m_Alignment {0};
+    std::array<Region, kNumFrames> m_Regions;
+    uint32_t                       m_Frame {0};
+    GLsizeiptr                     m_Offset {0};
+
+    FrameStats m_FrameStats;
+    FrameStats m_LastFrameStats;
+};
\ No newline at end of file
@@ -3,24 +3,10 @@
 
 #include "vgfw.hpp"
 
-void uploadCameraUniform(FrameGraph& fg, FrameGraphBlackboard& blackboard, const Camera::CameraUniform& cameraUniform)
+void uploadCameraUniform(FrameGraphBlackboard&        blackboard,
+                         UniformRing&                 uniformRing,
+                         const Camera::CameraUniform& cameraUniform)
 {
-    blackboard.add<CameraData>() = fg.addCallbackPass<CameraData>(
-        "Upload CameraUniform",
-        [&](FrameGraph::Builder& builder, CameraData& data) {
-            data.cameraUniform = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
-                "CameraUniform", {.size = sizeof(Camera::CameraUniform)});
-            data.cameraUniform = builder.write(data.cameraUniform);
-        },
-        [=](const CameraData& data, FrameGraphPassResources& resources, void* ctx) {
-            NAMED_DEBUG_MARKER("Upload Camera Uniform");
-            VGFW_PROFILE_GL("Upload Camera Uniform");
-            VGFW_PROFILE_NAMED_SCOPE("Upload Camera Uniform");
-
-            static_cast<vgfw::renderer::RenderContext*>(ctx)->upload(
-                vgfw::renderer::framegraph::getBuffer(resources, data.cameraUniform),
-                0,
-                sizeof(Camera::CameraUniform),
-                &cameraUniform);
-        });
+    // Written into the mapped ring right away, the passes bind it by offset. It was a glBufferSubData.
+    blackboard.add<CameraData>().cameraUniform = uniformRing.push(cameraUniform, 1);
 }
\ No newline at end of file
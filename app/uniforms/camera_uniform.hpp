@@ -1,7 +1,10 @@
 #pragma once
 
 #include "camera.hpp"
+#include "uniform_ring.hpp"
 
 #include <fg/Fwd.hpp>
 
-void uploadCameraUniform(FrameGraph& fg, FrameGraphBlackboard& blackboard, const Camera::CameraUniform& cameraUniform);
\ No newline at end of file
+void uploadCameraUniform(FrameGraphBlackboard&        blackboard,
+                         UniformRing&                 uniformRing,
+                         const Camera::CameraUniform& cameraUniform);
\ No newline at end of file
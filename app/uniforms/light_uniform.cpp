@@ -3,24 +3,8 @@
 
 #include "vgfw.hpp"
 
-void uploadLightUniform(FrameGraph& fg, FrameGraphBlackboard& blackboard, const DirectionalLight& light)
+void uploadLightUniform(FrameGraphBlackboard& blackboard, UniformRing& uniformRing, const DirectionalLight& light)
 {
-    blackboard.add<LightData>() = fg.addCallbackPass<LightData>(
-        "Upload LightUniform",
-        [&](FrameGraph::Builder& builder, LightData& data) {
-            data.lightUniform = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
-                "LightUniform", {.size = sizeof(DirectionalLight)});
-            data.lightUniform = builder.write(data.lightUniform);
-        },
-        [=](const LightData& data, FrameGraphPassResources& resources, void* ctx) {
-            NAMED_DEBUG_MARKER("Upload Light Uniform");
-            VGFW_PROFILE_GL("Upload Light Uniform");
-            VGFW_PROFILE_NAMED_SCOPE("Upload Light Uniform");
-
-            static_cast<vgfw::renderer::RenderContext*>(ctx)->upload(
-                vgfw::renderer::framegraph::getBuffer(resources, data.lightUniform),
-                0,
-                sizeof(DirectionalLight),
-                &light);
-        });
+    // Written into the mapped ring right away, the passes bind it by offset. It was a glBufferSubData.
+    blackboard.add<LightData>().lightUniform = uniformRing.push(light, 1);
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "light.hpp"
+#include "uniform_ring.hpp"
 
 #include <fg/Fwd.hpp>
 
-void uploadLightUniform(FrameGraph& fg, FrameGraphBlackboard& blackboard, const DirectionalLight& light);
\ No newline at end of file
+void uploadLightUniform(FrameGraphBlackboard& blackboard, UniformRing& uniformRing, const DirectionalLight& light);
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "grid3d.hpp"
+#include "lpv_config.hpp"
+
+#include <cstddef>
+
+// std140 layouts of the uniform blocks the passes push into the UniformRing, the static_asserts pin the offsets std140
+// gives to their GLSL declarations
+
+// Transform of geometry.vert (binding 3)
+struct TransformUniform
+{
+    glm::mat4 viewProjection;
+};
+
+// RadianceInjection of lib/lpv.glsl, the block of radiance_injection.vert/.geom and radiance_propagation.vert
+// (binding 0) and an element of the cascades of deferred_lighting.frag
+struct RadianceInjectionUniform
+{
+    alignas(16) glm::vec3 gridAABBMin;
+    alignas(16) glm::vec3 gridSize;
+    float   gridCellSize;
+    int32_t rsmResolution;
+    float   vplFluxScale;
+
+    static RadianceInjectionUniform make(const Grid3D& grid, int32_t rsmResolution = 0, float vplFluxScale = 0.0f)
+    {
+        return {
+            .gridAABBMin   = grid.aabb.min,
+            .gridSize      = glm::vec3 {grid.size},
+            .gridCellSize  = grid.cellSize,
+            .rsmResolution = rsmResolution,
+            .vplFluxScale  = vplFluxScale,
+        };
+    }
+};
+static_assert(offsetof(RadianceInjectionUniform, gridSize) == 16);
+static_assert(offsetof(RadianceInjectionUniform, gridCellSize) == 28);
+static_assert(offsetof(RadianceInjectionUniform, vplFluxScale) == 36);
+static_assert(sizeof(RadianceInjectionUniform) == 48); // Array stride
+
+// Settings of deferred_lighting.frag
+struct SettingsUniform
+{
+    int32_t  enableHBAO;
+    int32_t  enableSSR;
+    int32_t  enableFXAA;
+    int32_t  enableBloom;
+    uint32_t visualMode;
+};
+
+// DeferredLighting block of deferred_lighting.frag (binding 3)
+struct DeferredLightingUniform
+{
+    glm::mat4                                             lightViewProjection;
+    std::array<RadianceInjectionUniform, kMaxLPVCascades> cascades;
+    alignas(16) uint32_t numCascades;
+    alignas(16) SettingsUniform settings;
+};
+static_assert(offsetof(DeferredLightingUniform, cascades) == 64);
+static_assert(offsetof(DeferredLightingUniform, numCascades) == 64 + 48 * kMaxLPVCascades);
+static_assert(offsetof(DeferredLightingUniform, settings) == 80 + 48 * kMaxLPVCascades);
+
+// HBAO block of hbao.frag (binding 1)
+struct HBAOUniform
+{
+    float   radius;
+    float   bias;
+    float   intensity;
+    float   negInvRadius2;
+    int32_t maxRadiusPixels;
+    int32_t stepCount;
+    int32_t directionCount;
+};
+
+// SSR block of ssr.frag (binding 1)
+struct SSRUniform
+{
+    float reflectionFactor;
+};
\ No newline at end of file
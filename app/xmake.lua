@@ -1,6 +1,6 @@
 add_requires("vgfw")
 add_requires("tracy", {configs = {on_demand = true}})
-add_requires("shaderc", {configs = {binaryonly = true}}) -- use glslc binary to preprocess shaders
+add_requires("stb")
 
 -- target defination, name: lpv-app
 target("lpv-app")
@@ -17,17 +17,80 @@ target("lpv-app")
     add_rules("copy_assets", "imguiconfig", "preprocess_shaders")
 
     -- add source files
-    add_files("**.cpp")
+    add_files("**.cpp|bench/*.cpp")
     add_files("imgui.ini")
 
     -- add shaders
     add_files("shaders/**")
 
     -- add packages
-    add_packages("vgfw", "tracy", "shaderc")
+    add_packages("vgfw", "tracy", "stb")
+
+    -- add deps
+    add_deps("lpv-cpu", "lpv-sh-tables")
 
     -- add defines
     add_defines("VGFW_ENABLE_TRACY", "VGFW_ENABLE_GL_DEBUG") -- Comment this line to do the memory usage test.
 
     -- set target directory
-    set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-app")
\ No newline at end of file
+    set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-app")
+
+-- if build benchmarks, then add the radiance injection and LPV resolution benchmarks
+if has_config("bench") then
+    target("lpv-injection-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        add_includedirs(".")
+
+        -- set values
+        set_values("shader_root", "$(scriptdir)/shaders")
+
+        -- add rules
+        add_rules("preprocess_shaders")
+
+        -- add source files
+        add_files("bench/injection_bench.cpp", "passes/radiance_injection_pass.cpp", "grid3d.cpp", "program_cache.cpp",
+                  "radiance_volume.cpp", "shader_source.cpp", "uniform_ring.cpp")
+
+        -- add shaders
+        add_files("shaders/**")
+
+        -- add packages
+        add_packages("vgfw")
+
+        -- add deps
+        add_deps("lpv-sh-tables")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-injection-bench")
+
+    target("lpv-resolution-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        add_includedirs(".")
+
+        -- set values
+        set_values("shader_root", "$(scriptdir)/shaders")
+
+        -- add rules
+        add_rules("preprocess_shaders")
+
+        -- add source files
+        add_files("bench/resolution_bench.cpp", "passes/radiance_injection_pass.cpp",
+                  "passes/radiance_propagation_pass.cpp", "grid3d.cpp", "gpu_readback.cpp", "program_cache.cpp",
+                  "radiance_volume.cpp", "shader_source.cpp", "uniform_ring.cpp")
+
+        -- add shaders
+        add_files("shaders/**")
+
+        -- add packages
+        add_packages("vgfw")
+
+        -- add deps
+        add_deps("lpv-cpu", "lpv-sh-tables")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-resolution-bench")
+end
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "lpv_cpu/culling.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// Frustum culling of random boxes by the scalar, SSE and AVX2 kernels, from a scene of a few hundred primitives like
+// Sponza to a 64k one. Every kernel has to find the same visible boxes.
+namespace
+{
+    constexpr uint32_t kNumRuns     = 200;
+    constexpr uint32_t kNumFrusta   = 8;
+    constexpr float    kSceneExtent = 100.0f;
+
+    lpv_cpu::AABBSet makeBoxes(uint32_t numBoxes)
+    {
+        std::mt19937                          rng(1234);
+        std::uniform_real_distribution<float> position(0.0f, kSceneExtent);
+        std::uniform_real_distribution<float> extent(0.1f, 2.0f);
+
+        lpv_cpu::AABBSet aabbs;
+        for (uint32_t i = 0; i < numBoxes; ++i)
+        {
+            const std::array min {position(rng), position(rng), position(rng)};
+            aabbs.add(min, {min[0] + extent(rng), min[1] + extent(rng), min[2] + extent(rng)});
+        }
+        return aabbs;
+    }
+
+    // Column-major perspective(60 degrees, 16:9, 0.1, 200) * lookAt(eye, center, up = +y), like glm
+    std::array<float, 16> makeViewProjection(const std::array<float, 3>& eye, const std::array<float, 3>& center)
+    {
+        const auto normalize = [](std::array<float, 3> v) {
+            const auto length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            return std::array {v[0] / length, v[1] / length, v[2] / length};
+        };
+        const auto cross = [](const std::array<float, 3>& a, const std::array<float, 3>& b) {
+            return std::array {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        };
+        const auto dot = [](const std::array<float, 3>& a, const std::array<float, 3>& b) {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        };
+
+        const auto f = normalize({center[0] - eye[0], center[1] - eye[1], center[2] - eye[2]});
+        const auto s = normalize(cross(f, {0.0f, 1.0f, 0.0f}));
+        const auto u = cross(s, f);
+
+        // Rows of the view matrix
+        const std::array<std::array<float, 4>, 4> view {{
+            {s[0], s[1], s[2], -dot(s, eye)},
+            {u[0], u[1], u[2], -dot(u, eye)},
+            {-f[0], -f[1], -f[2], dot(f, eye)},
+            {0.0f, 0.0f, 0.0f, 1.0f},
+        }};
+
+        constexpr float kNear = 0.1f, kFar = 200.0f, kAspect = 16.0f / 9.0f;
+        const float     focal = 1.0f / std::tan(0.5f * 60.0f * 3.14159265f / 180.0f);
+
+        // Rows of the projection matrix
+        const std::array<std::array<float, 4>, 4> projection {{
+            {focal / kAspect, 0.0f, 0.0f, 0.0f},
+            {0.0f, focal, 0.0f, 0.0f},
+            {0.0f, 0.0f, -(kFar + kNear) / (kFar - kNear), -2.0f * kFar * kNear / (kFar - kNear)},
+            {0.0f, 0.0f, -1.0f, 0.0f},
+        }};
+
+        std::array<float, 16> viewProjection {};
+        for (uint32_t row = 0; row < 4; ++row)
+        {
+            for (uint32_t column = 0; column < 4; ++column)
+            {
+                for (uint32_t k = 0; k < 4; ++k)
+                    viewProjection[column * 4 + row] += projection[row][k] * view[k][column];
+            }
+        }
+        return viewProjection;
+    }
+
+    // Cameras inside of the scene looking around it
+    std::vector<lpv_cpu::Frustum> makeFrusta()
+    {
+        std::vector<lpv_cpu::Frustum> frusta;
+        for (uint32_t i = 0; i < kNumFrusta; ++i)
+        {
+            const auto angle = 2.0f * 3.14159265f * static_cast<float>(i) / kNumFrusta;
+            const auto half  = 0.5f * kSceneExtent;
+            frusta.push_back(lpv_cpu::Frustum::fromViewProjection(
+                makeViewProjection({half, half, half}, {half + std::cos(angle), half, half + std::sin(angle)})));
+        }
+        return frusta;
+    }
+
+    struct Result
+    {
+        double                             nsPerBox;
+        std::vector<std::vector<uint32_t>> visible; // Per frustum
+    };
+
+    Result run(const lpv_cpu::AABBSet& aabbs, const std::vector<lpv_cpu::Frustum>& frusta, lpv_cpu::Isa isa)
+    {
+        Result result {.nsPerBox = 0.0, .visible = std::vector<std::vector<uint32_t>>(frusta.size())};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t run = 0; run < kNumRuns; ++run)
+        {
+            for (uint32_t i = 0; i < frusta.size(); ++i)
+                lpv_cpu::cullFrustum(aabbs, frusta[i], result.visible[i], isa);
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        result.nsPerBox = std::chrono::duration<double, std::nano>(end - start).count() / kNumRuns / frusta.size() /
+                          aabbs.size();
+        return result;
+    }
+} // namespace
+
+int main()
+{
+    const auto bestIsa = lpv_cpu::detectIsa();
+    std::printf("Detected ISA: %s, %u frusta, %u runs\n", lpv_cpu::toString(bestIsa), kNumFrusta, kNumRuns);
+
+    const auto frusta  = makeFrusta();
+    bool       matches = true;
+    for (uint32_t numBoxes : {400u, 10000u, 65536u})
+    {
+        const auto aabbs  = makeBoxes(numBoxes);
+        const auto scalar = run(aabbs, frusta, lpv_cpu::Isa::eScalar);
+
+        size_t numVisible = 0;
+        for (const auto& visible : scalar.visible)
+            numVisible += visible.size();
+        std::printf("%u boxes, %.1f%% visible\n", numBoxes, 100.0 * numVisible / frusta.size() / numBoxes);
+
+        for (const auto isa : {lpv_cpu::Isa::eScalar, lpv_cpu::Isa::eSSE, lpv_cpu::Isa::eAVX2})
+        {
+            if (isa > bestIsa)
+                continue;
+
+            const auto result = isa == lpv_cpu::Isa::eScalar ? scalar : run(aabbs, frusta, isa);
+            matches           = matches && result.visible == scalar.visible;
+            std::printf("  %-6s %6.3f ns/box %8.2f us/frustum (%.1fx)%s\n",
+                        lpv_cpu::toString(isa),
+                        result.nsPerBox,
+                        result.nsPerBox * numBoxes / 1000.0,
+                        scalar.nsPerBox / result.nsPerBox,
+                        result.visible == scalar.visible ? "" : " MISMATCH");
+        }
+    }
+
+    if (!matches)
+        std::printf("The SIMD kernels do not cull the same boxes as the scalar one\n");
+
+    return matches ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "lpv_cpu/injection.hpp"
+#include "lpv_cpu/propagation.hpp"
+#include "lpv_cpu/sh_encoding.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// Bandwidth and accuracy of the SH volume encodings of the GPU passes against an fp32 propagation
+namespace
+{
+    constexpr uint32_t kNumIterations = 12;
+    constexpr uint32_t kRSMResolution = 512;
+    constexpr float    kSceneExtent   = 10.0f;
+
+    // VPLs on a lit floor and a colored wall
+    struct SyntheticRSM
+    {
+        std::vector<float> position, normal, flux;
+
+        SyntheticRSM()
+        {
+            std::mt19937                          rng(1234);
+            std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+            const auto numVPL = static_cast<size_t>(kRSMResolution) * kRSMResolution;
+            for (size_t i = 0; i < numVPL; ++i)
+            {
+                if (i % 4 != 0)
+                {
+                    position.insert(position.end(),
+                                    {kSceneExtent * (0.2f + 0.6f * distribution(rng)),
+                                     kSceneExtent * 0.05f,
+                                     kSceneExtent * (0.2f + 0.6f * distribution(rng))});
+                    normal.insert(normal.end(), {0.0f, 1.0f, 0.0f});
+                    flux.insert(flux.end(), {distribution(rng), distribution(rng), distribution(rng)});
+                }
+                else
+                {
+                    position.insert(position.end(),
+                                    {kSceneExtent * 0.9f,
+                                     kSceneExtent * (0.1f + 0.5f * distribution(rng)),
+                                     kSceneExtent * (0.2f + 0.6f * distribution(rng))});
+                    normal.insert(normal.end(), {-1.0f, 0.0f, 0.0f});
+                    flux.insert(flux.end(), {distribution(rng), 0.2f * distribution(rng), 0.1f});
+                }
+            }
+        }
+
+        lpv_cpu::RSMView getView() const { return {position.data(), normal.data(), flux.data(), kRSMResolution}; }
+    };
+
+    struct Encoding
+    {
+        const char* name;
+        uint32_t    bytesPerCell;
+        uint32_t    fetchesPerCell; // Texel fetch instructions to read a cell
+        void (*round)(lpv_cpu::SHVolume&);
+    };
+
+    const Encoding kEncodings[] = {
+        {"RGBA16F", 24, 3, [](lpv_cpu::SHVolume& volume) { volume.roundToHalf(); }},
+        {"SharedExp", 16, 1, lpv_cpu::roundToSharedExponent},
+    };
+
+    // Every volume written by the GPU passes goes through the encoding
+    lpv_cpu::SHVolume propagate(const lpv_cpu::SHVolume& injected, void (*round)(lpv_cpu::SHVolume&))
+    {
+        std::array<lpv_cpu::SHVolume, 2> volumes {injected, lpv_cpu::SHVolume(injected.getSize())};
+        if (round)
+            round(volumes[0]);
+
+        for (uint32_t i = 0; i < kNumIterations; ++i)
+        {
+            auto& out = volumes[(i + 1) % 2];
+            lpv_cpu::propagate(volumes[i % 2], out, lpv_cpu::detectIsa());
+            if (round)
+                round(out);
+        }
+
+        return volumes[kNumIterations % 2];
+    }
+
+    // Relative RMS error over every coefficient, and the largest error relative to the largest coefficient
+    std::pair<double, double> getErrors(const lpv_cpu::SHVolume& volume, const lpv_cpu::SHVolume& reference)
+    {
+        double squaredError = 0.0, squaredNorm = 0.0, maxError = 0.0, maxValue = 0.0;
+
+        const auto& size = volume.getSize();
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                const auto* values          = volume.getChannel(color, coeff);
+                const auto* referenceValues = reference.getChannel(color, coeff);
+                for (uint32_t z = 0; z < size[2]; ++z)
+                {
+                    for (uint32_t y = 0; y < size[1]; ++y)
+                    {
+                        for (uint32_t x = 0; x < size[0]; ++x)
+                        {
+                            const auto index = volume.getIndex(x, y, z);
+                            const auto error = static_cast<double>(values[index]) - referenceValues[index];
+
+                            squaredError += error * error;
+                            squaredNorm += static_cast<double>(referenceValues[index]) * referenceValues[index];
+                            maxError = std::max(maxError, std::abs(error));
+                            maxValue = std::max(maxValue, std::abs(static_cast<double>(referenceValues[index])));
+                        }
+                    }
+                }
+            }
+        }
+
+        return {squaredNorm > 0.0 ? std::sqrt(squaredError / squaredNorm) : 0.0,
+                maxValue > 0.0 ? maxError / maxValue : 0.0};
+    }
+} // namespace
+
+int main()
+{
+    SyntheticRSM rsm;
+
+    std::printf("%u iterations against fp32, traffic = every cell read and written once per iteration\n",
+                kNumIterations);
+    for (uint32_t resolution : {32u, 64u})
+    {
+        const auto grid = lpv_cpu::Grid::fromAABB({0, 0, 0}, {kSceneExtent, kSceneExtent, kSceneExtent}, resolution);
+        std::printf("%u^3\n", resolution);
+
+        lpv_cpu::SHVolume injected(grid.size);
+        lpv_cpu::inject(grid, rsm.getView(), injected);
+
+        const auto reference = propagate(injected, nullptr);
+        for (const auto& encoding : kEncodings)
+        {
+            const auto [rmsError, maxError] = getErrors(propagate(injected, encoding.round), reference);
+            const auto trafficMiB = 2.0 * grid.getNumCells() * encoding.bytesPerCell / (1024.0 * 1024.0);
+            std::printf("  %-9s %2u B/cell %u fetches/cell %7.2f MiB/iteration RMS error %.2e max error %.2e\n",
+                        encoding.name,
+                        encoding.bytesPerCell,
+                        encoding.fetchesPerCell,
+                        trafficMiB,
+                        rmsError,
+                        maxError);
+        }
+    }
+
+    return 0;
+}
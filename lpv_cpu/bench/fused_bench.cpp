@@ -0,0 +1,87 @@
+#include "lpv_cpu/propagation.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    constexpr uint32_t kNumIterations = 12; // A multiple of every K
+
+    lpv_cpu::SHVolume makeInjectedVolume(uint32_t resolution)
+    {
+        lpv_cpu::SHVolume volume({resolution, resolution, resolution});
+
+        std::mt19937                          rng(1234);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                auto* channel = volume.getChannel(color, coeff);
+                for (uint32_t z = 0; z < resolution; ++z)
+                {
+                    for (uint32_t y = 0; y < resolution; ++y)
+                    {
+                        for (uint32_t x = 0; x < resolution; ++x)
+                            channel[volume.getIndex(x, y, z)] = distribution(rng);
+                    }
+                }
+            }
+        }
+
+        return volume;
+    }
+
+    // kNumIterations propagations, K at a time, rounded to fp16 after every iteration like the GPU volumes
+    double run(const lpv_cpu::SHVolume& injected, uint32_t numFused, lpv_cpu::Isa isa)
+    {
+        std::array<lpv_cpu::SHVolume, 2> volumes {injected, lpv_cpu::SHVolume(injected.getSize())};
+        const auto                       sizeZ = injected.getSize()[2];
+
+        uint32_t   current = 0;
+        const auto start   = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kNumIterations; i += numFused, current = 1 - current)
+        {
+            if (numFused > 1)
+            {
+                lpv_cpu::propagateFused(volumes[current], volumes[1 - current], numFused, 0, sizeZ, true, isa);
+            }
+            else
+            {
+                lpv_cpu::propagate(volumes[current], volumes[1 - current], isa);
+                volumes[1 - current].roundToHalf();
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::milli>(end - start).count() / kNumIterations;
+    }
+} // namespace
+
+// Measures what fusing K iterations saves, lpv-cpu-tests checks that they match K single iterations
+int main()
+{
+    const auto bestIsa = lpv_cpu::detectIsa();
+    std::printf("Detected ISA: %s, %u iterations, %u^3 tiles\n",
+                lpv_cpu::toString(bestIsa),
+                kNumIterations,
+                lpv_cpu::kFusedTileSize);
+
+    for (uint32_t resolution : {30u, 64u}) // 30 is not a multiple of the tile size
+    {
+        std::printf("%u^3\n", resolution);
+
+        const auto injected = makeInjectedVolume(resolution);
+        const auto single   = run(injected, 1, bestIsa);
+        std::printf("  K=1 %9.3f ms/iteration\n", single);
+
+        for (uint32_t numFused = 2; numFused <= lpv_cpu::kMaxFusedIterations; ++numFused)
+        {
+            const auto fused = run(injected, numFused, bestIsa);
+            std::printf("  K=%u %9.3f ms/iteration (saves %8.3f)\n", numFused, fused, single - fused);
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "lpv_cpu/propagation.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    constexpr uint32_t kNumIterations = 16;
+
+    // Of the SIMD kernels to the scalar one, relative to the largest coefficient: only the order of the sums differs
+    constexpr float kTolerance = 1e-5f;
+
+    lpv_cpu::SHVolume makeInjectedVolume(uint32_t resolution)
+    {
+        lpv_cpu::SHVolume volume({resolution, resolution, resolution});
+
+        std::mt19937                          rng(1234);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                auto* channel = volume.getChannel(color, coeff);
+                for (uint32_t z = 0; z < resolution; ++z)
+                {
+                    for (uint32_t y = 0; y < resolution; ++y)
+                    {
+                        for (uint32_t x = 0; x < resolution; ++x)
+                            channel[volume.getIndex(x, y, z)] = distribution(rng);
+                    }
+                }
+            }
+        }
+
+        return volume;
+    }
+
+    // Returns the final volume of `kNumIterations` propagations and prints the throughput
+    lpv_cpu::SHVolume run(const lpv_cpu::SHVolume& injected, lpv_cpu::Isa isa)
+    {
+        std::array<lpv_cpu::SHVolume, 2> volumes {injected, lpv_cpu::SHVolume(injected.getSize())};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kNumIterations; ++i)
+            lpv_cpu::propagate(volumes[i % 2], volumes[(i + 1) % 2], isa);
+        const auto end = std::chrono::steady_clock::now();
+
+        const auto seconds     = std::chrono::duration<double>(end - start).count();
+        const auto cellsPerSec = static_cast<double>(injected.getNumCells()) * kNumIterations / seconds;
+        std::printf("  %-6s %8.3f ms/iteration %10.2f Mcells/s\n",
+                    lpv_cpu::toString(isa),
+                    seconds * 1000.0 / kNumIterations,
+                    cellsPerSec / 1e6);
+
+        return volumes[kNumIterations % 2];
+    }
+} // namespace
+
+int main()
+{
+    bool isMatching = true;
+
+    const auto bestIsa = lpv_cpu::detectIsa();
+    std::printf("Detected ISA: %s\n", lpv_cpu::toString(bestIsa));
+
+    for (uint32_t resolution : {32u, 64u})
+    {
+        std::printf("%u^3, %u iterations\n", resolution, kNumIterations);
+
+        const auto injected  = makeInjectedVolume(resolution);
+        const auto reference = run(injected, lpv_cpu::Isa::eScalar);
+        const auto maxValue  = reference.getMaxAbsDifference(lpv_cpu::SHVolume(reference.getSize()));
+        for (auto isa : {lpv_cpu::Isa::eSSE, lpv_cpu::Isa::eAVX2})
+        {
+            if (isa > bestIsa)
+                break;
+
+            const auto result     = run(injected, isa);
+            const auto difference = result.getMaxAbsDifference(reference);
+            const bool isWithin   = difference <= kTolerance * maxValue;
+            std::printf("  %-6s max abs difference to scalar: %g%s\n",
+                        lpv_cpu::toString(isa),
+                        difference,
+                        isWithin ? "" : " (MISMATCH)");
+            isMatching = isMatching && isWithin;
+        }
+    }
+
+    return isMatching ? 0 : 1;
+}
\ No newline at end of file
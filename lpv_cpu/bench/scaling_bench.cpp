@@ -0,0 +1,83 @@
+#include "lpv_cpu/engine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    constexpr uint32_t kNumIterations = 12;
+    constexpr uint32_t kRSMResolution = 512;
+    constexpr float    kSceneExtent   = 10.0f;
+
+    // Random VPLs over the whole grid, so that every cell carries radiance from the first iteration
+    struct SyntheticRSM
+    {
+        std::vector<float> position, normal, flux;
+
+        SyntheticRSM()
+        {
+            std::mt19937                          rng(1234);
+            std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+            const auto numValues = static_cast<size_t>(kRSMResolution) * kRSMResolution * 3;
+            for (size_t i = 0; i < numValues; ++i)
+            {
+                position.push_back(distribution(rng) * kSceneExtent);
+                normal.push_back(distribution(rng) * 2.0f - 1.0f);
+                flux.push_back(distribution(rng));
+            }
+        }
+
+        lpv_cpu::RSMView getView() const { return {position.data(), normal.data(), flux.data(), kRSMResolution}; }
+    };
+
+    double measure(lpv_cpu::Engine& engine, const lpv_cpu::RSMView& rsm)
+    {
+        engine.inject(rsm);
+
+        const auto start = std::chrono::steady_clock::now();
+        engine.propagate(kNumIterations);
+        const auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(end - start).count();
+    }
+} // namespace
+
+int main()
+{
+    const auto   maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const auto   isa        = lpv_cpu::detectIsa();
+    SyntheticRSM rsm;
+
+    std::printf("ISA: %s, up to %u threads, %u iterations\n", lpv_cpu::toString(isa), maxThreads, kNumIterations);
+
+    for (uint32_t resolution : {32u, 64u, 128u})
+    {
+        const auto grid = lpv_cpu::Grid::fromAABB({0, 0, 0}, {kSceneExtent, kSceneExtent, kSceneExtent}, resolution);
+        std::printf("%u^3\n", resolution);
+
+        double singleThreaded = 0.0;
+        for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads = std::min(numThreads * 2, maxThreads))
+        {
+            lpv_cpu::ThreadPool threadPool(numThreads);
+            lpv_cpu::Engine     engine(grid, isa);
+            engine.setThreadPool(&threadPool);
+
+            const auto seconds = measure(engine, rsm.getView());
+            if (numThreads == 1)
+                singleThreaded = seconds;
+
+            std::printf("  %3u threads %9.3f ms/iteration  speedup %5.2fx\n",
+                        numThreads,
+                        seconds * 1000.0 / kNumIterations,
+                        singleThreaded / seconds);
+
+            if (numThreads == maxThreads)
+                break;
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
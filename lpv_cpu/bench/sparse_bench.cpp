@@ -0,0 +1,99 @@
+#include "lpv_cpu/engine.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    constexpr uint32_t kNumIterations = 12;
+    constexpr uint32_t kRSMResolution = 512;
+    constexpr float    kSceneExtent   = 10.0f;
+
+    // VPLs on a small lit patch of the floor, most of the volume is empty air like in Sponza
+    struct SyntheticRSM
+    {
+        std::vector<float> position, normal, flux;
+
+        SyntheticRSM()
+        {
+            std::mt19937                          rng(1234);
+            std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+            const auto numVPL = static_cast<size_t>(kRSMResolution) * kRSMResolution;
+            for (size_t i = 0; i < numVPL; ++i)
+            {
+                position.insert(position.end(),
+                                {kSceneExtent * (0.4f + 0.2f * distribution(rng)),
+                                 kSceneExtent * 0.05f,
+                                 kSceneExtent * (0.4f + 0.2f * distribution(rng))});
+                normal.insert(normal.end(), {0.0f, 1.0f, 0.0f});
+                flux.insert(flux.end(), {distribution(rng), distribution(rng), distribution(rng)});
+            }
+        }
+
+        lpv_cpu::RSMView getView() const { return {position.data(), normal.data(), flux.data(), kRSMResolution}; }
+    };
+
+    struct Result
+    {
+        double            msPerIteration;
+        float             activeRatio;
+        size_t            memoryUsage;
+        lpv_cpu::SHVolume volume;
+    };
+
+    Result run(const lpv_cpu::Grid& grid, const lpv_cpu::RSMView& rsm, lpv_cpu::Storage storage, bool useBrickMask)
+    {
+        lpv_cpu::Engine engine(grid, lpv_cpu::detectIsa(), false, storage);
+        engine.setUseBrickMask(useBrickMask);
+        engine.inject(rsm);
+
+        const auto start = std::chrono::steady_clock::now();
+        engine.propagate(kNumIterations);
+        const auto end = std::chrono::steady_clock::now();
+
+        Result result {
+            .msPerIteration = std::chrono::duration<double, std::milli>(end - start).count() / kNumIterations,
+            .activeRatio    = useBrickMask ? engine.getBrickMask().getActiveRatio() : 1.0f,
+            .memoryUsage    = engine.getMemoryUsage(),
+            .volume         = {},
+        };
+        if (storage == lpv_cpu::Storage::eSparse)
+            engine.getSparseResult().toDense(result.volume);
+        else
+            result.volume = engine.getResult();
+
+        return result;
+    }
+
+    void print(const char* name, const Result& result, const Result& reference)
+    {
+        std::printf("  %-8s %9.3f ms/iteration (saves %8.3f) active bricks %5.1f%% memory %8.2f MiB diff %g\n",
+                    name,
+                    result.msPerIteration,
+                    reference.msPerIteration - result.msPerIteration,
+                    result.activeRatio * 100.0f,
+                    result.memoryUsage / (1024.0 * 1024.0),
+                    result.volume.getMaxAbsDifference(reference.volume));
+    }
+} // namespace
+
+int main()
+{
+    SyntheticRSM rsm;
+
+    std::printf("%u iterations, active bricks after the last one\n", kNumIterations);
+    for (uint32_t resolution : {32u, 64u, 128u})
+    {
+        const auto grid = lpv_cpu::Grid::fromAABB({0, 0, 0}, {kSceneExtent, kSceneExtent, kSceneExtent}, resolution);
+        std::printf("%u^3\n", resolution);
+
+        const auto dense = run(grid, rsm.getView(), lpv_cpu::Storage::eDense, false);
+        print("Dense", dense, dense);
+        print("Masked", run(grid, rsm.getView(), lpv_cpu::Storage::eDense, true), dense);
+        print("Sparse", run(grid, rsm.getView(), lpv_cpu::Storage::eSparse, true), dense);
+    }
+
+    return 0;
+}
\ No newline at end of file
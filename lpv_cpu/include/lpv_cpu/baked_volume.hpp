@@ -0,0 +1,84 @@
+#pragma once
+
+#include "lpv_cpu/sh_volume.hpp"
+
+#include <string>
+
+namespace lpv_cpu
+{
+    constexpr uint32_t kBakedVolumeMagic     = 0x4256504C; // "LPVB"
+    constexpr uint32_t kBakedVolumeVersion   = 2;
+    constexpr uint64_t kBakedVolumeAlignment = 4096; // Payloads start on page boundaries
+
+    enum class BakedPrecision : uint32_t
+    {
+        eHalf = 0, // RGBA16F texels, the format of the GPU volumes
+    };
+
+    // Lighting the volume was baked with, a volume of another light or scene is stale
+    struct BakedLighting
+    {
+        std::array<float, 3> lightDirection {};
+        std::array<float, 3> lightColor {};
+        float                lightIntensity {};
+        uint32_t             padding {};
+        uint64_t             sceneHash {}; // Of the static geometry, computed by the application
+
+        bool operator==(const BakedLighting&) const = default;
+    };
+    static_assert(sizeof(BakedLighting) == 40, "The baked lighting is a part of the file format");
+
+    // File header of a baked LPV, followed by one payload per color channel holding the interleaved RGBA16F texels of
+    // the SH-R/G/B volume (x being the fastest axis), so that they can be uploaded as they are mapped
+    struct BakedVolumeHeader
+    {
+        uint32_t                magic {};
+        uint32_t                version {};
+        std::array<float, 3>    aabbMin {};
+        std::array<float, 3>    aabbMax {};
+        float                   cellSize {};
+        std::array<uint32_t, 3> size {};
+        uint32_t                shOrder {}; // 1 for the L1 SH of the GPU volumes, 4 coefficients per color
+        BakedPrecision          precision {};
+        std::array<uint64_t, 3> payloadOffsets {};
+        uint64_t                payloadSize {}; // Per color channel, in bytes
+        BakedLighting           lighting {};
+    };
+    static_assert(sizeof(BakedVolumeHeader) == 128, "The baked volume header is a part of the file format");
+
+    // Writes the volume in the baked format, returns false if the file could not be written
+    bool writeBakedVolume(const std::string&   path,
+                          const Grid&          grid,
+                          const SHVolume&      volume,
+                          const BakedLighting& lighting);
+
+    // Read-only memory mapping of a baked volume file
+    class MappedBakedVolume
+    {
+    public:
+        MappedBakedVolume() = default;
+        ~MappedBakedVolume();
+
+        MappedBakedVolume(const MappedBakedVolume&)            = delete;
+        MappedBakedVolume& operator=(const MappedBakedVolume&) = delete;
+
+        // Maps the file and validates its header, returns false if it is missing or not a supported baked volume
+        bool open(const std::string& path);
+        void close();
+
+        bool isOpen() const { return m_Data != nullptr; }
+
+        const BakedVolumeHeader& getHeader() const { return *reinterpret_cast<const BakedVolumeHeader*>(m_Data); }
+        const uint16_t*          getPayload(uint32_t color) const
+        {
+            return reinterpret_cast<const uint16_t*>(m_Data + getHeader().payloadOffsets[color]);
+        }
+
+    private:
+        bool isValid() const;
+
+    private:
+        const uint8_t* m_Data {nullptr};
+        size_t         m_Size {0};
+    };
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lpv_cpu
+{
+    class SHVolume;
+    class SparseSHVolume;
+
+    // Edge of a brick in cells. A propagation iteration moves radiance by a single cell, so the radiance injected into
+    // the active bricks needs kBrickSize iterations to leave the ring around them.
+    constexpr uint32_t kBrickSize  = 4;
+    constexpr uint32_t kBrickCells = kBrickSize * kBrickSize * kBrickSize;
+
+    // Occupancy of the 4^3 bricks of a volume
+    class BrickMask
+    {
+    public:
+        BrickMask() = default;
+        explicit BrickMask(const std::array<uint32_t, 3>& volumeSize);
+
+        const std::array<uint32_t, 3>& getBrickCount() const { return m_BrickCount; }
+        size_t getNumBricks() const { return m_Active.size(); }
+        size_t getNumActive() const { return m_NumActive; }
+        float  getActiveRatio() const { return m_Active.empty() ? 0.0f : float(m_NumActive) / m_Active.size(); }
+
+        bool isActive(uint32_t bx, uint32_t by, uint32_t bz) const { return m_Active[getBrickIndex(bx, by, bz)] != 0; }
+
+        // Flags the brick of a cell, e.g. one holding geometry or a VPL
+        void markCell(uint32_t x, uint32_t y, uint32_t z);
+
+        // Flags every brick holding non-zero radiance
+        void markNonZero(const SHVolume& volume);
+
+        // Flags every allocated brick
+        void markAllocated(const SparseSHVolume& volume);
+
+        // Adds the ring of bricks around the active ones
+        void dilate();
+
+    private:
+        size_t getBrickIndex(uint32_t bx, uint32_t by, uint32_t bz) const
+        {
+            return (static_cast<size_t>(bz) * m_BrickCount[1] + by) * m_BrickCount[0] + bx;
+        }
+
+    private:
+        std::array<uint32_t, 3> m_BrickCount {};
+        std::vector<uint8_t>    m_Active;
+        size_t                  m_NumActive {0};
+    };
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "lpv_cpu/propagation.hpp"
+
+#include <vector>
+
+namespace lpv_cpu
+{
+    // Planes (a, b, c, d) of a view frustum, a point p is inside of a plane when a*p.x + b*p.y + c*p.z + d >= 0
+    struct Frustum
+    {
+        std::array<std::array<float, 4>, 6> planes;
+
+        // Gribb/Hartmann extraction from a column-major view-projection matrix (glm layout). The near plane is the one
+        // of a [-1, 1] clip depth, which also bounds a [0, 1] one.
+        static Frustum fromViewProjection(const std::array<float, 16>& viewProjection);
+    };
+
+    // Axis-aligned boxes stored as a structure of arrays, padded with empty boxes to a multiple of kAABBSetWidth so the
+    // kernels never need a scalar remainder
+    class AABBSet
+    {
+    public:
+        static constexpr uint32_t kAABBSetWidth = 8;
+
+        void add(const std::array<float, 3>& min, const std::array<float, 3>& max);
+        void clear();
+
+        uint32_t size() const { return m_Size; }
+
+        // Axis 0, 1 or 2 of the box corners, getPaddedSize() floats each
+        const float* getMin(uint32_t axis) const { return m_Min[axis].data(); }
+        const float* getMax(uint32_t axis) const { return m_Max[axis].data(); }
+        uint32_t     getPaddedSize() const { return static_cast<uint32_t>(m_Min[0].size()); }
+
+    private:
+        std::array<std::vector<float>, 3> m_Min;
+        std::array<std::vector<float>, 3> m_Max;
+        uint32_t                          m_Size {0};
+    };
+
+    // Indices of the boxes inside of or intersecting the frustum, in ascending order. A box is culled when its corner
+    // furthest along the normal of a plane is behind it, which keeps some boxes near the frustum corners.
+    void cullFrustum(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible, Isa isa);
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "lpv_cpu/injection.hpp"
+#include "lpv_cpu/propagation.hpp"
+#include "lpv_cpu/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace lpv_cpu
+{
+    enum class Storage
+    {
+        eDense = 0,
+        eSparse, // Only the active bricks are allocated, implies the brick mask
+    };
+
+    // CPU reference of the LPV passes: injection followed by N propagation iterations, ping-ponging between two
+    // volumes. With `emulateHalf` every stage is rounded to fp16 like the RGBA16F GPU volumes (dense storage only).
+    // Given a thread pool, every iteration is split into z-slab tasks, the end of the job being its only barrier.
+    // With the brick mask only the bricks holding injected radiance and the rings radiance has reached since are
+    // propagated.
+    class Engine
+    {
+    public:
+        explicit Engine(const Grid& grid,
+                        Isa         isa         = detectIsa(),
+                        bool        emulateHalf = true,
+                        Storage     storage     = Storage::eDense);
+
+        void setThreadPool(ThreadPool* threadPool) { m_ThreadPool = threadPool; }
+        void setUseBrickMask(bool useBrickMask) { m_UseBrickMask = useBrickMask || m_Storage == Storage::eSparse; }
+
+        // Dense volumes without brick mask can propagate several iterations per pass (propagateFused), to reproduce
+        // radiance_propagation_fused.comp when validating it. It is slower than single iterations on the CPU, where
+        // the volumes stay in cache and the recomputed halo is not paid back, hence the default of 1.
+        void setFusedIterations(uint32_t fusedIterations)
+        {
+            m_FusedIterations = std::clamp(fusedIterations, 1u, kMaxFusedIterations);
+        }
+
+        void inject(const RSMView& rsm);
+        void propagate(uint32_t numIterations);
+
+        const Grid&      getGrid() const { return m_Grid; }
+        Isa              getIsa() const { return m_Isa; }
+        Storage          getStorage() const { return m_Storage; }
+        const BrickMask& getBrickMask() const { return m_BrickMask; }
+        size_t           getMemoryUsage() const;
+
+        const SHVolume&       getResult() const { return m_Volumes[m_Current]; }
+        const SparseSHVolume& getSparseResult() const { return m_SparseVolumes[m_Current]; }
+
+    private:
+        Grid                          m_Grid;
+        Isa                           m_Isa;
+        bool                          m_EmulateHalf;
+        Storage                       m_Storage;
+        std::array<SHVolume, 2>       m_Volumes;
+        std::array<SparseSHVolume, 2> m_SparseVolumes;
+        uint32_t                      m_Current {0};
+        ThreadPool*                   m_ThreadPool {nullptr};
+        uint32_t                      m_FusedIterations {1};
+
+        bool      m_UseBrickMask;
+        BrickMask m_BrickMask;
+        uint32_t  m_Iteration {0}; // Since the injection
+    };
+} // namespace lpv_cpu
\ No newline at end of file
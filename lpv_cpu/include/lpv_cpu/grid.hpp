@@ -0,0 +1,21 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace lpv_cpu
+{
+    // Mirrors Grid3D of the application without depending on vgfw/glm
+    struct Grid
+    {
+        std::array<float, 3>    aabbMin {};
+        std::array<uint32_t, 3> size {};
+        float                   cellSize {0.0f};
+
+        // Same fitting as Grid3D: `resolution` cells along the longest axis of the AABB
+        static Grid fromAABB(const std::array<float, 3>& min, const std::array<float, 3>& max, uint32_t resolution);
+
+        size_t getNumCells() const { return static_cast<size_t>(size[0]) * size[1] * size[2]; }
+    };
+} // namespace lpv_cpu
\ No newline at end of file
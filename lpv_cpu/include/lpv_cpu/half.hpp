@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lpv_cpu
+{
+    // IEEE 754 binary16 conversions, rounding to nearest even like GL does for RGBA16F targets
+    uint16_t floatToHalf(float value);
+    float    halfToFloat(uint16_t value);
+
+    inline float roundToHalf(float value) { return halfToFloat(floatToHalf(value)); }
+} // namespace lpv_cpu
\ No newline at end of file
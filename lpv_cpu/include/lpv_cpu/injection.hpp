@@ -0,0 +1,21 @@
+#pragma once
+
+#include "lpv_cpu/sh_volume.hpp"
+#include "lpv_cpu/sparse_sh_volume.hpp"
+
+namespace lpv_cpu
+{
+    // Read-only view of the RSM render targets, three floats per texel
+    struct RSMView
+    {
+        const float* position {nullptr};
+        const float* normal {nullptr};
+        const float* flux {nullptr};
+        uint32_t     resolution {0};
+    };
+
+    // radiance_injection.{vert,geom,frag}: every RSM texel is a VPL accumulated into the cell it points into, the
+    // sparse overload allocates the bricks VPLs fall into
+    void inject(const Grid& grid, const RSMView& rsm, SHVolume& volume);
+    void inject(const Grid& grid, const RSMView& rsm, SparseSHVolume& volume);
+} // namespace lpv_cpu
\ No newline at end of file
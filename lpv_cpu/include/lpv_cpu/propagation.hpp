@@ -0,0 +1,52 @@
+#pragma once
+
+#include "lpv_cpu/brick_mask.hpp"
+#include "lpv_cpu/sh_volume.hpp"
+#include "lpv_cpu/sparse_sh_volume.hpp"
+
+namespace lpv_cpu
+{
+    enum class Isa
+    {
+        eScalar = 0,
+        eSSE,
+        eAVX2,
+    };
+
+    const char* toString(Isa);
+
+    // Best instruction set supported by both the build and the running CPU
+    Isa detectIsa();
+
+    // One iteration of radiance_propagation.frag over the z-slices [zBegin, zEnd) of the output
+    void propagate(const SHVolume& in, SHVolume& out, uint32_t zBegin, uint32_t zEnd, Isa isa);
+    void propagate(const SHVolume& in, SHVolume& out, Isa isa);
+
+    // Same over the active bricks only, the cells of the other bricks are left untouched
+    void propagate(const SHVolume& in, SHVolume& out, const BrickMask& mask, uint32_t zBegin, uint32_t zEnd, Isa isa);
+
+    constexpr uint32_t kFusedTileSize      = 16; // Output cells along a tile edge of the fused propagation
+    constexpr uint32_t kMaxFusedIterations = 4;
+
+    // K iterations over the z-slices [zBegin, zEnd) of the output at once (temporal blocking): every tile is copied
+    // with a halo of K cells, propagated K times in the copy and written back, so `in` is read and `out` written once
+    // per K iterations, like radiance_propagation_fused.comp. With `emulateHalf` every iteration is rounded to fp16.
+    template<uint32_t K>
+    void propagateFused(const SHVolume& in, SHVolume& out, uint32_t zBegin, uint32_t zEnd, bool emulateHalf, Isa isa);
+
+    // Same with K = numIterations, in [1, kMaxFusedIterations]
+    void propagateFused(const SHVolume& in,
+                        SHVolume&       out,
+                        uint32_t        numIterations,
+                        uint32_t        zBegin,
+                        uint32_t        zEnd,
+                        bool            emulateHalf,
+                        Isa             isa);
+
+    // Scalar propagation of sparse volumes over the active bricks, which have to be allocated in `out`
+    void propagate(const SparseSHVolume& in,
+                   SparseSHVolume&       out,
+                   const BrickMask&      mask,
+                   uint32_t              zBegin,
+                   uint32_t              zEnd);
+} // namespace lpv_cpu
\ No newline at end of file
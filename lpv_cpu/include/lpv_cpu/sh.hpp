@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace lpv_cpu
+{
+    // kPI is PI of shaders/lib/math.glsl, the SH constants are written to lib/sh_tables.glsl for shaders/lib/lpv.glsl
+    constexpr float kPI           = 3.1415926535f;
+    constexpr float kSH_C0        = 0.282094791f;
+    constexpr float kSH_C1        = 0.488602512f;
+    constexpr float kSH_cosLobeC0 = 0.886226925f;
+    constexpr float kSH_cosLobeC1 = 1.02332671f;
+
+    // Coefficients of the bands below Order, the LPV stores the L0 and L1 bands (Order 2)
+    template<uint32_t Order>
+    using SHBasis = std::array<float, Order * Order>;
+
+    using SHCoeffs = SHBasis<2>;
+
+    namespace detail
+    {
+        // std::sqrt is not constexpr, Newton's iterations are used at compile time
+        constexpr double sqrt(double x)
+        {
+            if (!std::is_constant_evaluated())
+                return std::sqrt(x);
+            if (x <= 0.0)
+                return 0.0;
+
+            double root = x > 1.0 ? x : 1.0;
+            for (int i = 0; i < 64; ++i)
+                root = 0.5 * (root + x / root);
+            return root;
+        }
+
+        template<uint32_t Order>
+        constexpr SHBasis<Order> evaluateSH(float c0, float c1, float x, float y, float z)
+        {
+            static_assert(Order == 1 || Order == 2, "only the L0 and L1 bands are implemented");
+
+            if constexpr (Order == 1)
+            {
+                return {c0};
+            }
+            else
+            {
+                // Normalized like SH_Evaluate and SH_EvaluateCosineLobe
+                const auto length = static_cast<float>(sqrt(static_cast<double>(x) * x + static_cast<double>(y) * y +
+                                                            static_cast<double>(z) * z));
+                return {c0, -c1 * (y / length), c1 * (z / length), -c1 * (x / length)};
+            }
+        }
+    } // namespace detail
+
+    // SH_Evaluate of lib/lpv.glsl
+    template<uint32_t Order = 2>
+    constexpr SHBasis<Order> evaluateSH(float x, float y, float z)
+    {
+        return detail::evaluateSH<Order>(kSH_C0, kSH_C1, x, y, z);
+    }
+
+    // SH_EvaluateCosineLobe of lib/lpv.glsl
+    template<uint32_t Order = 2>
+    constexpr SHBasis<Order> evaluateSHCosineLobe(float x, float y, float z)
+    {
+        return detail::evaluateSH<Order>(kSH_cosLobeC0, kSH_cosLobeC1, x, y, z);
+    }
+
+    // A face of a neighbour radiance flows through towards the propagated cell: the neighbour's radiance is projected
+    // onto the evaluation direction and reprojected as a cosine lobe along the reprojection direction
+    template<uint32_t Order>
+    struct PropagationFace
+    {
+        float          solidAngle;
+        SHBasis<Order> projection;   // evaluateSH of the evaluation direction
+        SHBasis<Order> reprojection; // evaluateSHCosineLobe of the reprojection direction
+    };
+
+    constexpr uint32_t kNumPropagationFaces = 5; // The main face, then the 4 side faces
+
+    // Propagation from one of the 6 neighbours (Z+, Z-, X+, X-, Y+, Y-). It is linear in the neighbour's
+    // coefficients, so every face folds into a matrix: out[k] += sum_j weights[k][j] * neighbour[j]
+    template<uint32_t Order>
+    struct BasicNeighbourPropagation
+    {
+        std::array<int32_t, 3>                                      offset; // Relative to the propagated cell
+        std::array<PropagationFace<Order>, kNumPropagationFaces>    faces;
+        std::array<std::array<float, Order * Order>, Order * Order> weights;
+    };
+
+    using NeighbourPropagation = BasicNeighbourPropagation<2>;
+
+    template<uint32_t Order>
+    constexpr std::array<BasicNeighbourPropagation<Order>, 6> buildNeighbourPropagations()
+    {
+        using Vec3 = std::array<float, 3>;
+        using Mat3 = std::array<Vec3, 3>; // Columns, like GLSL
+
+        // kNeighbourOrientations and kCellSides of the original radiance_propagation.frag
+        constexpr std::array<Mat3, 6> kNeighbourOrientations {{
+            {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}},
+            {{{-1, 0, 0}, {0, 1, 0}, {0, 0, -1}}},
+            {{{0, 0, 1}, {0, 1, 0}, {-1, 0, 0}}},
+            {{{0, 0, -1}, {0, 1, 0}, {1, 0, 0}}},
+            {{{1, 0, 0}, {0, 0, 1}, {0, -1, 0}}},
+            {{{1, 0, 0}, {0, 0, -1}, {0, 1, 0}}},
+        }};
+
+        constexpr std::array<std::array<float, 2>, 4> kCellSides {{{1, 0}, {0, 1}, {-1, 0}, {0, -1}}};
+
+        constexpr float kSolidAngle                  = 0.4006696846f / kPI;
+        constexpr float kSideFaceSubtendedSolidAngle = 0.4234413544f / kPI;
+
+        constexpr auto multiply = [](const Mat3& m, const Vec3& v) {
+            Vec3 result {};
+            for (uint32_t column = 0; column < 3; ++column)
+            {
+                for (uint32_t row = 0; row < 3; ++row)
+                    result[row] += m[column][row] * v[column];
+            }
+            return result;
+        };
+
+        constexpr auto makeFace = [](float solidAngle, const Vec3& evaluation, const Vec3& reprojection) {
+            return PropagationFace<Order> {
+                .solidAngle   = solidAngle,
+                .projection   = evaluateSH<Order>(evaluation[0], evaluation[1], evaluation[2]),
+                .reprojection = evaluateSHCosineLobe<Order>(reprojection[0], reprojection[1], reprojection[2]),
+            };
+        };
+
+        std::array<BasicNeighbourPropagation<Order>, 6> neighbours {};
+        for (uint32_t n = 0; n < 6; ++n)
+        {
+            const auto& orientation   = kNeighbourOrientations[n];
+            const auto  mainDirection = multiply(orientation, {0.0f, 0.0f, 1.0f});
+
+            auto& neighbour = neighbours[n];
+            for (uint32_t i = 0; i < 3; ++i)
+                neighbour.offset[i] = -static_cast<int32_t>(mainDirection[i]);
+
+            neighbour.faces[0] = makeFace(kSolidAngle, mainDirection, mainDirection);
+            for (uint32_t side = 0; side < kCellSides.size(); ++side)
+            {
+                const auto& [sx, sy]       = kCellSides[side];
+                const auto  evaluation     = multiply(orientation, {sx * 0.4472135f, sy * 0.4472135f, 0.894427f});
+                const auto  reprojection   = multiply(orientation, {sx, sy, 0.0f});
+                neighbour.faces[1 + side]  = makeFace(kSideFaceSubtendedSolidAngle, evaluation, reprojection);
+            }
+
+            for (const auto& face : neighbour.faces)
+            {
+                for (uint32_t k = 0; k < Order * Order; ++k)
+                {
+                    for (uint32_t j = 0; j < Order * Order; ++j)
+                        neighbour.weights[k][j] += face.solidAngle * face.projection[j] * face.reprojection[k];
+                }
+            }
+        }
+        return neighbours;
+    }
+
+    inline constexpr auto kNeighbourPropagations = buildNeighbourPropagations<2>();
+
+    constexpr const std::array<NeighbourPropagation, 6>& getNeighbourPropagations() { return kNeighbourPropagations; }
+
+    // GLSL declarations of the SH constants and kNeighbourPropagations, written to lib/sh_tables.glsl by lpv-sh-tables
+    // at build time so that the shaders and the CPU path inject and propagate with the same numbers
+    std::string generatePropagationTablesGLSL();
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "lpv_cpu/sh_volume.hpp"
+
+namespace lpv_cpu
+{
+    // SH coefficients of a cell, [color][coeff]
+    using SHCell = std::array<std::array<float, kNumSHCoeffs>, kNumColorChannels>;
+
+    // SH_ENCODING_SHARED_EXPONENT of the GPU volumes (lib/sh_volume.glsl), 16 bytes per cell: the 12 coefficients as
+    // 10-bit signed mantissas, 3 per word, and an 8-bit exponent shared by the whole cell in the top 2 bits of every
+    // word. Propagated cells can have negative DC terms, hence signed mantissas rather than RGB9E5.
+    using PackedSHCell = std::array<uint32_t, 4>;
+
+    PackedSHCell encodeSharedExponent(const SHCell& cell);
+    SHCell       decodeSharedExponent(const PackedSHCell& packed);
+
+    // Emulates the shared exponent storage of the GPU volumes, like SHVolume::roundToHalf does for RGBA16F
+    void roundToSharedExponent(SHVolume& volume);
+} // namespace lpv_cpu
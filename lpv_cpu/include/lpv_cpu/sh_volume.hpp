@@ -0,0 +1,62 @@
+#pragma once
+
+#include "lpv_cpu/grid.hpp"
+
+#include <vector>
+
+namespace lpv_cpu
+{
+    constexpr uint32_t kNumColorChannels = 3; // R, G, B
+    constexpr uint32_t kNumSHCoeffs      = 4; // L1
+
+    // SH-R/G/B volumes in structure-of-arrays layout: one array per (color, coefficient) pair, x being the fastest
+    // axis. Every array carries a ghost border of one zeroed cell on each side, so that the propagation kernels read
+    // their neighbours without any bounds check.
+    class SHVolume
+    {
+    public:
+        SHVolume() = default;
+        explicit SHVolume(const std::array<uint32_t, 3>& size);
+
+        const std::array<uint32_t, 3>& getSize() const { return m_Size; }
+        const std::array<uint32_t, 3>& getPaddedSize() const { return m_PaddedSize; }
+        size_t                         getNumCells() const { return m_Size[0] * m_Size[1] * m_Size[2]; }
+
+        // Index of a cell in the padded arrays
+        size_t getIndex(uint32_t x, uint32_t y, uint32_t z) const
+        {
+            return ((static_cast<size_t>(z) + 1) * m_PaddedSize[1] + (y + 1)) * m_PaddedSize[0] + (x + 1);
+        }
+
+        float* getChannel(uint32_t color, uint32_t coeff) { return m_Data.data() + getChannelOffset(color, coeff); }
+        const float* getChannel(uint32_t color, uint32_t coeff) const
+        {
+            return m_Data.data() + getChannelOffset(color, coeff);
+        }
+
+        void clear();
+
+        // Emulates the RGBA16F storage of the GPU volumes, over the whole volume or the z-slices [zBegin, zEnd)
+        void roundToHalf();
+        void roundToHalf(uint32_t zBegin, uint32_t zEnd);
+
+        // Interleaved RGBA16F texels of a color channel, in the layout glGetTextureImage returns for the GPU volumes
+        void exportHalf(uint32_t color, uint16_t* texels) const;
+        void importHalf(uint32_t color, const uint16_t* texels);
+
+        // Largest absolute difference over every coefficient of the two volumes
+        float getMaxAbsDifference(const SHVolume& other) const;
+
+    private:
+        size_t getChannelOffset(uint32_t color, uint32_t coeff) const
+        {
+            return (color * kNumSHCoeffs + coeff) * m_PaddedCells;
+        }
+
+    private:
+        std::array<uint32_t, 3> m_Size {};
+        std::array<uint32_t, 3> m_PaddedSize {};
+        size_t                  m_PaddedCells {0};
+        std::vector<float>      m_Data;
+    };
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "lpv_cpu/brick_mask.hpp"
+#include "lpv_cpu/sh_volume.hpp"
+
+namespace lpv_cpu
+{
+    // SH volume storing only its allocated 4^3 bricks, for grids whose dense volumes do not fit in memory. A brick
+    // holds the kBrickCells values of every (color, coefficient) pair contiguously, x being the fastest axis; cells
+    // of unallocated bricks hold no radiance.
+    class SparseSHVolume
+    {
+    public:
+        static constexpr size_t kBrickFloats = kBrickCells * kNumColorChannels * kNumSHCoeffs;
+
+        SparseSHVolume() = default;
+        explicit SparseSHVolume(const std::array<uint32_t, 3>& size);
+
+        const std::array<uint32_t, 3>& getSize() const { return m_Size; }
+        const std::array<uint32_t, 3>& getBrickCount() const { return m_BrickCount; }
+
+        size_t getNumAllocated() const { return m_Pool.size() / kBrickFloats; }
+        size_t getMemoryUsage() const { return m_Pool.size() * sizeof(float) + m_Slots.size() * sizeof(int32_t); }
+
+        // Allocates a zeroed brick if needed, invalidates the pointers returned by getBrick()
+        float* allocate(uint32_t bx, uint32_t by, uint32_t bz);
+        void   allocate(const BrickMask& mask);
+
+        // nullptr for unallocated bricks
+        float*       getBrick(uint32_t bx, uint32_t by, uint32_t bz);
+        const float* getBrick(uint32_t bx, uint32_t by, uint32_t bz) const;
+
+        static size_t getCellIndex(uint32_t x, uint32_t y, uint32_t z)
+        {
+            return ((z % kBrickSize) * kBrickSize + y % kBrickSize) * kBrickSize + x % kBrickSize;
+        }
+        static size_t getChannelOffset(uint32_t color, uint32_t coeff)
+        {
+            return (color * kNumSHCoeffs + coeff) * kBrickCells;
+        }
+
+        // Releases every brick
+        void clear();
+
+        void toDense(SHVolume& volume) const;
+
+    private:
+        size_t getBrickIndex(uint32_t bx, uint32_t by, uint32_t bz) const
+        {
+            return (static_cast<size_t>(bz) * m_BrickCount[1] + by) * m_BrickCount[0] + bx;
+        }
+
+    private:
+        std::array<uint32_t, 3> m_Size {};
+        std::array<uint32_t, 3> m_BrickCount {};
+        std::vector<int32_t>    m_Slots; // Brick -> index in the pool, -1 when unallocated
+        std::vector<float>      m_Pool;
+    };
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lpv_cpu
+{
+    // Work-stealing pool running index-based jobs. Every thread owns a queue seeded with a contiguous block of
+    // the job, pops from its back and steals from the front of the others once it runs dry, so neighbouring tasks
+    // (e.g. z-slabs) tend to stay on the same core.
+    class ThreadPool
+    {
+    public:
+        // `numThreads` counts the calling thread, which takes part in every job
+        explicit ThreadPool(uint32_t numThreads = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        uint32_t getNumThreads() const { return static_cast<uint32_t>(m_Queues.size()); }
+
+        // Runs task(i) for every i in [0, numTasks) and returns once all of them are done
+        void parallelFor(uint32_t numTasks, const std::function<void(uint32_t)>& task);
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex           mutex;
+            std::deque<uint32_t> tasks;
+        };
+
+        void workerLoop(uint32_t queueIndex);
+
+        // Pops a task of the own queue or steals one, returns false once every queue is empty
+        bool runTask(uint32_t queueIndex);
+
+    private:
+        std::vector<std::unique_ptr<WorkQueue>> m_Queues; // Queue 0 belongs to the calling thread
+        std::vector<std::thread>                m_Workers;
+
+        std::mutex              m_Mutex;
+        std::condition_variable m_WakeUp;
+        std::condition_variable m_Done;
+        uint64_t                m_Generation {0};
+        bool                    m_Stop {false};
+
+        const std::function<void(uint32_t)>* m_Task {nullptr};
+        std::atomic<uint32_t>                m_NumRemaining {0};
+    };
+} // namespace lpv_cpu
\ No newline at end of file
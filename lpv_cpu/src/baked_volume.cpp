@@ -0,0 +1,155 @@
+#include "lpv_cpu/baked_volume.hpp"
+
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lpv_cpu
+{
+    namespace
+    {
+        uint64_t alignUp(uint64_t value)
+        {
+            return (value + kBakedVolumeAlignment - 1) / kBakedVolumeAlignment * kBakedVolumeAlignment;
+        }
+    } // namespace
+
+    bool writeBakedVolume(const std::string&   path,
+                          const Grid&          grid,
+                          const SHVolume&      volume,
+                          const BakedLighting& lighting)
+    {
+        BakedVolumeHeader header {
+            .magic     = kBakedVolumeMagic,
+            .version   = kBakedVolumeVersion,
+            .aabbMin   = grid.aabbMin,
+            .cellSize  = grid.cellSize,
+            .size      = grid.size,
+            .shOrder   = 1,
+            .precision = BakedPrecision::eHalf,
+            .lighting  = lighting,
+        };
+        for (uint32_t i = 0; i < 3; ++i)
+            header.aabbMax[i] = grid.aabbMin[i] + grid.size[i] * grid.cellSize;
+
+        header.payloadSize = grid.getNumCells() * kNumSHCoeffs * sizeof(uint16_t);
+        for (uint32_t color = 0; color < kNumColorChannels; ++color)
+        {
+            header.payloadOffsets[color] =
+                color == 0 ? alignUp(sizeof(header)) : alignUp(header.payloadOffsets[color - 1] + header.payloadSize);
+        }
+
+        std::ofstream file {path, std::ios::binary | std::ios::trunc};
+        if (!file)
+            return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<uint16_t> texels(grid.getNumCells() * kNumSHCoeffs);
+        for (uint32_t color = 0; color < kNumColorChannels; ++color)
+        {
+            volume.exportHalf(color, texels.data());
+
+            file.seekp(static_cast<std::streamoff>(header.payloadOffsets[color]));
+            file.write(reinterpret_cast<const char*>(texels.data()), static_cast<std::streamsize>(header.payloadSize));
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    MappedBakedVolume::~MappedBakedVolume() { close(); }
+
+    bool MappedBakedVolume::open(const std::string& path)
+    {
+        close();
+
+#ifdef _WIN32
+        const auto file = CreateFileA(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            // The view keeps the mapping alive once both handles are closed
+            if (const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+            {
+                m_Data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                m_Size = static_cast<size_t>(fileSize.QuadPart);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        const auto file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return false;
+
+        struct stat fileStat;
+        if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            auto* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                m_Data = static_cast<const uint8_t*>(data);
+                m_Size = static_cast<size_t>(fileStat.st_size);
+            }
+        }
+        ::close(file);
+#endif
+
+        if (m_Data && !isValid())
+            close();
+
+        return isOpen();
+    }
+
+    void MappedBakedVolume::close()
+    {
+        if (!m_Data)
+            return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_Data);
+#else
+        munmap(const_cast<uint8_t*>(m_Data), m_Size);
+#endif
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+    bool MappedBakedVolume::isValid() const
+    {
+        if (m_Size < sizeof(BakedVolumeHeader))
+            return false;
+
+        const auto& header = getHeader();
+        if (header.magic != kBakedVolumeMagic || header.version != kBakedVolumeVersion || header.shOrder != 1 ||
+            header.precision != BakedPrecision::eHalf)
+            return false;
+
+        const auto numCells = static_cast<uint64_t>(header.size[0]) * header.size[1] * header.size[2];
+        if (numCells == 0 || header.payloadSize != numCells * kNumSHCoeffs * sizeof(uint16_t))
+            return false;
+
+        for (const auto offset : header.payloadOffsets)
+        {
+            if (offset % kBakedVolumeAlignment != 0 || offset + header.payloadSize > m_Size)
+                return false;
+        }
+
+        return true;
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "lpv_cpu/brick_mask.hpp"
+#include "lpv_cpu/sh_volume.hpp"
+#include "lpv_cpu/sparse_sh_volume.hpp"
+
+#include <algorithm>
+
+namespace lpv_cpu
+{
+    BrickMask::BrickMask(const std::array<uint32_t, 3>& volumeSize) :
+        m_BrickCount {(volumeSize[0] + kBrickSize - 1) / kBrickSize,
+                      (volumeSize[1] + kBrickSize - 1) / kBrickSize,
+                      (volumeSize[2] + kBrickSize - 1) / kBrickSize},
+        m_Active(static_cast<size_t>(m_BrickCount[0]) * m_BrickCount[1] * m_BrickCount[2], 0)
+    {}
+
+    void BrickMask::markCell(uint32_t x, uint32_t y, uint32_t z)
+    {
+        auto& active = m_Active[getBrickIndex(x / kBrickSize, y / kBrickSize, z / kBrickSize)];
+        m_NumActive += active == 0;
+        active = 1;
+    }
+
+    void BrickMask::markNonZero(const SHVolume& volume)
+    {
+        const auto& size = volume.getSize();
+        for (uint32_t z = 0; z < size[2]; ++z)
+        {
+            for (uint32_t y = 0; y < size[1]; ++y)
+            {
+                for (uint32_t x = 0; x < size[0]; ++x)
+                {
+                    const auto index = volume.getIndex(x, y, z);
+
+                    bool isNonZero = false;
+                    for (uint32_t color = 0; color < kNumColorChannels && !isNonZero; ++color)
+                    {
+                        for (uint32_t coeff = 0; coeff < kNumSHCoeffs && !isNonZero; ++coeff)
+                            isNonZero = volume.getChannel(color, coeff)[index] != 0.0f;
+                    }
+
+                    if (isNonZero)
+                        markCell(x, y, z);
+                }
+            }
+        }
+    }
+
+    void BrickMask::markAllocated(const SparseSHVolume& volume)
+    {
+        for (uint32_t bz = 0; bz < m_BrickCount[2]; ++bz)
+        {
+            for (uint32_t by = 0; by < m_BrickCount[1]; ++by)
+            {
+                for (uint32_t bx = 0; bx < m_BrickCount[0]; ++bx)
+                {
+                    if (volume.getBrick(bx, by, bz))
+                        markCell(bx * kBrickSize, by * kBrickSize, bz * kBrickSize);
+                }
+            }
+        }
+    }
+
+    void BrickMask::dilate()
+    {
+        // Neighbouring bricks [first, last] along an axis
+        const auto getRange = [this](uint32_t brick, uint32_t axis) {
+            return std::array<uint32_t, 2> {brick > 0 ? brick - 1 : 0, std::min(brick + 1, m_BrickCount[axis] - 1)};
+        };
+
+        const auto active = m_Active;
+        for (uint32_t bz = 0; bz < m_BrickCount[2]; ++bz)
+        {
+            for (uint32_t by = 0; by < m_BrickCount[1]; ++by)
+            {
+                for (uint32_t bx = 0; bx < m_BrickCount[0]; ++bx)
+                {
+                    auto& isActive = m_Active[getBrickIndex(bx, by, bz)];
+
+                    const auto rangeX = getRange(bx, 0);
+                    const auto rangeY = getRange(by, 1);
+                    const auto rangeZ = getRange(bz, 2);
+                    for (auto z = rangeZ[0]; z <= rangeZ[1] && !isActive; ++z)
+                    {
+                        for (auto y = rangeY[0]; y <= rangeY[1] && !isActive; ++y)
+                        {
+                            for (auto x = rangeX[0]; x <= rangeX[1] && !isActive; ++x)
+                            {
+                                isActive = active[getBrickIndex(x, y, z)];
+                                m_NumActive += isActive;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "lpv_cpu/culling.hpp"
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LPV_CPU_X86
+#endif
+
+namespace lpv_cpu
+{
+    namespace detail
+    {
+        void cullFrustumScalar(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible)
+        {
+            for (uint32_t i = 0; i < aabbs.size(); ++i)
+            {
+                bool isOutside = false;
+                for (const auto& plane : frustum.planes)
+                {
+                    // Corner of the box furthest along the plane normal
+                    const auto x = plane[0] >= 0.0f ? aabbs.getMax(0)[i] : aabbs.getMin(0)[i];
+                    const auto y = plane[1] >= 0.0f ? aabbs.getMax(1)[i] : aabbs.getMin(1)[i];
+                    const auto z = plane[2] >= 0.0f ? aabbs.getMax(2)[i] : aabbs.getMin(2)[i];
+
+                    // Same evaluation order as the SIMD kernels, they have to cull the same boxes
+                    isOutside = isOutside || plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f;
+                }
+                if (!isOutside)
+                    visible.push_back(i);
+            }
+        }
+
+#ifndef LPV_CPU_X86
+        void cullFrustumSSE(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible)
+        {
+            cullFrustumScalar(aabbs, frustum, visible);
+        }
+
+        void cullFrustumAVX2(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible)
+        {
+            cullFrustumScalar(aabbs, frustum, visible);
+        }
+#endif
+    } // namespace detail
+
+    Frustum Frustum::fromViewProjection(const std::array<float, 16>& viewProjection)
+    {
+        // Row 3 of the matrix plus or minus row 0 (left, right), 1 (bottom, top) and 2 (near, far)
+        Frustum frustum {};
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const auto w                    = viewProjection[i * 4 + 3];
+                const auto v                    = viewProjection[i * 4 + axis];
+                frustum.planes[axis * 2][i]     = w + v;
+                frustum.planes[axis * 2 + 1][i] = w - v;
+            }
+        }
+        return frustum;
+    }
+
+    void AABBSet::add(const std::array<float, 3>& min, const std::array<float, 3>& max)
+    {
+        if (m_Size == getPaddedSize())
+        {
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                m_Min[axis].resize(m_Size + kAABBSetWidth, 0.0f);
+                m_Max[axis].resize(m_Size + kAABBSetWidth, 0.0f);
+            }
+        }
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            m_Min[axis][m_Size] = min[axis];
+            m_Max[axis][m_Size] = max[axis];
+        }
+        ++m_Size;
+    }
+
+    void AABBSet::clear()
+    {
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            m_Min[axis].clear();
+            m_Max[axis].clear();
+        }
+        m_Size = 0;
+    }
+
+    void cullFrustum(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible, Isa isa)
+    {
+        visible.clear();
+        switch (isa)
+        {
+            case Isa::eScalar:
+                detail::cullFrustumScalar(aabbs, frustum, visible);
+                break;
+            case Isa::eSSE:
+                detail::cullFrustumSSE(aabbs, frustum, visible);
+                break;
+            case Isa::eAVX2:
+                detail::cullFrustumAVX2(aabbs, frustum, visible);
+                break;
+        }
+    }
+} // namespace lpv_cpu
\ No newline at end of file
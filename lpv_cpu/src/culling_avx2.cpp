@@ -0,0 +1,60 @@
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+
+#include <bit>
+
+namespace lpv_cpu::detail
+{
+    // 8 boxes per AVX register, built with -mavx2 but without -mfma so that the distances round like the scalar
+    // kernel ones
+    void cullFrustumAVX2(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible)
+    {
+        constexpr uint32_t kWidth = 8;
+
+        // Corners furthest along the normal of every plane, selected once for all the boxes
+        struct Plane
+        {
+            std::array<const float*, 3> corner;
+            __m256                      coeffs[4];
+        };
+        std::array<Plane, 6> planes;
+        for (uint32_t p = 0; p < planes.size(); ++p)
+        {
+            const auto& plane = frustum.planes[p];
+            for (uint32_t axis = 0; axis < 3; ++axis)
+                planes[p].corner[axis] = plane[axis] >= 0.0f ? aabbs.getMax(axis) : aabbs.getMin(axis);
+            for (uint32_t k = 0; k < 4; ++k)
+                planes[p].coeffs[k] = _mm256_set1_ps(plane[k]);
+        }
+
+        const auto zero = _mm256_setzero_ps();
+        for (uint32_t i = 0; i < aabbs.size(); i += kWidth)
+        {
+            auto isOutside = _mm256_setzero_ps();
+            for (const auto& plane : planes)
+            {
+                const auto x = _mm256_loadu_ps(plane.corner[0] + i);
+                const auto y = _mm256_loadu_ps(plane.corner[1] + i);
+                const auto z = _mm256_loadu_ps(plane.corner[2] + i);
+
+                auto distance = _mm256_mul_ps(plane.coeffs[0], x);
+                distance      = _mm256_add_ps(distance, _mm256_mul_ps(plane.coeffs[1], y));
+                distance      = _mm256_add_ps(distance, _mm256_mul_ps(plane.coeffs[2], z));
+                distance      = _mm256_add_ps(distance, plane.coeffs[3]);
+                isOutside     = _mm256_or_ps(isOutside, _mm256_cmp_ps(distance, zero, _CMP_LT_OQ));
+            }
+
+            auto mask = static_cast<uint32_t>(~_mm256_movemask_ps(isOutside)) & 0xFF;
+            for (; mask; mask &= mask - 1)
+            {
+                const auto index = i + std::countr_zero(mask);
+                if (index >= aabbs.size())
+                    break;
+                visible.push_back(index);
+            }
+        }
+    }
+} // namespace lpv_cpu::detail
+#endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <emmintrin.h>
+
+#include <bit>
+
+namespace lpv_cpu::detail
+{
+    // 4 boxes per SSE register, the padding of the set covers the last ones
+    void cullFrustumSSE(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible)
+    {
+        constexpr uint32_t kWidth = 4;
+
+        // Corners furthest along the normal of every plane, selected once for all the boxes
+        struct Plane
+        {
+            std::array<const float*, 3> corner;
+            __m128                      coeffs[4];
+        };
+        std::array<Plane, 6> planes;
+        for (uint32_t p = 0; p < planes.size(); ++p)
+        {
+            const auto& plane = frustum.planes[p];
+            for (uint32_t axis = 0; axis < 3; ++axis)
+                planes[p].corner[axis] = plane[axis] >= 0.0f ? aabbs.getMax(axis) : aabbs.getMin(axis);
+            for (uint32_t k = 0; k < 4; ++k)
+                planes[p].coeffs[k] = _mm_set1_ps(plane[k]);
+        }
+
+        const auto zero = _mm_setzero_ps();
+        for (uint32_t i = 0; i < aabbs.size(); i += kWidth)
+        {
+            auto isOutside = _mm_setzero_ps();
+            for (const auto& plane : planes)
+            {
+                const auto x = _mm_loadu_ps(plane.corner[0] + i);
+                const auto y = _mm_loadu_ps(plane.corner[1] + i);
+                const auto z = _mm_loadu_ps(plane.corner[2] + i);
+
+                auto distance = _mm_mul_ps(plane.coeffs[0], x);
+                distance      = _mm_add_ps(distance, _mm_mul_ps(plane.coeffs[1], y));
+                distance      = _mm_add_ps(distance, _mm_mul_ps(plane.coeffs[2], z));
+                distance      = _mm_add_ps(distance, plane.coeffs[3]);
+                isOutside     = _mm_or_ps(isOutside, _mm_cmplt_ps(distance, zero));
+            }
+
+            auto mask = static_cast<uint32_t>(~_mm_movemask_ps(isOutside)) & 0xF;
+            for (; mask; mask &= mask - 1)
+            {
+                const auto index = i + std::countr_zero(mask);
+                if (index >= aabbs.size())
+                    break;
+                visible.push_back(index);
+            }
+        }
+    }
+} // namespace lpv_cpu::detail
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "lpv_cpu/engine.hpp"
+
+#include <algorithm>
+
+namespace lpv_cpu
+{
+    Engine::Engine(const Grid& grid, Isa isa, bool emulateHalf, Storage storage) :
+        m_Grid {grid}, m_Isa {isa}, m_EmulateHalf {emulateHalf && storage == Storage::eDense}, m_Storage {storage},
+        m_UseBrickMask {storage == Storage::eSparse}
+    {
+        if (m_Storage == Storage::eSparse)
+            m_SparseVolumes = {SparseSHVolume(grid.size), SparseSHVolume(grid.size)};
+        else
+            m_Volumes = {SHVolume(grid.size), SHVolume(grid.size)};
+    }
+
+    size_t Engine::getMemoryUsage() const
+    {
+        if (m_Storage == Storage::eSparse)
+            return m_SparseVolumes[0].getMemoryUsage() + m_SparseVolumes[1].getMemoryUsage();
+
+        const auto& paddedSize = m_Volumes[0].getPaddedSize();
+        return 2 * sizeof(float) * kNumColorChannels * kNumSHCoeffs * paddedSize[0] * paddedSize[1] * paddedSize[2];
+    }
+
+    void Engine::inject(const RSMView& rsm)
+    {
+        m_Current   = 0;
+        m_Iteration = 0;
+
+        if (m_Storage == Storage::eSparse)
+        {
+            lpv_cpu::inject(m_Grid, rsm, m_SparseVolumes[0]);
+            m_SparseVolumes[1].clear();
+        }
+        else
+        {
+            lpv_cpu::inject(m_Grid, rsm, m_Volumes[0]);
+            if (m_EmulateHalf)
+                m_Volumes[0].roundToHalf();
+
+            // Inactive bricks are never written, they have to hold no radiance from the start
+            if (m_UseBrickMask)
+                m_Volumes[1].clear();
+        }
+
+        if (m_UseBrickMask)
+        {
+            m_BrickMask = BrickMask(m_Grid.size);
+            if (m_Storage == Storage::eSparse)
+                m_BrickMask.markAllocated(m_SparseVolumes[0]);
+            else
+                m_BrickMask.markNonZero(m_Volumes[0]);
+            m_BrickMask.dilate();
+        }
+    }
+
+    void Engine::propagate(uint32_t numIterations)
+    {
+        // The brick mask is dilated between iterations, only the dense volumes propagate several at once
+        const bool canFuse  = m_Storage == Storage::eDense && !m_UseBrickMask;
+        uint32_t   numFused  = 1;
+
+        // A few slabs per thread leave room for stealing without making them too thin
+        const auto sizeZ         = m_Grid.size[2];
+        const auto numSlabs      = m_ThreadPool ? std::min(sizeZ, m_ThreadPool->getNumThreads() * 4) : 1u;
+        const auto propagateSlab = [&](uint32_t slab) {
+            const auto zBegin = slab * sizeZ / numSlabs;
+            const auto zEnd   = (slab + 1) * sizeZ / numSlabs;
+            const auto next   = 1 - m_Current;
+            if (numFused > 1)
+            {
+                lpv_cpu::propagateFused(
+                    m_Volumes[m_Current], m_Volumes[next], numFused, zBegin, zEnd, m_EmulateHalf, m_Isa);
+                return;
+            }
+
+            if (m_Storage == Storage::eSparse)
+            {
+                lpv_cpu::propagate(m_SparseVolumes[m_Current], m_SparseVolumes[next], m_BrickMask, zBegin, zEnd);
+                return;
+            }
+
+            if (m_UseBrickMask)
+                lpv_cpu::propagate(m_Volumes[m_Current], m_Volumes[next], m_BrickMask, zBegin, zEnd, m_Isa);
+            else
+                lpv_cpu::propagate(m_Volumes[m_Current], m_Volumes[next], zBegin, zEnd, m_Isa);
+            if (m_EmulateHalf)
+                m_Volumes[next].roundToHalf(zBegin, zEnd);
+        };
+
+        for (uint32_t i = 0; i < numIterations; i += numFused, m_Iteration += numFused)
+        {
+            numFused = canFuse ? std::min(m_FusedIterations, numIterations - i) : 1;
+
+            // Radiance crosses a brick every kBrickSize iterations
+            if (m_UseBrickMask && m_Iteration > 0 && m_Iteration % kBrickSize == 0)
+                m_BrickMask.dilate();
+            if (m_Storage == Storage::eSparse)
+                m_SparseVolumes[1 - m_Current].allocate(m_BrickMask);
+
+            if (m_ThreadPool)
+                m_ThreadPool->parallelFor(numSlabs, propagateSlab);
+            else
+                propagateSlab(0);
+            m_Current = 1 - m_Current;
+        }
+    }
+} // namespace lpv_cpu
\ No newline at end of file
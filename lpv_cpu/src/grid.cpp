@@ -0,0 +1,18 @@
+#include "lpv_cpu/grid.hpp"
+
+#include <algorithm>
+
+namespace lpv_cpu
+{
+    Grid Grid::fromAABB(const std::array<float, 3>& min, const std::array<float, 3>& max, uint32_t resolution)
+    {
+        Grid grid {.aabbMin = min};
+
+        const std::array<float, 3> extent {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
+        grid.cellSize = std::max({extent[0], extent[1], extent[2]}) / resolution;
+        for (uint32_t i = 0; i < 3; ++i)
+            grid.size[i] = static_cast<uint32_t>(extent[i] / grid.cellSize + 0.5f);
+
+        return grid;
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "lpv_cpu/half.hpp"
+
+#include <cstring>
+
+namespace lpv_cpu
+{
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const auto sign     = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        const auto exponent = static_cast<int32_t>((bits >> 23) & 0xffu) - 127 + 15;
+        auto       mantissa = bits & 0x7fffffu;
+
+        // NaN and infinity
+        if (((bits >> 23) & 0xffu) == 0xffu)
+            return sign | 0x7c00u | (mantissa ? 0x200u : 0u);
+
+        // Overflow to infinity
+        if (exponent >= 0x1f)
+            return sign | 0x7c00u;
+
+        // Subnormal or zero
+        if (exponent <= 0)
+        {
+            if (exponent < -10)
+                return sign;
+
+            mantissa |= 0x800000u;
+            const auto shift   = static_cast<uint32_t>(14 - exponent);
+            auto       half    = mantissa >> shift;
+            const auto rest    = mantissa & ((1u << shift) - 1u);
+            const auto halfway = 1u << (shift - 1u);
+            if (rest > halfway || (rest == halfway && (half & 1u)))
+                ++half;
+            return sign | static_cast<uint16_t>(half);
+        }
+
+        // Normal, round to nearest even (a carry into the exponent is still correct)
+        auto       half = static_cast<uint32_t>(exponent << 10) | (mantissa >> 13);
+        const auto rest = mantissa & 0x1fffu;
+        if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+            ++half;
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    float halfToFloat(uint16_t value)
+    {
+        const uint32_t sign     = (value & 0x8000u) << 16;
+        uint32_t       exponent = (value >> 10) & 0x1fu;
+        uint32_t       mantissa = value & 0x3ffu;
+
+        uint32_t bits;
+        if (exponent == 0x1fu)
+        {
+            bits = sign | 0x7f800000u | (mantissa << 13);
+        }
+        else if (exponent == 0)
+        {
+            if (mantissa == 0)
+            {
+                bits = sign;
+            }
+            else
+            {
+                // Normalize the subnormal
+                exponent = 127 - 15 + 1;
+                while (!(mantissa & 0x400u))
+                {
+                    mantissa <<= 1;
+                    --exponent;
+                }
+                bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+            }
+        }
+        else
+        {
+            bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+} // namespace lpv_cpu
\ No newline at end of file
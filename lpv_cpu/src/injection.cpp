@@ -0,0 +1,67 @@
+#include "lpv_cpu/injection.hpp"
+#include "lpv_cpu/sh.hpp"
+
+#include <cmath>
+
+namespace lpv_cpu
+{
+    namespace
+    {
+        // Calls accumulate(cell, color, coeff, value) for every SH coefficient a VPL injects
+        template<typename Accumulate>
+        void forEachVPL(const Grid& grid, const RSMView& rsm, Accumulate&& accumulate)
+        {
+            const auto numVPL = static_cast<size_t>(rsm.resolution) * rsm.resolution;
+            for (size_t i = 0; i < numVPL; ++i)
+            {
+                const auto* position = rsm.position + i * 3;
+                const auto* normal   = rsm.normal + i * 3;
+                const auto* flux     = rsm.flux + i * 3;
+
+                // The fragment shader discards texels without a surface
+                if (std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) < 0.01f)
+                    continue;
+
+                // ivec3() truncates towards zero, like the vertex shader
+                std::array<uint32_t, 3> cell;
+                bool                    isInside = true;
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    const auto index = static_cast<int32_t>((position[axis] - grid.aabbMin[axis]) / grid.cellSize +
+                                                            0.5f * normal[axis]);
+                    isInside &= index >= 0 && index < static_cast<int32_t>(grid.size[axis]);
+                    cell[axis] = static_cast<uint32_t>(index);
+                }
+                if (!isInside)
+                    continue;
+
+                const auto coeffs = evaluateSHCosineLobe(normal[0], normal[1], normal[2]);
+                for (uint32_t color = 0; color < kNumColorChannels; ++color)
+                {
+                    for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                        accumulate(cell, color, coeff, coeffs[coeff] / kPI * flux[color]);
+                }
+            }
+        }
+    } // namespace
+
+    void inject(const Grid& grid, const RSMView& rsm, SHVolume& volume)
+    {
+        volume.clear();
+
+        forEachVPL(grid, rsm, [&](const std::array<uint32_t, 3>& cell, uint32_t color, uint32_t coeff, float value) {
+            volume.getChannel(color, coeff)[volume.getIndex(cell[0], cell[1], cell[2])] += value;
+        });
+    }
+
+    void inject(const Grid& grid, const RSMView& rsm, SparseSHVolume& volume)
+    {
+        volume.clear();
+
+        forEachVPL(grid, rsm, [&](const std::array<uint32_t, 3>& cell, uint32_t color, uint32_t coeff, float value) {
+            auto* brick = volume.allocate(cell[0] / kBrickSize, cell[1] / kBrickSize, cell[2] / kBrickSize);
+            brick[SparseSHVolume::getChannelOffset(color, coeff) +
+                  SparseSHVolume::getCellIndex(cell[0], cell[1], cell[2])] += value;
+        });
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "lpv_cpu/culling.hpp"
+#include "lpv_cpu/sh.hpp"
+#include "lpv_cpu/sh_volume.hpp"
+
+#include <cstddef>
+
+namespace lpv_cpu::detail
+{
+    // Neighbour weights flattened as [neighbour][k][j] and neighbour offsets as strides into the padded arrays
+    struct PropagationTable
+    {
+        std::array<float, 6 * kNumSHCoeffs * kNumSHCoeffs> weights;
+        std::array<ptrdiff_t, 6>                           strides;
+
+        explicit PropagationTable(const SHVolume& volume);
+
+        float getWeight(uint32_t neighbour, uint32_t k, uint32_t j) const
+        {
+            return weights[(neighbour * kNumSHCoeffs + k) * kNumSHCoeffs + j];
+        }
+    };
+
+    // Cells [begin, end) of the output the kernels propagate, the whole volume or a run of bricks
+    struct CellBox
+    {
+        std::array<uint32_t, 3> begin;
+        std::array<uint32_t, 3> end;
+    };
+
+    void propagateScalar(const PropagationTable& table, const SHVolume& in, SHVolume& out, const CellBox& box);
+    void propagateSSE(const PropagationTable& table, const SHVolume& in, SHVolume& out, const CellBox& box);
+    void propagateAVX2(const PropagationTable& table, const SHVolume& in, SHVolume& out, const CellBox& box);
+
+    // Scalar propagation of the cells [xBegin, xEnd) of a row, shared by the remainders of the SIMD kernels
+    void propagateRowScalar(const PropagationTable& table,
+                            const SHVolume&         in,
+                            SHVolume&               out,
+                            size_t                  rowIndex,
+                            uint32_t                xBegin,
+                            uint32_t                xEnd);
+
+    // Append the indices of the boxes of `aabbs` inside of the frustum to `visible`, kAABBSetWidth boxes at a time
+    void cullFrustumScalar(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible);
+    void cullFrustumSSE(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible);
+    void cullFrustumAVX2(const AABBSet& aabbs, const Frustum& frustum, std::vector<uint32_t>& visible);
+} // namespace lpv_cpu::detail
\ No newline at end of file
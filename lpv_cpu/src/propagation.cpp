@@ -0,0 +1,373 @@
+#include "lpv_cpu/propagation.hpp"
+#include "kernels.hpp"
+#include "lpv_cpu/half.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LPV_CPU_X86
+#endif
+
+#if defined(_MSC_VER) && defined(LPV_CPU_X86)
+#include <intrin.h>
+#endif
+
+namespace lpv_cpu
+{
+    namespace detail
+    {
+        PropagationTable::PropagationTable(const SHVolume& volume)
+        {
+            const auto& paddedSize = volume.getPaddedSize();
+            const auto& neighbours = getNeighbourPropagations();
+            for (uint32_t n = 0; n < 6; ++n)
+            {
+                const auto& offset = neighbours[n].offset;
+                strides[n]         = offset[0] + static_cast<ptrdiff_t>(paddedSize[0]) *
+                                                     (offset[1] + static_cast<ptrdiff_t>(paddedSize[1]) * offset[2]);
+
+                for (uint32_t k = 0; k < kNumSHCoeffs; ++k)
+                {
+                    for (uint32_t j = 0; j < kNumSHCoeffs; ++j)
+                        weights[(n * kNumSHCoeffs + k) * kNumSHCoeffs + j] = neighbours[n].weights[k][j];
+                }
+            }
+        }
+
+        void propagateRowScalar(const PropagationTable& table,
+                                const SHVolume&         in,
+                                SHVolume&               out,
+                                size_t                  rowIndex,
+                                uint32_t                xBegin,
+                                uint32_t                xEnd)
+        {
+            for (uint32_t color = 0; color < kNumColorChannels; ++color)
+            {
+                for (uint32_t x = xBegin; x < xEnd; ++x)
+                {
+                    const auto index = rowIndex + x;
+
+                    float contribution[kNumSHCoeffs] {};
+                    for (uint32_t n = 0; n < 6; ++n)
+                    {
+                        for (uint32_t j = 0; j < kNumSHCoeffs; ++j)
+                        {
+                            const auto neighbour = in.getChannel(color, j)[index + table.strides[n]];
+                            for (uint32_t k = 0; k < kNumSHCoeffs; ++k)
+                                contribution[k] += table.getWeight(n, k, j) * neighbour;
+                        }
+                    }
+
+                    for (uint32_t k = 0; k < kNumSHCoeffs; ++k)
+                        out.getChannel(color, k)[index] = contribution[k];
+                }
+            }
+        }
+
+        void propagateScalar(const PropagationTable& table, const SHVolume& in, SHVolume& out, const CellBox& box)
+        {
+            for (uint32_t z = box.begin[2]; z < box.end[2]; ++z)
+            {
+                for (uint32_t y = box.begin[1]; y < box.end[1]; ++y)
+                    propagateRowScalar(table, in, out, in.getIndex(0, y, z), box.begin[0], box.end[0]);
+            }
+        }
+
+#ifndef LPV_CPU_X86
+        void propagateSSE(const PropagationTable& table, const SHVolume& in, SHVolume& out, const CellBox& box)
+        {
+            propagateScalar(table, in, out, box);
+        }
+
+        void propagateAVX2(const PropagationTable& table, const SHVolume& in, SHVolume& out, const CellBox& box)
+        {
+            propagateScalar(table, in, out, box);
+        }
+#endif
+    } // namespace detail
+
+    namespace
+    {
+        void propagateBox(const detail::PropagationTable& table,
+                          const SHVolume&                 in,
+                          SHVolume&                       out,
+                          const detail::CellBox&          box,
+                          Isa                             isa)
+        {
+            switch (isa)
+            {
+                case Isa::eScalar:
+                    detail::propagateScalar(table, in, out, box);
+                    break;
+                case Isa::eSSE:
+                    detail::propagateSSE(table, in, out, box);
+                    break;
+                case Isa::eAVX2:
+                    detail::propagateAVX2(table, in, out, box);
+                    break;
+            }
+        }
+
+        // Copies the cells [srcBegin, srcBegin + extent) of `src` to the cells starting at dstBegin of `dst`
+        void copyCells(const SHVolume&                src,
+                       const std::array<uint32_t, 3>& srcBegin,
+                       SHVolume&                      dst,
+                       const std::array<uint32_t, 3>& dstBegin,
+                       const std::array<uint32_t, 3>& extent)
+        {
+            for (uint32_t color = 0; color < kNumColorChannels; ++color)
+            {
+                for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                {
+                    const auto* srcChannel = src.getChannel(color, coeff);
+                    auto*       dstChannel = dst.getChannel(color, coeff);
+                    for (uint32_t z = 0; z < extent[2]; ++z)
+                    {
+                        for (uint32_t y = 0; y < extent[1]; ++y)
+                        {
+                            std::copy_n(srcChannel + src.getIndex(srcBegin[0], srcBegin[1] + y, srcBegin[2] + z),
+                                        extent[0],
+                                        dstChannel + dst.getIndex(dstBegin[0], dstBegin[1] + y, dstBegin[2] + z));
+                        }
+                    }
+                }
+            }
+        }
+
+        // Emulates the RGBA16F storage of the GPU volumes over the cells of a box
+        void roundToHalf(SHVolume& volume, const detail::CellBox& box)
+        {
+            for (uint32_t color = 0; color < kNumColorChannels; ++color)
+            {
+                for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                {
+                    auto* channel = volume.getChannel(color, coeff);
+                    for (uint32_t z = box.begin[2]; z < box.end[2]; ++z)
+                    {
+                        for (uint32_t y = box.begin[1]; y < box.end[1]; ++y)
+                        {
+                            auto* row = channel + volume.getIndex(0, y, z);
+                            for (uint32_t x = box.begin[0]; x < box.end[0]; ++x)
+                                row[x] = lpv_cpu::roundToHalf(row[x]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Propagates the output cells [tileBegin, tileEnd) K times in `regions`, the tile grown by a halo of K cells
+        template<uint32_t K>
+        void propagateFusedTile(const detail::PropagationTable& table,
+                                const SHVolume&                 in,
+                                SHVolume&                       out,
+                                std::array<SHVolume, 2>&        regions,
+                                const std::array<uint32_t, 3>&  tileBegin,
+                                const std::array<uint32_t, 3>&  tileEnd,
+                                bool                            emulateHalf,
+                                Isa                             isa)
+        {
+            constexpr uint32_t kRegionSize = kFusedTileSize + 2 * K;
+
+            // Cells of the region inside of the volume, the others hold no radiance at any iteration
+            const auto&     size = in.getSize();
+            detail::CellBox inside {};
+            bool            isInside = true;
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                const auto origin = static_cast<int64_t>(tileBegin[i]) - K;
+                inside.begin[i]   = static_cast<uint32_t>(std::max<int64_t>(-origin, 0));
+                inside.end[i]     = static_cast<uint32_t>(std::min<int64_t>(size[i] - origin, kRegionSize));
+                isInside          = isInside && inside.begin[i] == 0 && inside.end[i] == kRegionSize;
+            }
+
+            // Cells outside of the volume may hold radiance of the previous tile
+            if (!isInside)
+            {
+                for (auto& region : regions)
+                    region.clear();
+            }
+
+            copyCells(in,
+                      {tileBegin[0] + inside.begin[0] - K,
+                       tileBegin[1] + inside.begin[1] - K,
+                       tileBegin[2] + inside.begin[2] - K},
+                      regions[0],
+                      inside.begin,
+                      {inside.end[0] - inside.begin[0],
+                       inside.end[1] - inside.begin[1],
+                       inside.end[2] - inside.begin[2]});
+
+            for (uint32_t step = 1; step <= K; ++step)
+            {
+                // After `step` iterations only the cells [step, kRegionSize - step) have had all their neighbours
+                detail::CellBox box {};
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    box.begin[i] = std::max(step, inside.begin[i]);
+                    box.end[i]   = std::min(kRegionSize - step, inside.end[i]);
+                }
+
+                auto& propagated = regions[step % 2];
+                propagateBox(table, regions[(step - 1) % 2], propagated, box, isa);
+                if (emulateHalf)
+                    roundToHalf(propagated, box);
+            }
+
+            copyCells(regions[K % 2],
+                      {K, K, K},
+                      out,
+                      tileBegin,
+                      {tileEnd[0] - tileBegin[0], tileEnd[1] - tileBegin[1], tileEnd[2] - tileBegin[2]});
+        }
+    } // namespace
+
+    const char* toString(Isa isa)
+    {
+        switch (isa)
+        {
+            case Isa::eScalar:
+                return "Scalar";
+            case Isa::eSSE:
+                return "SSE";
+            case Isa::eAVX2:
+                return "AVX2";
+        }
+        return "Unknown";
+    }
+
+    Isa detectIsa()
+    {
+#if defined(LPV_CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return Isa::eAVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return Isa::eSSE;
+#elif defined(LPV_CPU_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            const bool hasAVX2 = (info[1] & (1 << 5)) != 0;
+            __cpuid(info, 1);
+            const bool hasFMA     = (info[2] & (1 << 12)) != 0;
+            const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+            if (hasAVX2 && hasFMA && hasOSXSAVE && (_xgetbv(0) & 0x6) == 0x6)
+                return Isa::eAVX2;
+        }
+        return Isa::eSSE;
+#endif
+        return Isa::eScalar;
+    }
+
+    void propagate(const SHVolume& in, SHVolume& out, uint32_t zBegin, uint32_t zEnd, Isa isa)
+    {
+        const auto& size = in.getSize();
+        propagateBox(detail::PropagationTable(in), in, out, {{0, 0, zBegin}, {size[0], size[1], zEnd}}, isa);
+    }
+
+    void propagate(const SHVolume& in, SHVolume& out, const BrickMask& mask, uint32_t zBegin, uint32_t zEnd, Isa isa)
+    {
+        const detail::PropagationTable table(in);
+
+        const auto& size       = in.getSize();
+        const auto& brickCount = mask.getBrickCount();
+        for (auto bz = zBegin / kBrickSize; bz * kBrickSize < zEnd; ++bz)
+        {
+            for (uint32_t by = 0; by < brickCount[1]; ++by)
+            {
+                // Runs of active bricks along x keep the SIMD kernels busy
+                for (uint32_t bx = 0; bx < brickCount[0];)
+                {
+                    if (!mask.isActive(bx, by, bz))
+                    {
+                        ++bx;
+                        continue;
+                    }
+
+                    const auto runBegin = bx;
+                    while (bx < brickCount[0] && mask.isActive(bx, by, bz))
+                        ++bx;
+
+                    const detail::CellBox box {
+                        {runBegin * kBrickSize, by * kBrickSize, std::max(bz * kBrickSize, zBegin)},
+                        {std::min(bx * kBrickSize, size[0]),
+                         std::min((by + 1) * kBrickSize, size[1]),
+                         std::min((bz + 1) * kBrickSize, zEnd)},
+                    };
+                    propagateBox(table, in, out, box, isa);
+                }
+            }
+        }
+    }
+
+    void propagate(const SHVolume& in, SHVolume& out, Isa isa) { propagate(in, out, 0, in.getSize()[2], isa); }
+
+    template<uint32_t K>
+    void propagateFused(const SHVolume& in, SHVolume& out, uint32_t zBegin, uint32_t zEnd, bool emulateHalf, Isa isa)
+    {
+        static_assert(K >= 1 && K <= kMaxFusedIterations);
+
+        constexpr uint32_t      kRegionSize = kFusedTileSize + 2 * K;
+        std::array<SHVolume, 2> regions {SHVolume({kRegionSize, kRegionSize, kRegionSize}),
+                                         SHVolume({kRegionSize, kRegionSize, kRegionSize})};
+        const detail::PropagationTable table(regions[0]);
+
+        const auto& size = in.getSize();
+        for (auto z = zBegin; z < zEnd; z += kFusedTileSize)
+        {
+            for (uint32_t y = 0; y < size[1]; y += kFusedTileSize)
+            {
+                for (uint32_t x = 0; x < size[0]; x += kFusedTileSize)
+                {
+                    propagateFusedTile<K>(table,
+                                          in,
+                                          out,
+                                          regions,
+                                          {x, y, z},
+                                          {std::min(x + kFusedTileSize, size[0]),
+                                           std::min(y + kFusedTileSize, size[1]),
+                                           std::min(z + kFusedTileSize, zEnd)},
+                                          emulateHalf,
+                                          isa);
+                }
+            }
+        }
+    }
+
+    template void propagateFused<1>(const SHVolume&, SHVolume&, uint32_t, uint32_t, bool, Isa);
+    template void propagateFused<2>(const SHVolume&, SHVolume&, uint32_t, uint32_t, bool, Isa);
+    template void propagateFused<3>(const SHVolume&, SHVolume&, uint32_t, uint32_t, bool, Isa);
+    template void propagateFused<4>(const SHVolume&, SHVolume&, uint32_t, uint32_t, bool, Isa);
+
+    void propagateFused(const SHVolume& in,
+                        SHVolume&       out,
+                        uint32_t        numIterations,
+                        uint32_t        zBegin,
+                        uint32_t        zEnd,
+                        bool            emulateHalf,
+                        Isa             isa)
+    {
+        static_assert(kMaxFusedIterations == 4, "missing instantiations");
+
+        switch (numIterations)
+        {
+            case 1:
+                propagateFused<1>(in, out, zBegin, zEnd, emulateHalf, isa);
+                break;
+            case 2:
+                propagateFused<2>(in, out, zBegin, zEnd, emulateHalf, isa);
+                break;
+            case 3:
+                propagateFused<3>(in, out, zBegin, zEnd, emulateHalf, isa);
+                break;
+            case 4:
+                propagateFused<4>(in, out, zBegin, zEnd, emulateHalf, isa);
+                break;
+            default:
+                assert(false && "unsupported number of fused iterations");
+                break;
+        }
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <emmintrin.h>
+
+namespace lpv_cpu::detail
+{
+    // 4 cells per SSE register; the rest of every row falls back to the scalar kernel
+    void propagateSSE(const PropagationTable& table, const SHVolume& in, SHVolume& out, const CellBox& box)
+    {
+        constexpr uint32_t kWidth = 4;
+
+        const auto vectorEnd = box.end[0] - (box.end[0] - box.begin[0]) % kWidth;
+        for (uint32_t z = box.begin[2]; z < box.end[2]; ++z)
+        {
+            for (uint32_t y = box.begin[1]; y < box.end[1]; ++y)
+            {
+                const auto rowIndex = in.getIndex(0, y, z);
+                for (uint32_t color = 0; color < kNumColorChannels; ++color)
+                {
+                    for (uint32_t x = box.begin[0]; x < vectorEnd; x += kWidth)
+                    {
+                        const auto index = rowIndex + x;
+
+                        __m128 acc[kNumSHCoeffs];
+                        for (auto& value : acc)
+                            value = _mm_setzero_ps();
+
+                        for (uint32_t n = 0; n < 6; ++n)
+                        {
+                            for (uint32_t j = 0; j < kNumSHCoeffs; ++j)
+                            {
+                                const auto* channel   = in.getChannel(color, j) + table.strides[n];
+                                const auto  neighbour = _mm_loadu_ps(channel + index);
+                                for (uint32_t k = 0; k < kNumSHCoeffs; ++k)
+                                {
+                                    const auto weight = _mm_set1_ps(table.getWeight(n, k, j));
+                                    acc[k]            = _mm_add_ps(acc[k], _mm_mul_ps(weight, neighbour));
+                                }
+                            }
+                        }
+
+                        for (uint32_t k = 0; k < kNumSHCoeffs; ++k)
+                            _mm_storeu_ps(out.getChannel(color, k) + index, acc[k]);
+                    }
+                }
+                propagateRowScalar(table, in, out, rowIndex, vectorEnd, box.end[0]);
+            }
+        }
+    }
+} // namespace lpv_cpu::detail
+#endif
\ No newline at end of file
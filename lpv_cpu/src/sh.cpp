@@ -0,0 +1,136 @@
+#include "lpv_cpu/sh.hpp"
+
+#include <cstdio>
+
+namespace lpv_cpu
+{
+    namespace
+    {
+        constexpr bool isClose(float a, float b, float tolerance = 1e-6f)
+        {
+            return (a > b ? a - b : b - a) <= tolerance;
+        }
+
+        constexpr bool isClose(const SHCoeffs& a, const SHCoeffs& b)
+        {
+            for (uint32_t i = 0; i < a.size(); ++i)
+            {
+                if (!isClose(a[i], b[i]))
+                    return false;
+            }
+            return true;
+        }
+
+        // SH_Evaluate and SH_EvaluateCosineLobe of lib/lpv.glsl: (C0, -C1 * y, C1 * z, -C1 * x) of the normalized
+        // direction
+        static_assert(isClose(evaluateSH(0.0f, 0.0f, 1.0f), {kSH_C0, 0.0f, kSH_C1, 0.0f}));
+        static_assert(isClose(evaluateSH(0.0f, 2.0f, 0.0f), {kSH_C0, -kSH_C1, 0.0f, 0.0f}));
+        static_assert(isClose(evaluateSH(-3.0f, 0.0f, 0.0f), {kSH_C0, 0.0f, 0.0f, kSH_C1}));
+        static_assert(isClose(evaluateSHCosineLobe(1.0f, 0.0f, 0.0f), {kSH_cosLobeC0, 0.0f, 0.0f, -kSH_cosLobeC1}));
+        static_assert(evaluateSH<1>(1.0f, 0.0f, 0.0f)[0] == kSH_C0);
+
+        // The Z+ neighbour of lpv_propagation.glsl: the cell below, its main face and the first side face
+        constexpr auto& kZPositive = kNeighbourPropagations[0];
+        static_assert(kZPositive.offset == std::array<int32_t, 3> {0, 0, -1});
+        static_assert(isClose(kZPositive.faces[0].solidAngle, 0.4006696846f / kPI));
+        static_assert(isClose(kZPositive.faces[0].projection, evaluateSH(0.0f, 0.0f, 1.0f)));
+        static_assert(isClose(kZPositive.faces[0].reprojection, evaluateSHCosineLobe(0.0f, 0.0f, 1.0f)));
+        static_assert(isClose(kZPositive.faces[1].solidAngle, 0.4234413544f / kPI));
+        static_assert(
+            isClose(kZPositive.faces[1].projection, {kSH_C0, 0.0f, kSH_C1 * 0.894427f, -kSH_C1 * 0.4472135f}));
+        static_assert(isClose(kZPositive.faces[1].reprojection, {kSH_cosLobeC0, 0.0f, 0.0f, -kSH_cosLobeC1}));
+
+        // Opposite neighbours mirror each other
+        static_assert(kNeighbourPropagations[2].offset == std::array<int32_t, 3> {1, 0, 0});
+        static_assert(kNeighbourPropagations[3].offset == std::array<int32_t, 3> {-1, 0, 0});
+        static_assert(isClose(kNeighbourPropagations[2].weights[0][0], kNeighbourPropagations[3].weights[0][0]));
+        static_assert(isClose(kNeighbourPropagations[2].weights[3][0], -kNeighbourPropagations[3].weights[3][0]));
+
+        // A GLSL float literal, without the sign of zeros
+        std::string formatFloat(float value)
+        {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.9g", value == 0.0f ? 0.0f : value);
+
+            std::string literal = buffer;
+            if (literal.find_first_of(".e") == std::string::npos)
+                literal += ".0";
+            return literal;
+        }
+
+        void appendVec4(std::string& glsl, const char* indent, const SHCoeffs& v, bool isLast)
+        {
+            glsl += std::string(indent) + "vec4(" + formatFloat(v[0]) + ", " + formatFloat(v[1]) + ", " +
+                    formatFloat(v[2]) + ", " + formatFloat(v[3]) + (isLast ? ")\n" : "),\n");
+        }
+    } // namespace
+
+    std::string generatePropagationTablesGLSL()
+    {
+        std::string glsl = "// Generated by lpv-sh-tables from lpv_cpu/sh.hpp, do not edit\n"
+                           "#ifndef SH_TABLES_GLSL\n"
+                           "#define SH_TABLES_GLSL\n\n";
+
+        glsl += "// SH constants of the first 2 bands (1 / 2sqrt(pi), sqrt(3/pi) / 2) and of a cosine lobe\n"
+                "// (sqrt(pi) / 2, sqrt(pi/3))\n";
+        glsl += "#define SH_C0 " + formatFloat(kSH_C0) + "\n";
+        glsl += "#define SH_C1 " + formatFloat(kSH_C1) + "\n";
+        glsl += "#define SH_cosLobe_C0 " + formatFloat(kSH_cosLobeC0) + "\n";
+        glsl += "#define SH_cosLobe_C1 " + formatFloat(kSH_cosLobeC1) + "\n\n";
+
+        char buffer[128];
+
+        glsl += "// Cell every neighbour (Z+, Z-, X+, X-, Y+, Y-) propagates from, relative to the propagated cell\n"
+                "const ivec3 kNeighbourOffsets[6] = ivec3[6](\n";
+        for (uint32_t n = 0; n < 6; ++n)
+        {
+            const auto& offset = kNeighbourPropagations[n].offset;
+            std::snprintf(
+                buffer, sizeof(buffer), "    ivec3(%d, %d, %d)%s\n", offset[0], offset[1], offset[2], n < 5 ? "," : "");
+            glsl += buffer;
+        }
+        glsl += ");\n\n";
+
+        glsl += "// Faces of every neighbour, the main one then the 4 sides: solid angle * SH_Evaluate of the\n"
+                "// evaluation direction and SH_EvaluateCosineLobe of the reprojection direction\n";
+        glsl += "const vec4 kFaceProjections[30] = vec4[30](\n";
+        for (uint32_t n = 0; n < 6; ++n)
+        {
+            for (uint32_t f = 0; f < kNumPropagationFaces; ++f)
+            {
+                const auto& face       = kNeighbourPropagations[n].faces[f];
+                auto        projection = face.projection;
+                for (auto& coeff : projection)
+                    coeff *= face.solidAngle;
+                appendVec4(glsl, "    ", projection, n * kNumPropagationFaces + f == 29);
+            }
+        }
+        glsl += ");\n";
+        glsl += "const vec4 kFaceReprojections[30] = vec4[30](\n";
+        for (uint32_t n = 0; n < 6; ++n)
+        {
+            for (uint32_t f = 0; f < kNumPropagationFaces; ++f)
+            {
+                appendVec4(
+                    glsl, "    ", kNeighbourPropagations[n].faces[f].reprojection, n * kNumPropagationFaces + f == 29);
+            }
+        }
+        glsl += ");\n\n";
+
+        // mat4 columns: out[k] = sum_j weights[k][j] * in[j], so column j holds weights[.][j]
+        glsl += "// The faces of every neighbour folded into a matrix:\n"
+                "// contribution += kPropagationMatrices[n] * neighbour\n"
+                "const mat4 kPropagationMatrices[6] = mat4[6](\n";
+        for (uint32_t n = 0; n < 6; ++n)
+        {
+            const auto& weights = kNeighbourPropagations[n].weights;
+            glsl += "    mat4(\n";
+            for (uint32_t j = 0; j < 4; ++j)
+                appendVec4(glsl, "        ", {weights[0][j], weights[1][j], weights[2][j], weights[3][j]}, j == 3);
+            glsl += n < 5 ? "    ),\n" : "    )\n";
+        }
+        glsl += ");\n\n#endif\n";
+
+        return glsl;
+    }
+} // namespace lpv_cpu
\ No newline at end of file
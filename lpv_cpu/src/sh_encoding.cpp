@@ -0,0 +1,101 @@
+#include "lpv_cpu/sh_encoding.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lpv_cpu
+{
+    namespace
+    {
+        constexpr int   kMantissaBits   = 10;
+        constexpr float kMantissaScale  = 511.0f; // Largest 10-bit signed mantissa
+        constexpr int   kExponentBias   = 127;
+        constexpr int   kCoeffsPerWord  = 3;
+        constexpr int   kNumCellCoeffs  = kNumColorChannels * kNumSHCoeffs;
+        constexpr int   kExponentBits   = 2; // Per word
+        constexpr int   kExponentOffset = kCoeffsPerWord * kMantissaBits;
+    } // namespace
+
+    PackedSHCell encodeSharedExponent(const SHCell& cell)
+    {
+        float maxValue = 0.0f;
+        for (const auto& color : cell)
+        {
+            for (const auto value : color)
+                maxValue = std::max(maxValue, std::abs(value));
+        }
+
+        PackedSHCell packed {};
+        if (maxValue == 0.0f)
+            return packed;
+
+        // maxValue = f * 2^exponent with f in [0.5, 1), every coefficient divided by 2^exponent is within (-1, 1)
+        int exponent;
+        std::frexp(maxValue, &exponent);
+        const auto biasedExponent = static_cast<uint32_t>(std::clamp(exponent + kExponentBias, 0, 255));
+        const auto scale          = kMantissaScale / std::ldexp(1.0f, static_cast<int>(biasedExponent) - kExponentBias);
+
+        for (int i = 0; i < kNumCellCoeffs; ++i)
+        {
+            const auto value    = cell[i / kNumSHCoeffs][i % kNumSHCoeffs] * scale;
+            const auto mantissa = static_cast<int32_t>(std::round(std::clamp(value, -kMantissaScale, kMantissaScale)));
+            packed[i / kCoeffsPerWord] |= (static_cast<uint32_t>(mantissa) & 0x3ffu)
+                                          << ((i % kCoeffsPerWord) * kMantissaBits);
+        }
+
+        for (uint32_t word = 0; word < packed.size(); ++word)
+            packed[word] |= ((biasedExponent >> (word * kExponentBits)) & 0x3u) << kExponentOffset;
+
+        return packed;
+    }
+
+    SHCell decodeSharedExponent(const PackedSHCell& packed)
+    {
+        uint32_t biasedExponent = 0;
+        for (uint32_t word = 0; word < packed.size(); ++word)
+            biasedExponent |= (packed[word] >> kExponentOffset) << (word * kExponentBits);
+
+        const auto scale = std::ldexp(1.0f, static_cast<int>(biasedExponent) - kExponentBias) / kMantissaScale;
+
+        SHCell cell;
+        for (int i = 0; i < kNumCellCoeffs; ++i)
+        {
+            // Sign extension of the 10-bit two's complement
+            const auto bits     = packed[i / kCoeffsPerWord] >> ((i % kCoeffsPerWord) * kMantissaBits);
+            const auto mantissa = static_cast<int32_t>(bits << (32 - kMantissaBits)) >> (32 - kMantissaBits);
+            cell[i / kNumSHCoeffs][i % kNumSHCoeffs] = static_cast<float>(mantissa) * scale;
+        }
+
+        return cell;
+    }
+
+    void roundToSharedExponent(SHVolume& volume)
+    {
+        const auto& size = volume.getSize();
+        for (uint32_t z = 0; z < size[2]; ++z)
+        {
+            for (uint32_t y = 0; y < size[1]; ++y)
+            {
+                for (uint32_t x = 0; x < size[0]; ++x)
+                {
+                    const auto index = volume.getIndex(x, y, z);
+
+                    SHCell cell;
+                    for (uint32_t color = 0; color < kNumColorChannels; ++color)
+                    {
+                        for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                            cell[color][coeff] = volume.getChannel(color, coeff)[index];
+                    }
+
+                    cell = decodeSharedExponent(encodeSharedExponent(cell));
+
+                    for (uint32_t color = 0; color < kNumColorChannels; ++color)
+                    {
+                        for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                            volume.getChannel(color, coeff)[index] = cell[color][coeff];
+                    }
+                }
+            }
+        }
+    }
+} // namespace lpv_cpu
@@ -0,0 +1,78 @@
+#include "lpv_cpu/sh_volume.hpp"
+#include "lpv_cpu/half.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lpv_cpu
+{
+    SHVolume::SHVolume(const std::array<uint32_t, 3>& size) :
+        m_Size {size}, m_PaddedSize {size[0] + 2, size[1] + 2, size[2] + 2},
+        m_PaddedCells {static_cast<size_t>(m_PaddedSize[0]) * m_PaddedSize[1] * m_PaddedSize[2]},
+        m_Data(m_PaddedCells * kNumColorChannels * kNumSHCoeffs, 0.0f)
+    {}
+
+    void SHVolume::clear() { std::fill(m_Data.begin(), m_Data.end(), 0.0f); }
+
+    void SHVolume::roundToHalf()
+    {
+        for (auto& value : m_Data)
+            value = lpv_cpu::roundToHalf(value);
+    }
+
+    void SHVolume::roundToHalf(uint32_t zBegin, uint32_t zEnd)
+    {
+        const auto sliceBegin = getIndex(0, 0, zBegin) - m_PaddedSize[0] - 1;
+        const auto sliceEnd   = getIndex(0, 0, zEnd) - m_PaddedSize[0] - 1;
+        for (uint32_t channel = 0; channel < kNumColorChannels * kNumSHCoeffs; ++channel)
+        {
+            auto* data = m_Data.data() + channel * m_PaddedCells;
+            for (auto i = sliceBegin; i < sliceEnd; ++i)
+                data[i] = lpv_cpu::roundToHalf(data[i]);
+        }
+    }
+
+    void SHVolume::exportHalf(uint32_t color, uint16_t* texels) const
+    {
+        for (uint32_t z = 0; z < m_Size[2]; ++z)
+        {
+            for (uint32_t y = 0; y < m_Size[1]; ++y)
+            {
+                for (uint32_t x = 0; x < m_Size[0]; ++x)
+                {
+                    const auto index = getIndex(x, y, z);
+                    for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                        *texels++ = floatToHalf(getChannel(color, coeff)[index]);
+                }
+            }
+        }
+    }
+
+    void SHVolume::importHalf(uint32_t color, const uint16_t* texels)
+    {
+        for (uint32_t z = 0; z < m_Size[2]; ++z)
+        {
+            for (uint32_t y = 0; y < m_Size[1]; ++y)
+            {
+                for (uint32_t x = 0; x < m_Size[0]; ++x)
+                {
+                    const auto index = getIndex(x, y, z);
+                    for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                        getChannel(color, coeff)[index] = halfToFloat(*texels++);
+                }
+            }
+        }
+    }
+
+    float SHVolume::getMaxAbsDifference(const SHVolume& other) const
+    {
+        if (m_Size != other.m_Size)
+            return INFINITY;
+
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < m_Data.size(); ++i)
+            maxDifference = std::max(maxDifference, std::abs(m_Data[i] - other.m_Data[i]));
+
+        return maxDifference;
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "lpv_cpu/propagation.hpp"
+#include "lpv_cpu/sh.hpp"
+
+#include <algorithm>
+
+namespace lpv_cpu
+{
+    void propagate(const SparseSHVolume& in,
+                   SparseSHVolume&       out,
+                   const BrickMask&      mask,
+                   uint32_t              zBegin,
+                   uint32_t              zEnd)
+    {
+        const auto& size       = in.getSize();
+        const auto& brickCount = in.getBrickCount();
+        const auto& neighbours = getNeighbourPropagations();
+
+        for (auto bz = zBegin / kBrickSize; bz * kBrickSize < zEnd; ++bz)
+        {
+            for (uint32_t by = 0; by < brickCount[1]; ++by)
+            {
+                for (uint32_t bx = 0; bx < brickCount[0]; ++bx)
+                {
+                    if (!mask.isActive(bx, by, bz))
+                        continue;
+
+                    auto* brick = out.getBrick(bx, by, bz);
+
+                    const std::array<uint32_t, 3> begin {bx * kBrickSize, by * kBrickSize, bz * kBrickSize};
+                    const std::array<uint32_t, 3> end {std::min(begin[0] + kBrickSize, size[0]),
+                                                       std::min(begin[1] + kBrickSize, size[1]),
+                                                       std::min(begin[2] + kBrickSize, size[2])};
+                    for (auto z = std::max(begin[2], zBegin); z < std::min(end[2], zEnd); ++z)
+                    {
+                        for (auto y = begin[1]; y < end[1]; ++y)
+                        {
+                            for (auto x = begin[0]; x < end[0]; ++x)
+                            {
+                                float contributions[kNumColorChannels][kNumSHCoeffs] {};
+                                for (const auto& neighbour : neighbours)
+                                {
+                                    // Cells outside of the grid or in unallocated bricks hold no radiance
+                                    const std::array<int64_t, 3> cell {int64_t(x) + neighbour.offset[0],
+                                                                       int64_t(y) + neighbour.offset[1],
+                                                                       int64_t(z) + neighbour.offset[2]};
+                                    bool isInside = true;
+                                    for (uint32_t axis = 0; axis < 3; ++axis)
+                                        isInside &= cell[axis] >= 0 && cell[axis] < size[axis];
+                                    if (!isInside)
+                                        continue;
+
+                                    const auto* source = in.getBrick(uint32_t(cell[0]) / kBrickSize,
+                                                                     uint32_t(cell[1]) / kBrickSize,
+                                                                     uint32_t(cell[2]) / kBrickSize);
+                                    if (!source)
+                                        continue;
+
+                                    const auto cellIndex = SparseSHVolume::getCellIndex(
+                                        uint32_t(cell[0]), uint32_t(cell[1]), uint32_t(cell[2]));
+                                    for (uint32_t color = 0; color < kNumColorChannels; ++color)
+                                    {
+                                        for (uint32_t j = 0; j < kNumSHCoeffs; ++j)
+                                        {
+                                            const auto value =
+                                                source[SparseSHVolume::getChannelOffset(color, j) + cellIndex];
+                                            for (uint32_t k = 0; k < kNumSHCoeffs; ++k)
+                                                contributions[color][k] += neighbour.weights[k][j] * value;
+                                        }
+                                    }
+                                }
+
+                                const auto cellIndex = SparseSHVolume::getCellIndex(x, y, z);
+                                for (uint32_t color = 0; color < kNumColorChannels; ++color)
+                                {
+                                    for (uint32_t k = 0; k < kNumSHCoeffs; ++k)
+                                        brick[SparseSHVolume::getChannelOffset(color, k) + cellIndex] =
+                                            contributions[color][k];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "lpv_cpu/sparse_sh_volume.hpp"
+
+#include <algorithm>
+
+namespace lpv_cpu
+{
+    SparseSHVolume::SparseSHVolume(const std::array<uint32_t, 3>& size) :
+        m_Size {size}, m_BrickCount {(size[0] + kBrickSize - 1) / kBrickSize,
+                                     (size[1] + kBrickSize - 1) / kBrickSize,
+                                     (size[2] + kBrickSize - 1) / kBrickSize},
+        m_Slots(static_cast<size_t>(m_BrickCount[0]) * m_BrickCount[1] * m_BrickCount[2], -1)
+    {}
+
+    float* SparseSHVolume::allocate(uint32_t bx, uint32_t by, uint32_t bz)
+    {
+        auto& slot = m_Slots[getBrickIndex(bx, by, bz)];
+        if (slot < 0)
+        {
+            slot = static_cast<int32_t>(getNumAllocated());
+            m_Pool.resize(m_Pool.size() + kBrickFloats, 0.0f);
+        }
+        return m_Pool.data() + slot * kBrickFloats;
+    }
+
+    void SparseSHVolume::allocate(const BrickMask& mask)
+    {
+        for (uint32_t bz = 0; bz < m_BrickCount[2]; ++bz)
+        {
+            for (uint32_t by = 0; by < m_BrickCount[1]; ++by)
+            {
+                for (uint32_t bx = 0; bx < m_BrickCount[0]; ++bx)
+                {
+                    if (mask.isActive(bx, by, bz))
+                        allocate(bx, by, bz);
+                }
+            }
+        }
+    }
+
+    float* SparseSHVolume::getBrick(uint32_t bx, uint32_t by, uint32_t bz)
+    {
+        const auto slot = m_Slots[getBrickIndex(bx, by, bz)];
+        return slot < 0 ? nullptr : m_Pool.data() + slot * kBrickFloats;
+    }
+
+    const float* SparseSHVolume::getBrick(uint32_t bx, uint32_t by, uint32_t bz) const
+    {
+        const auto slot = m_Slots[getBrickIndex(bx, by, bz)];
+        return slot < 0 ? nullptr : m_Pool.data() + slot * kBrickFloats;
+    }
+
+    void SparseSHVolume::clear()
+    {
+        std::fill(m_Slots.begin(), m_Slots.end(), -1);
+        m_Pool.clear();
+    }
+
+    void SparseSHVolume::toDense(SHVolume& volume) const
+    {
+        volume = SHVolume(m_Size);
+        for (uint32_t z = 0; z < m_Size[2]; ++z)
+        {
+            for (uint32_t y = 0; y < m_Size[1]; ++y)
+            {
+                for (uint32_t x = 0; x < m_Size[0]; ++x)
+                {
+                    const auto* brick = getBrick(x / kBrickSize, y / kBrickSize, z / kBrickSize);
+                    if (!brick)
+                        continue;
+
+                    for (uint32_t color = 0; color < kNumColorChannels; ++color)
+                    {
+                        for (uint32_t coeff = 0; coeff < kNumSHCoeffs; ++coeff)
+                        {
+                            volume.getChannel(color, coeff)[volume.getIndex(x, y, z)] =
+                                brick[getChannelOffset(color, coeff) + getCellIndex(x, y, z)];
+                        }
+                    }
+                }
+            }
+        }
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "lpv_cpu/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace lpv_cpu
+{
+    ThreadPool::ThreadPool(uint32_t numThreads)
+    {
+        numThreads = std::max(numThreads, 1u);
+        for (uint32_t i = 0; i < numThreads; ++i)
+            m_Queues.push_back(std::make_unique<WorkQueue>());
+
+        for (uint32_t i = 1; i < numThreads; ++i)
+            m_Workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_WakeUp.notify_all();
+
+        for (auto& worker : m_Workers)
+            worker.join();
+    }
+
+    void ThreadPool::parallelFor(uint32_t numTasks, const std::function<void(uint32_t)>& task)
+    {
+        if (numTasks == 0)
+            return;
+
+        if (m_Workers.empty())
+        {
+            for (uint32_t i = 0; i < numTasks; ++i)
+                task(i);
+            return;
+        }
+
+        m_Task = &task;
+        m_NumRemaining.store(numTasks);
+
+        const auto numQueues = getNumThreads();
+        for (uint32_t q = 0; q < numQueues; ++q)
+        {
+            std::lock_guard lock(m_Queues[q]->mutex);
+            for (uint32_t i = q * numTasks / numQueues; i < (q + 1) * numTasks / numQueues; ++i)
+                m_Queues[q]->tasks.push_back(i);
+        }
+
+        {
+            std::lock_guard lock(m_Mutex);
+            ++m_Generation;
+        }
+        m_WakeUp.notify_all();
+
+        while (runTask(0))
+            ;
+
+        std::unique_lock lock(m_Mutex);
+        m_Done.wait(lock, [this] { return m_NumRemaining.load() == 0; });
+        m_Task = nullptr;
+    }
+
+    void ThreadPool::workerLoop(uint32_t queueIndex)
+    {
+        uint64_t generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(m_Mutex);
+                m_WakeUp.wait(lock, [&] { return m_Stop || m_Generation != generation; });
+                if (m_Stop)
+                    return;
+                generation = m_Generation;
+            }
+
+            while (runTask(queueIndex))
+                ;
+        }
+    }
+
+    bool ThreadPool::runTask(uint32_t queueIndex)
+    {
+        uint32_t taskIndex;
+        bool     hasTask = false;
+
+        const auto numQueues = getNumThreads();
+        for (uint32_t i = 0; i < numQueues && !hasTask; ++i)
+        {
+            auto&           queue = *m_Queues[(queueIndex + i) % numQueues];
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+
+            // Own tasks from the back, stolen ones from the front
+            if (i == 0)
+            {
+                taskIndex = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                taskIndex = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            hasTask = true;
+        }
+
+        if (!hasTask)
+            return false;
+
+        (*m_Task)(taskIndex);
+
+        if (m_NumRemaining.fetch_sub(1) == 1)
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Done.notify_one();
+        }
+        return true;
+    }
+} // namespace lpv_cpu
\ No newline at end of file
@@ -0,0 +1,390 @@
+#include "lpv_cpu/half.hpp"
+#include "lpv_cpu/injection.hpp"
+#include "lpv_cpu/propagation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    // The expected values are written from the LPV papers' constants rather than from lpv_cpu/sh.hpp, so that a wrong
+    // constant there fails the tests instead of cancelling out
+    constexpr float kPI           = 3.14159265f;
+    constexpr float kSH_C0        = 0.282094792f; // 1 / (2 sqrt(pi))
+    constexpr float kSH_C1        = 0.488602512f; // sqrt(3) / (2 sqrt(pi))
+    constexpr float kSH_cosLobeC0 = 0.886226925f; // sqrt(pi) / 2
+    constexpr float kSH_cosLobeC1 = 1.02332671f;  // sqrt(pi / 3)
+
+    using Vec3     = std::array<float, 3>;
+    using SHCoeffs = std::array<float, 4>;
+
+    uint32_t g_NumFailures = 0;
+
+    void check(bool condition, const char* test, const char* what)
+    {
+        if (condition)
+            return;
+
+        std::printf("FAILED %s: %s\n", test, what);
+        ++g_NumFailures;
+    }
+
+    bool isClose(float a, float b, float tolerance)
+    {
+        return std::abs(a - b) <= tolerance * std::max(1.0f, std::abs(b));
+    }
+
+    // (C0, -C1 * y, C1 * z, -C1 * x) of a unit direction
+    SHCoeffs evaluate(float c0, float c1, const Vec3& direction)
+    {
+        return {c0, -c1 * direction[1], c1 * direction[2], -c1 * direction[0]};
+    }
+
+    // Whether every coefficient of the cells of `volume` but `expected`'s is 0
+    template<typename IsExpected>
+    bool isZeroElsewhere(const lpv_cpu::SHVolume& volume, IsExpected&& isExpected)
+    {
+        const auto& size = volume.getSize();
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                const auto* channel = volume.getChannel(color, coeff);
+                for (uint32_t z = 0; z < size[2]; ++z)
+                {
+                    for (uint32_t y = 0; y < size[1]; ++y)
+                    {
+                        for (uint32_t x = 0; x < size[0]; ++x)
+                        {
+                            if (!isExpected(x, y, z) && channel[volume.getIndex(x, y, z)] != 0.0f)
+                                return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // A VPL facing Z+ injects flux / pi * SH_EvaluateCosineLobe(0, 0, 1) into the cell half a cell along its normal.
+    // Texels without a normal and texels outside of the grid are skipped.
+    void testInjection()
+    {
+        constexpr auto* kTest = "injection";
+
+        const lpv_cpu::Grid grid {.aabbMin = {-2.0f, 0.0f, 1.0f}, .size = {4, 4, 4}, .cellSize = 0.5f};
+
+        // 2x2 RSM: the VPL, a texel without a surface, a VPL outside of the grid and a second VPL of the same cell
+        const std::array<float, 12> positions {
+            -1.4f, 1.35f, 1.2f, 0.0f, 0.0f, 0.0f, 5.0f, 1.0f, 1.5f, -1.3f, 1.1f, 1.1f};
+        const std::array<float, 12> normals {0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f};
+        const std::array<float, 12> flux {1.0f, 0.5f, 0.25f, 8.0f, 8.0f, 8.0f, 8.0f, 8.0f, 8.0f, 2.0f, 1.0f, 0.5f};
+
+        const lpv_cpu::RSMView rsm {
+            .position = positions.data(), .normal = normals.data(), .flux = flux.data(), .resolution = 2};
+
+        lpv_cpu::SHVolume volume(grid.size);
+        lpv_cpu::inject(grid, rsm, volume);
+
+        // x = int(0.6 / 0.5) = 1, y = int(1.35 / 0.5) = 2, z = int(0.2 / 0.5 + 0.5) = 0, same cell for the last VPL
+        const std::array<uint32_t, 3> kCell {1, 2, 0};
+        const auto                    lobe  = evaluate(kSH_cosLobeC0, kSH_cosLobeC1, {0.0f, 0.0f, 1.0f});
+        const auto                    index = volume.getIndex(kCell[0], kCell[1], kCell[2]);
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                const auto expected = lobe[coeff] / kPI * (flux[color] + flux[9 + color]);
+                check(isClose(volume.getChannel(color, coeff)[index], expected, 1e-6f), kTest, "SH of the VPL's cell");
+            }
+        }
+
+        check(isZeroElsewhere(volume,
+                              [&](uint32_t x, uint32_t y, uint32_t z) {
+                                  return x == kCell[0] && y == kCell[1] && z == kCell[2];
+                              }),
+              kTest,
+              "cells without a VPL");
+    }
+
+    // One iteration out of a single cell: its 6 neighbours receive the radiance through their main face and the 4
+    // side faces, sum(solid angle * <SH_Evaluate(evaluation), source> * SH_EvaluateCosineLobe(reprojection)), with
+    // the evaluation direction of a side 0.4472135 along the side and 0.894427 along the main direction
+    void testPropagation(lpv_cpu::Isa isa)
+    {
+        char test[64];
+        std::snprintf(test, sizeof(test), "propagation (%s)", lpv_cpu::toString(isa));
+
+        constexpr float kMainSolidAngle = 0.4006696846f / kPI;
+        constexpr float kSideSolidAngle = 0.4234413544f / kPI;
+
+        constexpr std::array<uint32_t, 3> kSource {2, 1, 2};
+        constexpr std::array<SHCoeffs, 3> kSourceCoeffs {{
+            {1.0f, 0.3f, -0.2f, 0.5f},
+            {0.5f, -0.4f, 0.6f, 0.1f},
+            {2.0f, 0.7f, 0.25f, -0.8f},
+        }};
+
+        lpv_cpu::SHVolume in({5, 3, 4});
+        lpv_cpu::SHVolume out(in.getSize());
+        in.clear();
+        const auto sourceIndex = in.getIndex(kSource[0], kSource[1], kSource[2]);
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+                in.getChannel(color, coeff)[sourceIndex] = kSourceCoeffs[color][coeff];
+        }
+
+        lpv_cpu::propagate(in, out, isa);
+
+        const auto dot = [](const SHCoeffs& a, const SHCoeffs& b) {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+        };
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            for (float sign : {1.0f, -1.0f})
+            {
+                Vec3 main {};
+                Vec3 u {};
+                Vec3 v {};
+                main[axis]        = sign;
+                u[(axis + 1) % 3] = 1.0f;
+                v[(axis + 2) % 3] = 1.0f;
+
+                std::array<SHCoeffs, 3> expected {};
+                for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+                {
+                    const auto& source = kSourceCoeffs[color];
+                    const auto  add    = [&](float solidAngle, const Vec3& evaluation, const Vec3& reprojection) {
+                        const auto flux = solidAngle * dot(evaluate(kSH_C0, kSH_C1, evaluation), source);
+                        const auto lobe = evaluate(kSH_cosLobeC0, kSH_cosLobeC1, reprojection);
+                        for (uint32_t k = 0; k < 4; ++k)
+                            expected[color][k] += flux * lobe[k];
+                    };
+
+                    add(kMainSolidAngle, main, main);
+                    for (const auto& side : {u, v})
+                    {
+                        for (float sideSign : {1.0f, -1.0f})
+                        {
+                            Vec3 evaluation;
+                            Vec3 reprojection;
+                            for (uint32_t i = 0; i < 3; ++i)
+                            {
+                                reprojection[i] = sideSign * side[i];
+                                evaluation[i]   = 0.4472135f * reprojection[i] + 0.894427f * main[i];
+                            }
+                            add(kSideSolidAngle, evaluation, reprojection);
+                        }
+                    }
+                }
+
+                std::array<uint32_t, 3> cell = kSource;
+                cell[axis] += static_cast<int32_t>(sign);
+
+                const auto index = out.getIndex(cell[0], cell[1], cell[2]);
+                for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+                {
+                    for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+                    {
+                        check(isClose(out.getChannel(color, coeff)[index], expected[color][coeff], 1e-5f),
+                              test,
+                              "SH of a neighbour of the source");
+                    }
+                }
+            }
+        }
+
+        // Radiance only flows to the face neighbours, the source itself is emptied
+        check(isZeroElsewhere(out,
+                              [&](uint32_t x, uint32_t y, uint32_t z) {
+                                  const auto distance = std::abs(static_cast<int32_t>(x) - int32_t {kSource[0]}) +
+                                                        std::abs(static_cast<int32_t>(y) - int32_t {kSource[1]}) +
+                                                        std::abs(static_cast<int32_t>(z) - int32_t {kSource[2]});
+                                  return distance == 1;
+                              }),
+              test,
+              "cells that are not face neighbours of the source");
+    }
+
+    // fp16 conversions round to nearest even, so a value of the normal range is off by at most half an ulp (2^-11)
+    void testHalf()
+    {
+        constexpr auto* kTest = "fp16";
+
+        check(lpv_cpu::floatToHalf(1.0f) == 0x3C00, kTest, "1.0");
+        check(lpv_cpu::floatToHalf(-2.0f) == 0xC000, kTest, "-2.0");
+        check(lpv_cpu::floatToHalf(65504.0f) == 0x7BFF, kTest, "largest half");
+        check(lpv_cpu::roundToHalf(1.0f + std::ldexp(1.0f, -11)) == 1.0f, kTest, "tie rounded to even (down)");
+        check(lpv_cpu::roundToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 1.0f + std::ldexp(1.0f, -9),
+              kTest,
+              "tie rounded to even (up)");
+
+        lpv_cpu::SHVolume volume({7, 5, 3});
+        volume.clear();
+
+        std::mt19937                          rng(1234);
+        std::uniform_real_distribution<float> exponent(-14.0f, 15.0f);
+        std::bernoulli_distribution           isNegative(0.5);
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                auto* channel = volume.getChannel(color, coeff);
+                for (uint32_t z = 0; z < 3; ++z)
+                {
+                    for (uint32_t y = 0; y < 5; ++y)
+                    {
+                        for (uint32_t x = 0; x < 7; ++x)
+                        {
+                            const auto value = std::exp2(exponent(rng));
+                            channel[volume.getIndex(x, y, z)] = isNegative(rng) ? -value : value;
+                        }
+                    }
+                }
+            }
+        }
+
+        constexpr float       kTolerance = 1.0f / 2048.0f;
+        lpv_cpu::SHVolume     rounded    = volume;
+        lpv_cpu::SHVolume     imported(volume.getSize());
+        std::vector<uint16_t> texels(volume.getNumCells() * lpv_cpu::kNumSHCoeffs);
+        rounded.roundToHalf();
+        imported.clear();
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            volume.exportHalf(color, texels.data());
+            imported.importHalf(color, texels.data());
+        }
+
+        bool isWithinTolerance = true;
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                const auto* channel        = volume.getChannel(color, coeff);
+                const auto* roundedChannel = rounded.getChannel(color, coeff);
+                for (uint32_t z = 0; z < 3; ++z)
+                {
+                    for (uint32_t y = 0; y < 5; ++y)
+                    {
+                        for (uint32_t x = 0; x < 7; ++x)
+                        {
+                            const auto index = volume.getIndex(x, y, z);
+                            isWithinTolerance &= std::abs(roundedChannel[index] - channel[index]) <=
+                                                 kTolerance * std::abs(channel[index]);
+                        }
+                    }
+                }
+            }
+        }
+        check(isWithinTolerance, kTest, "relative error of the rounding");
+        check(imported.getMaxAbsDifference(rounded) == 0.0f, kTest, "exportHalf/importHalf round-trip");
+
+        lpv_cpu::SHVolume roundedTwice = rounded;
+        roundedTwice.roundToHalf();
+        check(roundedTwice.getMaxAbsDifference(rounded) == 0.0f, kTest, "rounding of fp16 values");
+    }
+
+    lpv_cpu::SHVolume makeRandomVolume(const std::array<uint32_t, 3>& size)
+    {
+        lpv_cpu::SHVolume volume(size);
+        volume.clear();
+
+        std::mt19937                          rng(1234);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        for (uint32_t color = 0; color < lpv_cpu::kNumColorChannels; ++color)
+        {
+            for (uint32_t coeff = 0; coeff < lpv_cpu::kNumSHCoeffs; ++coeff)
+            {
+                auto* channel = volume.getChannel(color, coeff);
+                for (uint32_t z = 0; z < size[2]; ++z)
+                {
+                    for (uint32_t y = 0; y < size[1]; ++y)
+                    {
+                        for (uint32_t x = 0; x < size[0]; ++x)
+                            channel[volume.getIndex(x, y, z)] = distribution(rng);
+                    }
+                }
+            }
+        }
+
+        // Stored as RGBA16F by the injection
+        volume.roundToHalf();
+        return volume;
+    }
+
+    // K iterations fused into one pass have to give the volume of K single iterations. The volume is no multiple of
+    // the tile size along any axis, so that the halos of the tiles get clamped at every edge of the volume, and the
+    // fused pass is also split into two z-slabs like the Engine's tasks. The scalar kernels propagate every cell in
+    // the same order whatever the tile, so their volumes have to be identical, the SIMD ones may differ by a rounding.
+    void testFusedPropagation(lpv_cpu::Isa isa, bool emulateHalf)
+    {
+        char test[64];
+        std::snprintf(test,
+                      sizeof(test),
+                      "fused propagation (%s%s)",
+                      lpv_cpu::toString(isa),
+                      emulateHalf ? ", fp16" : "");
+
+        const std::array<uint32_t, 3> kSize {37, 20, 19};
+        const uint32_t                kSlabEnd = 7;
+
+        const auto        injected = makeRandomVolume(kSize);
+        lpv_cpu::SHVolume fused(kSize);
+        lpv_cpu::SHVolume slabs(kSize);
+        fused.clear();
+        slabs.clear();
+
+        // Values reach about 1, the SIMD kernels may flip a fp16 rounding (2^-11)
+        const auto tolerance = isa == lpv_cpu::Isa::eScalar ? 0.0f : (emulateHalf ? 1e-3f : 1e-5f);
+
+        std::array<lpv_cpu::SHVolume, 2> single {injected, lpv_cpu::SHVolume(kSize)};
+        single[1].clear();
+        for (uint32_t numFused = 1; numFused <= lpv_cpu::kMaxFusedIterations; ++numFused)
+        {
+            // single[numFused % 2] holds numFused single iterations of the injected volume
+            lpv_cpu::propagate(single[(numFused - 1) % 2], single[numFused % 2], lpv_cpu::Isa::eScalar);
+            if (emulateHalf)
+                single[numFused % 2].roundToHalf();
+
+            lpv_cpu::propagateFused(injected, fused, numFused, 0, kSize[2], emulateHalf, isa);
+            lpv_cpu::propagateFused(injected, slabs, numFused, 0, kSlabEnd, emulateHalf, isa);
+            lpv_cpu::propagateFused(injected, slabs, numFused, kSlabEnd, kSize[2], emulateHalf, isa);
+
+            char what[64];
+            std::snprintf(what, sizeof(what), "K=%u against %u single iterations", numFused, numFused);
+            check(fused.getMaxAbsDifference(single[numFused % 2]) <= tolerance, test, what);
+            std::snprintf(what, sizeof(what), "K=%u split into z-slabs", numFused);
+            check(slabs.getMaxAbsDifference(fused) == 0.0f, test, what);
+        }
+    }
+} // namespace
+
+// Checks the CPU passes against hand-computed values, exits with 1 when any of them differs
+int main()
+{
+    testInjection();
+    testPropagation(lpv_cpu::Isa::eScalar);
+    if (const auto isa = lpv_cpu::detectIsa(); isa != lpv_cpu::Isa::eScalar)
+        testPropagation(isa);
+    testHalf();
+    for (bool emulateHalf : {true, false})
+    {
+        testFusedPropagation(lpv_cpu::Isa::eScalar, emulateHalf);
+        if (const auto isa = lpv_cpu::detectIsa(); isa != lpv_cpu::Isa::eScalar)
+            testFusedPropagation(isa, emulateHalf);
+    }
+
+    if (g_NumFailures > 0)
+    {
+        std::printf("%u checks failed\n", g_NumFailures);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "lpv_cpu/sh.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+// Writes lib/sh_tables.glsl for the preprocess_shaders rule, only touching it when its content changes
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "usage: %s <output .glsl>\n", argv[0]);
+        return 1;
+    }
+
+    const std::filesystem::path path(argv[1]);
+    const auto                  glsl = lpv_cpu::generatePropagationTablesGLSL();
+
+    std::ifstream existing(path, std::ios::binary);
+    const std::string current((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+    if (current == glsl)
+        return 0;
+
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream output(path, std::ios::binary);
+    output << glsl;
+    return output ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+-- target defination, name: lpv-cpu
+target("lpv-cpu")
+    -- set target kind: static library
+    set_kind("static")
+
+    add_includedirs("include", { public = true })
+    add_headerfiles("include/(lpv_cpu/*.hpp)")
+
+    -- add source files
+    add_files("src/*.cpp|propagation_avx2.cpp|culling_avx2.cpp")
+
+    -- the AVX2 kernels are the only files built with AVX2 enabled, the dispatch picks them at runtime. The culling
+    -- kernel is built without FMA to cull the same boxes as the scalar one.
+    if is_arch("x86_64", "x64", "i386", "x86") then
+        if is_plat("windows") then
+            add_files("src/propagation_avx2.cpp", "src/culling_avx2.cpp", {cxflags = "/arch:AVX2"})
+        else
+            add_files("src/propagation_avx2.cpp", {cxflags = {"-mavx2", "-mfma"}})
+            add_files("src/culling_avx2.cpp", {cxflags = "-mavx2"})
+        end
+    else
+        add_files("src/propagation_avx2.cpp", "src/culling_avx2.cpp")
+    end
+
+    -- add packages
+    if is_plat("linux") then
+        add_syslinks("pthread", { public = true })
+    end
+
+    -- set target directory
+    set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu")
+
+-- target defination, name: lpv-sh-tables (writes the GLSL propagation tables, see preprocess_shaders)
+target("lpv-sh-tables")
+    -- set target kind: executable
+    set_kind("binary")
+
+    -- add source files
+    add_files("tools/generate_sh_tables.cpp")
+
+    -- add deps
+    add_deps("lpv-cpu")
+
+    -- set target directory
+    set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-sh-tables")
+
+-- target defination, name: lpv-cpu-tests (checks the CPU passes against hand-computed values, see xmake test)
+target("lpv-cpu-tests")
+    -- set target kind: executable
+    set_kind("binary")
+
+    -- add source files
+    add_files("tests/lpv_cpu_tests.cpp")
+
+    -- add deps
+    add_deps("lpv-cpu")
+
+    -- run by xmake test
+    add_tests("default")
+
+    -- set target directory
+    set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu-tests")
+
+-- if build benchmarks, then add the propagation, thread scaling, sparse LPV, SH encoding, fused propagation and
+-- frustum culling benchmarks
+if has_config("bench") then
+    target("lpv-cpu-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        -- add source files
+        add_files("bench/propagation_bench.cpp")
+
+        -- add deps
+        add_deps("lpv-cpu")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu-bench")
+
+    target("lpv-cpu-scaling-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        -- add source files
+        add_files("bench/scaling_bench.cpp")
+
+        -- add deps
+        add_deps("lpv-cpu")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu-scaling-bench")
+
+    target("lpv-cpu-sparse-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        -- add source files
+        add_files("bench/sparse_bench.cpp")
+
+        -- add deps
+        add_deps("lpv-cpu")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu-sparse-bench")
+
+    target("lpv-cpu-encoding-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        -- add source files
+        add_files("bench/encoding_bench.cpp")
+
+        -- add deps
+        add_deps("lpv-cpu")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu-encoding-bench")
+
+    target("lpv-cpu-fused-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        -- add source files
+        add_files("bench/fused_bench.cpp")
+
+        -- add deps
+        add_deps("lpv-cpu")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu-fused-bench")
+
+    target("lpv-cpu-culling-bench")
+        -- set target kind: executable
+        set_kind("binary")
+
+        -- add source files
+        add_files("bench/culling_bench.cpp")
+
+        -- add deps
+        add_deps("lpv-cpu")
+
+        -- set target directory
+        set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/lpv-cpu-culling-bench")
+end
\ No newline at end of file
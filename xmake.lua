@@ -12,6 +12,10 @@ option("app") -- build application?
     set_default(true)
 option_end()
 
+option("bench") -- build benchmarks?
+    set_default(false)
+option_end()
+
 -- if build on windows
 if is_plat("windows") then
     add_cxxflags("/EHsc")
@@ -61,7 +65,16 @@ rule("imguiconfig")
 rule_end()
 
 rule("preprocess_shaders")
-    set_extensions(".vert", ".frag", ".geom", ".glsl")
+    set_extensions(".vert", ".frag", ".geom", ".comp", ".glsl")
+
+    -- lib/sh_tables.glsl is generated from the constexpr tables of lpv_cpu (the target depends on lpv-sh-tables)
+    before_build(function (target)
+        import("core.project.config")
+        import("core.project.project")
+
+        local generated_root = path.join(config.buildir(), "generated", "shaders")
+        os.execv(project.target("lpv-sh-tables"):targetfile(), {path.join(generated_root, "lib", "sh_tables.glsl")})
+    end)
 
     on_build_file(function (target, sourcefile, opt) end)
 
@@ -71,11 +84,37 @@ rule("preprocess_shaders")
             return
         end
 
+        import("core.project.config")
+
         local shader_root = target:values("shader_root")
+        local generated_root = path.join(config.buildir(), "generated", "shaders")
         local target_shaders_dir = path.join(target:targetdir(), "shaders")
         local output_path = path.join(target_shaders_dir, path.filename(sourcefile))
         os.mkdir(target_shaders_dir)
-        os.execv("glslc", {"-I", shader_root, "-E", sourcefile, is_mode("debug") and "-O0" or "-Os", "-o", output_path})
+
+        -- only #include is expanded, the other directives are kept so that the application can still #define the
+        -- variant it compiles (see app/shader_source.hpp)
+        local function expand_includes(file)
+            local lines = {}
+            for line in io.lines(file) do
+                local include = line:match("^%s*#include%s+\"([^\"]+)\"")
+                if include then
+                    -- relative to the including file first, then to the shader and the generated roots
+                    local include_path = path.join(path.directory(file), include)
+                    for _, root in ipairs({shader_root, generated_root}) do
+                        if os.isfile(include_path) then
+                            break
+                        end
+                        include_path = path.join(root, include)
+                    end
+                    table.insert(lines, expand_includes(include_path))
+                else
+                    table.insert(lines, line)
+                end
+            end
+            return table.concat(lines, "\n")
+        end
+        io.writefile(output_path, expand_includes(sourcefile) .. "\n")
         print("Preprocessing shader: " .. sourcefile .. " -> " .. output_path)
     end)
 rule_end()
@@ -87,6 +126,9 @@ add_rules("plugin.compile_commands.autoupdate", {outputdir = ".vscode"})
 -- add my own xmake-repo here
 add_repositories("my-xmake-repo https://github.com/zzxzzk115/xmake-repo.git backup")
 
+-- CPU reference of the LPV passes
+includes("lpv_cpu")
+
 -- if build application, then include application
 if has_config("app") then
     includes("app")